@@ -11,6 +11,7 @@
 
 #include <libflatarray/detail/generic_destruct.hpp>
 #include <libflatarray/detail/soa_array_member_copy_helper.hpp>
+#include <libflatarray/detail/soa_member_copy_helper.hpp>
 #include <libflatarray/preprocessor.hpp>
 
 #ifdef __CUDACC__
@@ -182,13 +183,15 @@
 
 #define LIBFLATARRAY_COPY_SOA_MEMBER_ARRAY_IN(MEMBER_INDEX, CELL, MEMBER) \
     {                                                                   \
-        for (std::size_t i = 0; i < count; ++i) {                       \
-            (&this->LIBFLATARRAY_ELEM(1, MEMBER)())[i] =                \
-            ((const LIBFLATARRAY_ELEM(0, MEMBER)*)(                     \
-                source +                                                \
-                detail::flat_array::offset<CELL, MEMBER_INDEX>::OFFSET * \
-                stride))[offset + i];                                   \
-        }                                                               \
+        LibFlatArray::detail::                                          \
+            soa_member_copy_helper<LIBFLATARRAY_ELEM(0, MEMBER)>::copy( \
+                &this->LIBFLATARRAY_ELEM(1, MEMBER)(),                  \
+                ((const LIBFLATARRAY_ELEM(0, MEMBER)*)(                 \
+                    source +                                            \
+                    detail::flat_array::offset<CELL, MEMBER_INDEX>::OFFSET * \
+                    stride)) + offset,                                  \
+                count,                                                  \
+                stride);                                                \
     }
 
 #define LIBFLATARRAY_COPY_SOA_ARRAY_MEMBER_ARRAY_IN(MEMBER_INDEX, CELL, MEMBER) \
@@ -216,13 +219,15 @@
 
 #define LIBFLATARRAY_COPY_SOA_MEMBER_ARRAY_OUT(MEMBER_INDEX, CELL, MEMBER) \
     {                                                                   \
-        for (std::size_t i = 0; i < count; ++i) {                       \
-            ((LIBFLATARRAY_ELEM(0, MEMBER)*)(                           \
-                target +                                                \
-                detail::flat_array::offset<CELL, MEMBER_INDEX>::OFFSET * \
-                stride))[offset + i] =                                  \
-            (&this->LIBFLATARRAY_ELEM(1, MEMBER)())[i];                 \
-        }                                                               \
+        LibFlatArray::detail::                                          \
+            soa_member_copy_helper<LIBFLATARRAY_ELEM(0, MEMBER)>::copy( \
+                ((LIBFLATARRAY_ELEM(0, MEMBER)*)(                       \
+                    target +                                            \
+                    detail::flat_array::offset<CELL, MEMBER_INDEX>::OFFSET * \
+                    stride)) + offset,                                  \
+                &this->LIBFLATARRAY_ELEM(1, MEMBER)(),                  \
+                count,                                                  \
+                stride);                                                \
     }
 
 #define LIBFLATARRAY_COPY_SOA_ARRAY_MEMBER_ARRAY_OUT(MEMBER_INDEX, CELL, MEMBER) \
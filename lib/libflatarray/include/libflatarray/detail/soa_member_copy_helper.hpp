@@ -0,0 +1,142 @@
+/**
+ * Copyright 2018 Google
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef FLAT_ARRAY_DETAIL_SOA_MEMBER_COPY_HELPER_HPP
+#define FLAT_ARRAY_DETAIL_SOA_MEMBER_COPY_HELPER_HPP
+
+#include <libflatarray/detail/generic_destruct.hpp>
+#include <libflatarray/short_vec.hpp>
+
+// disable certain warnings from system headers when compiling with
+// Microsoft Visual Studio:
+#ifdef _MSC_BUILD
+#pragma warning( push )
+#pragma warning( disable : 4514 4710 )
+#endif
+
+#include <cstddef>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef _MSC_BUILD
+#pragma warning( pop )
+#endif
+
+namespace LibFlatArray {
+
+namespace detail {
+
+#ifdef _MSC_BUILD
+#pragma warning( push )
+#pragma warning( disable : 4710 )
+#endif
+
+/**
+ * Copies a streak of a scalar member from or to a buffer, as done by
+ * soa_accessor's load() and save(). The generic version copies
+ * element by element.
+ */
+template<typename MEMBER>
+class soa_member_copy_helper
+{
+public:
+    __host__
+    __device__
+    inline
+    static void copy(
+        MEMBER *target,
+        const MEMBER *source,
+        const std::size_t count,
+        const std::size_t /* stride */)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            target[i] = source[i];
+        }
+    }
+};
+
+/**
+ * Vectorized copy for floating point members. stride is the number
+ * of elements per member in the buffer. If that buffer is so large
+ * that it won't stay in the cache anyway, we use non-temporal
+ * stores, which save the read for ownership of the target's cache
+ * lines.
+ */
+template<typename CARGO, std::size_t ARITY>
+class soa_member_short_vec_copy_helper
+{
+public:
+    typedef short_vec<CARGO, ARITY> short_vec_type;
+
+    static const std::size_t STREAMING_THRESHOLD = std::size_t(1) << 22;
+    static const std::size_t ALIGNMENT = 64;
+
+    __host__
+    __device__
+    inline
+    static void copy(
+        CARGO *target,
+        const CARGO *source,
+        const std::size_t count,
+        const std::size_t stride)
+    {
+#ifdef __CUDA_ARCH__
+        soa_member_copy_helper<CARGO>::copy(target, source, count, stride);
+#else
+        std::size_t i = 0;
+        short_vec_type buf;
+
+        if ((count >= (4 * ARITY)) &&
+            ((stride * sizeof(CARGO)) >= STREAMING_THRESHOLD) &&
+            ((reinterpret_cast<_SHORTVEC_UINTPTR_T>(target) % sizeof(CARGO)) == 0)) {
+            // store_nt() requires aligned addresses, hence we need to
+            // peel off the leading elements:
+            for (; (reinterpret_cast<_SHORTVEC_UINTPTR_T>(target + i) % ALIGNMENT) != 0; ++i) {
+                target[i] = source[i];
+            }
+
+            for (; (i + ARITY) <= count; i += ARITY) {
+                buf.load(source + i);
+                buf.store_nt(target + i);
+            }
+
+#ifdef __SSE__
+            _mm_sfence();
+#endif
+        } else {
+            for (; (i + ARITY) <= count; i += ARITY) {
+                buf.load(source + i);
+                buf.store(target + i);
+            }
+        }
+
+        for (; i < count; ++i) {
+            target[i] = source[i];
+        }
+#endif
+    }
+};
+
+template<>
+class soa_member_copy_helper<double> : public soa_member_short_vec_copy_helper<double, 8>
+{};
+
+template<>
+class soa_member_copy_helper<float> : public soa_member_short_vec_copy_helper<float, 16>
+{};
+
+#ifdef _MSC_BUILD
+#pragma warning( pop )
+#endif
+
+}
+
+}
+
+#endif
@@ -170,14 +170,14 @@ public:
     }
 
     template<typename FUNCTOR>
-    void callback(soa_grid<value_type> *other_grid, const FUNCTOR& functor)
+    void callback(soa_grid *other_grid, const FUNCTOR& functor)
     {
         typedef typename api_traits::select_asymmetric_dual_callback<value_type>::value value;
         dual_callback(other_grid, functor, value());
     }
 
     template<typename FUNCTOR>
-    void callback(soa_grid<value_type> *other_grid, const FUNCTOR& functor) const
+    void callback(soa_grid *other_grid, const FUNCTOR& functor) const
     {
         typedef typename api_traits::select_asymmetric_dual_callback<value_type>::value value;
         dual_callback(other_grid, functor, value());
@@ -409,22 +409,22 @@ private:
     char_staging_buffer_type raw_staging_buffer;
 
     template<typename FUNCTOR>
-    void dual_callback(soa_grid<value_type> *other_grid, const FUNCTOR& functor, api_traits::true_type)
+    void dual_callback(soa_grid *other_grid, const FUNCTOR& functor, api_traits::true_type)
     {
         detail::flat_array::dual_callback_helper()(this, other_grid, functor);
     }
 
     template<typename FUNCTOR>
-    void dual_callback(soa_grid<value_type> *other_grid, const FUNCTOR& functor, api_traits::true_type) const
+    void dual_callback(soa_grid *other_grid, const FUNCTOR& functor, api_traits::true_type) const
     {
         detail::flat_array::dual_callback_helper()(this, other_grid, functor);
     }
 
     template<typename FUNCTOR>
-    void dual_callback(soa_grid<value_type> *other_grid, FUNCTOR& functor, api_traits::false_type) const
+    void dual_callback(soa_grid *other_grid, FUNCTOR& functor, api_traits::false_type) const
     {
         assert_same_grid_sizes(other_grid);
-        detail::flat_array::dual_callback_helper_symmetric<soa_grid<value_type>, FUNCTOR> helper(
+        detail::flat_array::dual_callback_helper_symmetric<soa_grid, FUNCTOR> helper(
             other_grid, functor);
 
         api_traits::select_sizes<value_type>()(
@@ -436,10 +436,10 @@ private:
     }
 
     template<typename FUNCTOR>
-    void dual_callback(soa_grid<value_type> *other_grid, const FUNCTOR& functor, api_traits::false_type) const
+    void dual_callback(soa_grid *other_grid, const FUNCTOR& functor, api_traits::false_type) const
     {
         assert_same_grid_sizes(other_grid);
-        detail::flat_array::const_dual_callback_helper_symmetric<soa_grid<value_type>, FUNCTOR> helper(
+        detail::flat_array::const_dual_callback_helper_symmetric<soa_grid, FUNCTOR> helper(
             other_grid, functor);
 
         api_traits::select_sizes<value_type>()(
@@ -470,7 +470,7 @@ private:
         other.callback(this, detail::flat_array::copy_functor<value_type>(my_dim_x, my_dim_y, my_dim_z));
     }
 
-    void assert_same_grid_sizes(const soa_grid<value_type> *other_grid) const
+    void assert_same_grid_sizes(const soa_grid *other_grid) const
     {
         if ((my_dim_x != other_grid->my_dim_x) ||
             (my_dim_y != other_grid->my_dim_y) ||
@@ -486,8 +486,8 @@ private:
 #pragma warning( disable : 4711 )
 #endif
 
-template<typename value_type>
-void swap(soa_grid<value_type>& a, soa_grid<value_type>& b)
+template<typename value_type, typename ALLOCATOR, bool USE_CUDA_FUNCTORS>
+void swap(soa_grid<value_type, ALLOCATOR, USE_CUDA_FUNCTORS>& a, soa_grid<value_type, ALLOCATOR, USE_CUDA_FUNCTORS>& b)
 {
     a.swap(b);
 }
@@ -15,7 +15,7 @@ public:
     typedef std::pair<double, double> DPair;
 
     class API :
-        public APITraits::HasStencil<Stencils::VonNeumann<2, 1> >,
+        public APITraits::HasStencil<Stencils::Moore<2, 1> >,
         public APITraits::HasCubeTopology<2>
     {};
 
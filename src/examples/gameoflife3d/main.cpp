@@ -8,7 +8,7 @@ class ConwayCell
 {
 public:
     class API :
-        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasStencil<Stencils::Moore<3, 1> >,
         public APITraits::HasCubeTopology<3>
     {};
 
@@ -0,0 +1,447 @@
+#ifndef LIBGEODECOMP_COMMUNICATION_AGGREGATINGPATCHLINK_H
+#define LIBGEODECOMP_COMMUNICATION_AGGREGATINGPATCHLINK_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <deque>
+#include <map>
+#include <set>
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/geometry/regionhandle.h>
+#include <libgeodecomp/misc/limits.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/storage/patchaccepter.h>
+#include <libgeodecomp/storage/patchprovider.h>
+#include <libgeodecomp/storage/serializationbuffer.h>
+
+namespace LibGeoDecomp {
+
+/**
+ * Variant of the PatchLink for setups with many small links between
+ * the same pair of processes. Instead of sending one message per
+ * link, all Accepters which share an Aggregator coalesce their
+ * payloads for the same destination and nano step into a single
+ * message. The Providers on the receiving side pick their fragments
+ * from that message. Fragments are identified by the link's tag,
+ * which hence needs to be unique per pair of processes (just as for
+ * the PatchLink).
+ *
+ * A message is sent as soon as all links to its destination have
+ * delivered their patch. Links with differing strides will lead to
+ * partial messages, which are flushed once a link puts a patch for
+ * another nano step, or prior to any blocking receive (get(),
+ * progress(), cleanup()), so neighbors are never left waiting.
+ */
+template<class GRID_TYPE>
+class AggregatingPatchLink
+{
+public:
+    typedef typename GRID_TYPE::CellType CellType;
+    typedef typename SerializationBuffer<CellType>::BufferType BufferType;
+    typedef typename BufferType::value_type BufferElement;
+
+    const static int DIM = GRID_TYPE::DIM;
+
+    class Aggregator
+    {
+    public:
+        explicit Aggregator(
+            MPI_Comm communicator = MPI_COMM_WORLD,
+            int tag = MPILayer::PATCH_LINK) :
+            mpiLayer(communicator),
+            tag(tag),
+            messageCounter(0)
+        {}
+
+        ~Aggregator()
+        {
+            // send buffers need to outlive pending requests:
+            mpiLayer.wait(tag);
+        }
+
+        void addDestination(int dest, int linkTag)
+        {
+            addFragment(&outboxes[dest].fragments, linkTag);
+        }
+
+        void addSource(int source, int linkTag)
+        {
+            addFragment(&inboxes[source].fragments, linkTag);
+        }
+
+        void put(int dest, int linkTag, std::size_t nanoStep, const BufferType& buffer)
+        {
+            Outbox& outbox = outboxes[dest];
+            if (!outbox.entries.empty() && (outbox.nanoStep != nanoStep)) {
+                flush(dest, &outbox);
+            }
+
+            Entry entry;
+            entry.tag = linkTag;
+            entry.size = buffer.size() * sizeof(BufferElement);
+            outbox.nanoStep = nanoStep;
+            outbox.entries << entry;
+            if (entry.size > 0) {
+                const char *data = reinterpret_cast<const char*>(&buffer[0]);
+                outbox.payload.insert(outbox.payload.end(), data, data + entry.size);
+            }
+
+            if (outbox.entries.size() == outbox.fragments.size()) {
+                flush(dest, &outbox);
+            }
+        }
+
+        /**
+         * Blocks until the fragment is available.
+         */
+        void get(int source, int linkTag, std::size_t nanoStep, BufferType *buffer)
+        {
+            // our neighbors might be waiting for our partial
+            // messages before they can send theirs:
+            flushAll();
+
+            Inbox& inbox = inboxes[source];
+            FragmentKey key(linkTag, nanoStep);
+            typename PayloadMap::iterator i = inbox.payloads.find(key);
+            while (i == inbox.payloads.end()) {
+                receive(source, &inbox);
+                i = inbox.payloads.find(key);
+            }
+
+            buffer->resize(i->second.size() / sizeof(BufferElement));
+            if (!i->second.empty()) {
+                std::copy(i->second.begin(), i->second.end(), reinterpret_cast<char*>(&(*buffer)[0]));
+            }
+            inbox.payloads.erase(i);
+        }
+
+        /**
+         * Sends partial messages and stashes any incoming ones.
+         */
+        void progress()
+        {
+            flushAll();
+
+            for (typename std::map<int, Inbox>::iterator i = inboxes.begin(); i != inboxes.end(); ++i) {
+                int flag = 1;
+                while (flag) {
+                    MPI_Iprobe(i->first, tag, mpiLayer.communicator(), &flag, MPI_STATUS_IGNORE);
+                    if (flag) {
+                        receive(i->first, &i->second);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Number of messages sent so far.
+         */
+        std::size_t sentMessages() const
+        {
+            return messageCounter;
+        }
+
+    private:
+        typedef std::pair<int, std::size_t> FragmentKey;
+        typedef std::map<FragmentKey, std::vector<char> > PayloadMap;
+
+        class Entry
+        {
+        public:
+            int tag;
+            std::size_t size;
+        };
+
+        class Header
+        {
+        public:
+            std::size_t nanoStep;
+            std::size_t entries;
+        };
+
+        class Outbox
+        {
+        public:
+            std::set<int> fragments;
+            std::size_t nanoStep;
+            std::vector<Entry> entries;
+            std::vector<char> payload;
+        };
+
+        class Inbox
+        {
+        public:
+            std::set<int> fragments;
+            PayloadMap payloads;
+        };
+
+        MPILayer mpiLayer;
+        int tag;
+        std::size_t messageCounter;
+        std::map<int, Outbox> outboxes;
+        std::map<int, Inbox> inboxes;
+        std::deque<std::vector<char> > sendBuffers;
+
+        void addFragment(std::set<int> *fragments, int linkTag)
+        {
+            if (fragments->count(linkTag)) {
+                throw std::invalid_argument("AggregatingPatchLink tags need to be unique per pair of processes");
+            }
+            fragments->insert(linkTag);
+        }
+
+        void flushAll()
+        {
+            for (typename std::map<int, Outbox>::iterator i = outboxes.begin(); i != outboxes.end(); ++i) {
+                if (!i->second.entries.empty()) {
+                    flush(i->first, &i->second);
+                }
+            }
+        }
+
+        void flush(int dest, Outbox *outbox)
+        {
+            if (mpiLayer.test(tag)) {
+                sendBuffers.clear();
+            }
+
+            Header header;
+            header.nanoStep = outbox->nanoStep;
+            header.entries = outbox->entries.size();
+
+            const char *headerData = reinterpret_cast<const char*>(&header);
+            const char *entryData = reinterpret_cast<const char*>(&outbox->entries[0]);
+            sendBuffers.push_back(std::vector<char>());
+            std::vector<char>& message = sendBuffers.back();
+            message.reserve(sizeof(Header) + header.entries * sizeof(Entry) + outbox->payload.size());
+            message.insert(message.end(), headerData, headerData + sizeof(Header));
+            message.insert(message.end(), entryData, entryData + header.entries * sizeof(Entry));
+            message.insert(message.end(), outbox->payload.begin(), outbox->payload.end());
+
+            if (message.size() > std::size_t(Limits<int>::getMax())) {
+                throw std::invalid_argument("message size exceeds std::numeric_limits<int>::max()");
+            }
+
+            mpiLayer.send(&message[0], dest, int(message.size()), tag, MPI_CHAR);
+            ++messageCounter;
+
+            outbox->entries.clear();
+            outbox->payload.clear();
+        }
+
+        /**
+         * Blocking receive of the next message from the given
+         * source. Its fragments are stored until they're requested.
+         */
+        void receive(int source, Inbox *inbox)
+        {
+            MPI_Status status;
+            MPI_Probe(source, tag, mpiLayer.communicator(), &status);
+            int size;
+            MPI_Get_count(&status, MPI_CHAR, &size);
+
+            std::vector<char> message(size);
+            MPI_Recv(&message[0], size, MPI_CHAR, source, tag, mpiLayer.communicator(), MPI_STATUS_IGNORE);
+
+            Header header;
+            std::copy(&message[0], &message[0] + sizeof(Header), reinterpret_cast<char*>(&header));
+            const char *entryCursor = &message[0] + sizeof(Header);
+            const char *payloadCursor = entryCursor + header.entries * sizeof(Entry);
+
+            for (std::size_t i = 0; i < header.entries; ++i) {
+                Entry entry;
+                std::copy(entryCursor, entryCursor + sizeof(Entry), reinterpret_cast<char*>(&entry));
+                entryCursor += sizeof(Entry);
+
+                inbox->payloads[FragmentKey(entry.tag, header.nanoStep)].assign(
+                    payloadCursor, payloadCursor + entry.size);
+                payloadCursor += entry.size;
+            }
+        }
+    };
+
+    typedef typename SharedPtr<Aggregator>::Type AggregatorPtr;
+
+    class Link
+    {
+    public:
+        inline Link(
+            const Region<DIM>& region,
+            int peer,
+            int tag,
+            AggregatorPtr aggregator) :
+            lastNanoStep(0),
+            stride(1),
+            region(region),
+            buffer(SerializationBuffer<CellType>::create(region)),
+            peer(peer),
+            tag(tag),
+            aggregator(aggregator)
+        {}
+
+        virtual ~Link()
+        {}
+
+        virtual void cleanup()
+        {}
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            lastNanoStep = last;
+            stride = newStride;
+        }
+
+    protected:
+        std::size_t lastNanoStep;
+        long stride;
+        RegionHandle<DIM> region;
+        BufferType buffer;
+        int peer;
+        int tag;
+        AggregatorPtr aggregator;
+    };
+
+    class Accepter :
+        public Link,
+        public PatchAccepter<GRID_TYPE>
+    {
+    public:
+        using Link::aggregator;
+        using Link::buffer;
+        using Link::lastNanoStep;
+        using Link::peer;
+        using Link::region;
+        using Link::stride;
+        using Link::tag;
+        using PatchAccepter<GRID_TYPE>::checkNanoStepPut;
+        using PatchAccepter<GRID_TYPE>::infinity;
+        using PatchAccepter<GRID_TYPE>::pushRequest;
+        using PatchAccepter<GRID_TYPE>::requestedNanoSteps;
+
+        inline Accepter(
+            const Region<DIM>& region,
+            int dest,
+            int tag,
+            AggregatorPtr aggregator) :
+            Link(region, dest, tag, aggregator)
+        {
+            aggregator->addDestination(dest, tag);
+        }
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            Link::charge(next, last, newStride);
+            pushRequest(next);
+        }
+
+        virtual void put(
+            const GRID_TYPE& grid,
+            const Region<DIM>& /*validRegion*/,
+            const Coord<DIM>& /*globalGridDimensions*/,
+            const std::size_t nanoStep,
+            const std::size_t /*rank*/)
+        {
+            if (!checkNanoStepPut(nanoStep)) {
+                return;
+            }
+
+            SerializationBuffer<CellType>::resize(&buffer, region->size());
+            grid.saveRegion(&buffer, *region);
+            aggregator->put(peer, tag, nanoStep, buffer);
+
+            std::size_t nextNanoStep = (min)(requestedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                requestedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(requestedNanoSteps);
+        }
+
+        virtual void progress()
+        {
+            aggregator->progress();
+        }
+    };
+
+    class Provider :
+        public Link,
+        public PatchProvider<GRID_TYPE>
+    {
+    public:
+        using Link::aggregator;
+        using Link::buffer;
+        using Link::lastNanoStep;
+        using Link::peer;
+        using Link::region;
+        using Link::stride;
+        using Link::tag;
+        using PatchProvider<GRID_TYPE>::checkNanoStepGet;
+        using PatchProvider<GRID_TYPE>::infinity;
+        using PatchProvider<GRID_TYPE>::storedNanoSteps;
+        using PatchProvider<GRID_TYPE>::get;
+
+        inline Provider(
+            const Region<DIM>& region,
+            int source,
+            int tag,
+            AggregatorPtr aggregator) :
+            Link(region, source, tag, aggregator)
+        {
+            aggregator->addSource(source, tag);
+        }
+
+        /**
+         * Consumes the fragment we're still expecting, so that the
+         * sender's message can complete.
+         */
+        virtual void cleanup()
+        {
+            if (!storedNanoSteps.empty()) {
+                aggregator->get(peer, tag, (min)(storedNanoSteps), &buffer);
+            }
+        }
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            Link::charge(next, last, newStride);
+            storedNanoSteps << next;
+        }
+
+        virtual void get(
+            GRID_TYPE *grid,
+            const Region<DIM>& /*patchableRegion*/,
+            const Coord<DIM>& /*globalGridDimensions*/,
+            const std::size_t nanoStep,
+            const std::size_t /*rank*/,
+            const bool /*remove*/ = true)
+        {
+            if (storedNanoSteps.empty() || (nanoStep < (min)(storedNanoSteps))) {
+                return;
+            }
+
+            checkNanoStepGet(nanoStep);
+            aggregator->get(peer, tag, nanoStep, &buffer);
+            grid->loadRegion(buffer, *region);
+
+            std::size_t nextNanoStep = (min)(storedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                storedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(storedNanoSteps);
+        }
+
+        virtual void progress()
+        {
+            aggregator->progress();
+        }
+    };
+};
+
+}
+
+#endif
+#endif
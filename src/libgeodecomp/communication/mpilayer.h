@@ -5,11 +5,14 @@
 #ifdef LIBGEODECOMP_WITH_MPI
 
 #include <mpi.h>
+#include <deque>
 #include <map>
 #include <vector>
 #include <libgeodecomp/communication/typemaps.h>
 #include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/regionwireformat.h>
+#include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/storage/grid.h>
 
 namespace LibGeoDecomp {
@@ -43,6 +46,23 @@ public:
     };
 
     typedef std::map<int, std::vector<MPI_Request> > RequestsMap;
+    typedef std::vector<char> RegionBuffer;
+
+    /**
+     * Notification which is triggered once all requests of a tag
+     * group have completed, see onCompletion().
+     */
+    class CompletionCallback
+    {
+    public:
+        virtual ~CompletionCallback()
+        {}
+
+        virtual void operator()(int tag) = 0;
+    };
+
+    typedef SharedPtr<CompletionCallback>::Type CompletionCallbackPtr;
+    typedef std::map<int, std::vector<CompletionCallbackPtr> > CompletionCallbacksMap;
 
     /**
      * Sets up a new MPILayer. communicator will be used as a scope
@@ -58,7 +78,7 @@ public:
 
     explicit MPILayer(const MPILayer& other)
     {
-        if (other.requests.size() > 0) {
+        if ((other.requests.size() > 0) || (other.pendingRegionReceives.size() > 0)) {
             throw std::logic_error(
                 "Can't clone MPILayer with pending MPI requests,"
                 " as their duplication (and the subsequent doubled MPI_Wait())"
@@ -119,6 +139,61 @@ public:
         requests[tag].push_back(req);
     }
 
+    /**
+     * Creates a persistent send request (see MPI_Send_init()) which
+     * can be started repeatedly via start(). The caller is
+     * responsible for freeing the request via freeRequest().
+     */
+    template<typename T>
+    inline MPI_Request sendInit(
+        const T *c,
+        int dest,
+        int num,
+        int tag,
+        const MPI_Datatype& datatype = Typemaps::lookup<T>())
+    {
+        MPI_Request req;
+        MPI_Send_init(const_cast<T*>(c), num, datatype, dest, tag, comm, &req);
+        return req;
+    }
+
+    /**
+     * Receive counterpart of sendInit()
+     */
+    template<typename T>
+    inline MPI_Request recvInit(
+        T *c,
+        int src,
+        int num,
+        int tag,
+        const MPI_Datatype& datatype = Typemaps::lookup<T>())
+    {
+        MPI_Request req;
+        MPI_Recv_init(c, num, datatype, src, tag, comm, &req);
+        return req;
+    }
+
+    /**
+     * Starts a persistent request. Completion is tracked like for
+     * any other request tagged with waitTag, i.e. via wait() or
+     * test().
+     */
+    inline void start(MPI_Request request, int waitTag)
+    {
+        MPI_Start(&request);
+        requests[waitTag].push_back(request);
+    }
+
+    /**
+     * Releases a persistent request. It must not be active.
+     */
+    static inline void freeRequest(MPI_Request *request)
+    {
+        if (*request != MPI_REQUEST_NULL) {
+            MPI_Request_free(request);
+        }
+    }
+
     void cancelAll()
     {
         for (RequestsMap::iterator i = requests.begin();
@@ -135,6 +210,8 @@ public:
              i != requestVec.end(); ++i) {
             MPI_Cancel(&*i);
         }
+
+        pendingRegionReceives.erase(waitTag);
     }
 
     /**
@@ -143,6 +220,10 @@ public:
      */
     void waitAll()
     {
+        while (!pendingRegionReceives.empty()) {
+            wait(pendingRegionReceives.begin()->first);
+        }
+
         for (RequestsMap::iterator i = requests.begin();
              i != requests.end();
              ++i) {
@@ -156,6 +237,19 @@ public:
      */
     int wait(int waitTag)
     {
+        // Region receives are completed first as our own pending
+        // sends may depend on the peer's progress.
+        PendingRegionsMap::iterator pending = pendingRegionReceives.find(waitTag);
+        if (pending != pendingRegionReceives.end()) {
+            PendingRegionVec receives;
+            std::swap(receives, pending->second);
+            pendingRegionReceives.erase(pending);
+
+            for (PendingRegionVec::iterator i = receives.begin(); i != receives.end(); ++i) {
+                (*i)->complete(this);
+            }
+        }
+
         std::vector<MPI_Request>& requestVec = requests[waitTag];
         int ret = requestVec.size();
 
@@ -164,6 +258,8 @@ public:
         }
 
         requestVec.clear();
+        regionSendBuffers.erase(waitTag);
+        notifyCompletion(waitTag);
         return ret;
     }
 
@@ -176,13 +272,107 @@ public:
         }
     }
 
-    void test(int testTag)
+    /**
+     * Checks whether the communication requests tagged with testTag
+     * have finished, without blocking. Returns true and releases the
+     * requests if so. Calling this regularly lets MPI implementations
+     * without an asynchronous progress engine advance transfers.
+     */
+    bool test(int testTag)
     {
-        int flag;
+        if (pendingRegionReceives.count(testTag)) {
+            return false;
+        }
+
+        int flag = 1;
         std::vector<MPI_Request>& requestVec = requests[testTag];
-        if(requestVec.size() > 0) {
+        if (requestVec.size() > 0) {
             MPI_Testall(requestVec.size(), &requestVec[0], &flag, MPI_STATUSES_IGNORE);
         }
+
+        if (flag) {
+            requestVec.clear();
+            regionSendBuffers.erase(testTag);
+            notifyCompletion(testTag);
+        }
+
+        return flag != 0;
+    }
+
+    /**
+     * Drives all outstanding requests without blocking (see
+     * MPI_Testsome()) and releases those which have completed.
+     * Completion callbacks of tag groups which are now empty will be
+     * triggered. Steppers call this periodically between chunks of
+     * computation (via PatchAccepter/PatchProvider::progress()), so
+     * that large rendezvous transfers advance even if the MPI
+     * implementation lacks an asynchronous progress engine. Returns
+     * the number of requests completed by this call.
+     */
+    int progress()
+    {
+        int completed = 0;
+        std::vector<int> finishedTags;
+
+        for (RequestsMap::iterator i = requests.begin(); i != requests.end(); ++i) {
+            std::vector<MPI_Request>& requestVec = i->second;
+            if (requestVec.empty()) {
+                continue;
+            }
+
+            int outCount;
+            std::vector<int> indices(requestVec.size());
+            MPI_Testsome(requestVec.size(), &requestVec[0], &outCount, &indices[0], MPI_STATUSES_IGNORE);
+            if (outCount == MPI_UNDEFINED) {
+                outCount = requestVec.size();
+                requestVec.clear();
+            } else {
+                // completed persistent requests are merely deactivated,
+                // so we have to rely on the indices to remove them:
+                std::vector<bool> done(requestVec.size(), false);
+                for (int j = 0; j < outCount; ++j) {
+                    done[indices[j]] = true;
+                }
+
+                std::size_t kept = 0;
+                for (std::size_t j = 0; j < requestVec.size(); ++j) {
+                    if (!done[j]) {
+                        requestVec[kept++] = requestVec[j];
+                    }
+                }
+                requestVec.resize(kept);
+            }
+
+            completed += outCount;
+            if ((outCount > 0) && requestVec.empty() && !pendingRegionReceives.count(i->first)) {
+                finishedTags.push_back(i->first);
+            }
+        }
+
+        // callbacks may issue new requests, hence we defer them until
+        // we're done traversing the requests:
+        for (std::vector<int>::iterator i = finishedTags.begin(); i != finishedTags.end(); ++i) {
+            regionSendBuffers.erase(*i);
+            notifyCompletion(*i);
+        }
+
+        return completed;
+    }
+
+    /**
+     * Registers a callback which will be triggered once all requests
+     * currently tagged with waitTag have completed, i.e. from within
+     * wait(), test() or progress(). If no requests are pending, the
+     * callback is triggered immediately. Each callback fires once.
+     */
+    void onCompletion(int waitTag, const CompletionCallbackPtr& callback)
+    {
+        if (requests[waitTag].empty() && !pendingRegionReceives.count(waitTag)) {
+            (*callback)(waitTag);
+            return;
+        }
+
+        completionCallbacks[waitTag].push_back(callback);
     }
 
     void barrier()
@@ -254,19 +444,16 @@ public:
     }
 
     /**
-     * Sends a region object synchronously to another node.
+     * Sends a region object synchronously to another node. The
+     * Region is transmitted in a single message, encoded via
+     * RegionWireFormat.
      */
     template<int DIM>
     void sendRegion(const Region<DIM>& region, int dest)
     {
-        unsigned numStreaks = region.numStreaks();
-        MPI_Request req;
-        MPI_Isend(&numStreaks, 1, MPI_UNSIGNED, dest, tag, comm, &req);
-        if(numStreaks > 0) {
-            std::vector<Streak<DIM> > buf = region.toVector();
-            MPI_Send(&buf[0], numStreaks, Typemaps::lookup<Streak<DIM> >(), dest, tag, comm);
-        }
-        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        RegionBuffer buffer;
+        RegionWireFormat<DIM>::encode(region, &buffer);
+        MPI_Send(&buffer[0], buffer.size(), MPI_CHAR, dest, tag, comm);
     }
 
     /**
@@ -275,17 +462,45 @@ public:
     template<int DIM>
     void recvRegion(Region<DIM> *region, int src)
     {
-        unsigned numStreaks;
-        MPI_Recv(&numStreaks, 1, MPI_UNSIGNED, src, tag, comm, MPI_STATUS_IGNORE);
-        if(numStreaks > 0) {
-            std::vector<Streak<DIM> > buf(numStreaks);
-            MPI_Recv(&buf[0], numStreaks, Typemaps::lookup<Streak<DIM> >(), src, tag, comm, MPI_STATUS_IGNORE);
-            region->clear();
-            region->load(buf.begin(), buf.end());
-        }
-        else {
-            region->clear();
-        }
+        MPI_Status status;
+        MPI_Probe(src, tag, comm, &status);
+        int size;
+        MPI_Get_count(&status, MPI_CHAR, &size);
+
+        RegionBuffer buffer(size);
+        MPI_Recv(&buffer[0], size, MPI_CHAR, src, tag, comm, MPI_STATUS_IGNORE);
+        RegionWireFormat<DIM>::decode(region, buffer);
+    }
+
+    /**
+     * Asynchronous counterpart of sendRegion(). The Region is
+     * encoded immediately, so it may be modified right after this
+     * call. The send buffer is kept until wait(waitTag) returns.
+     */
+    template<int DIM>
+    void isendRegion(const Region<DIM>& region, int dest, int waitTag)
+    {
+        std::deque<RegionBuffer>& buffers = regionSendBuffers[waitTag];
+        buffers.push_back(RegionBuffer());
+        RegionWireFormat<DIM>::encode(region, &buffers.back());
+
+        MPI_Request req;
+        MPI_Isend(&buffers.back()[0], buffers.back().size(), MPI_CHAR, dest, tag, comm, &req);
+        requests[waitTag].push_back(req);
+    }
+
+    /**
+     * Asynchronous counterpart of recvRegion(). As the size of the
+     * incoming message is not known beforehand, the receive is
+     * matched and completed during wait(waitTag). Region receives
+     * from the same source complete in the order they were issued.
+     */
+    template<int DIM>
+    void irecvRegion(Region<DIM> *region, int src, int waitTag)
+    {
+        pendingRegionReceives[waitTag].push_back(
+            typename SharedPtr<PendingRegionReceive>::Type(
+                new PendingRegionReceiveImplementation<DIM>(region, src)));
     }
 
     /**
@@ -528,9 +743,64 @@ public:
     }
 
 private:
+    /**
+     * Type erasure for deferred Region receives, needed as a single
+     * MPILayer may receive Regions of different dimensions.
+     */
+    class PendingRegionReceive
+    {
+    public:
+        virtual ~PendingRegionReceive()
+        {}
+
+        virtual void complete(MPILayer *layer) = 0;
+    };
+
+    template<int DIM>
+    class PendingRegionReceiveImplementation : public PendingRegionReceive
+    {
+    public:
+        inline PendingRegionReceiveImplementation(Region<DIM> *region, int src) :
+            region(region),
+            src(src)
+        {}
+
+        void complete(MPILayer *layer)
+        {
+            layer->recvRegion(region, src);
+        }
+
+    private:
+        Region<DIM> *region;
+        int src;
+    };
+
+    typedef std::vector<SharedPtr<PendingRegionReceive>::Type> PendingRegionVec;
+    typedef std::map<int, PendingRegionVec> PendingRegionsMap;
+    typedef std::map<int, std::deque<RegionBuffer> > RegionBuffersMap;
+
     MPI_Comm comm;
     int tag;
     RequestsMap requests;
+    PendingRegionsMap pendingRegionReceives;
+    RegionBuffersMap regionSendBuffers;
+    CompletionCallbacksMap completionCallbacks;
+
+    void notifyCompletion(int tag)
+    {
+        CompletionCallbacksMap::iterator i = completionCallbacks.find(tag);
+        if (i == completionCallbacks.end()) {
+            return;
+        }
+
+        std::vector<CompletionCallbackPtr> callbacks;
+        std::swap(callbacks, i->second);
+        completionCallbacks.erase(i);
+
+        for (std::vector<CompletionCallbackPtr>::iterator j = callbacks.begin(); j != callbacks.end(); ++j) {
+            (**j)(tag);
+        }
+    }
 
     typedef std::pair<const void*, unsigned> ChunkSpec;
 
@@ -0,0 +1,93 @@
+#ifndef LIBGEODECOMP_COMMUNICATION_MPIPROGRESSTHREAD_H
+#define LIBGEODECOMP_COMMUNICATION_MPIPROGRESSTHREAD_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_MPI
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <mpi.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace LibGeoDecomp {
+
+/**
+ * Many MPI implementations only advance pending transfers (e.g. the
+ * rendezvous protocol for large messages) while the application is
+ * calling into the library. MPIProgressThread is an optional
+ * progress engine: a background thread which periodically polls the
+ * communicator (via MPI_Iprobe()) while the steppers compute, so that
+ * ghost zone transmissions proceed even if nobody is calling
+ * MPILayer::test() or MPILayer::progress().
+ *
+ * The thread never touches any MPI_Request, so it doesn't interfere
+ * with the MPILayer instances owned by the calling threads. It does
+ * however require MPI to be initialized with MPI_THREAD_MULTIPLE
+ * (see MPI_Init_thread()). Destroying the object stops the thread;
+ * this has to happen prior to MPI_Finalize().
+ */
+class MPIProgressThread
+{
+public:
+    explicit MPIProgressThread(
+        MPI_Comm communicator = MPI_COMM_WORLD,
+        std::chrono::microseconds interval = std::chrono::microseconds(50)) :
+        comm(communicator),
+        interval(interval),
+        running(true),
+        numPolls(0)
+    {
+        int provided;
+        MPI_Query_thread(&provided);
+        if (provided != MPI_THREAD_MULTIPLE) {
+            throw std::logic_error("MPIProgressThread requires MPI to be initialized with MPI_THREAD_MULTIPLE");
+        }
+
+        thread = std::thread(&MPIProgressThread::run, this);
+    }
+
+    ~MPIProgressThread()
+    {
+        running = false;
+        thread.join();
+    }
+
+    /**
+     * Number of times the thread has polled MPI so far.
+     */
+    std::size_t polls() const
+    {
+        return numPolls;
+    }
+
+private:
+    MPI_Comm comm;
+    std::chrono::microseconds interval;
+    std::atomic<bool> running;
+    std::atomic<std::size_t> numPolls;
+    std::thread thread;
+
+    MPIProgressThread(const MPIProgressThread& other);
+    MPIProgressThread& operator=(const MPIProgressThread& other);
+
+    void run()
+    {
+        while (running) {
+            int flag;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &flag, MPI_STATUS_IGNORE);
+            ++numPolls;
+            std::this_thread::sleep_for(interval);
+        }
+    }
+};
+
+}
+
+#endif
+#endif
+
+#endif
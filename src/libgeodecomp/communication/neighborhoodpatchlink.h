@@ -0,0 +1,405 @@
+#ifndef LIBGEODECOMP_COMMUNICATION_NEIGHBORHOODPATCHLINK_H
+#define LIBGEODECOMP_COMMUNICATION_NEIGHBORHOODPATCHLINK_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/geometry/regionhandle.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/storage/patchaccepter.h>
+#include <libgeodecomp/storage/patchprovider.h>
+#include <libgeodecomp/storage/serializationbuffer.h>
+
+#if MPI_VERSION >= 3
+
+namespace LibGeoDecomp {
+
+/**
+ * Drop-in replacement for PatchLink (see MPINeighborhoodUpdateGroup)
+ * which bundles the ghost zone communication of a process into a
+ * single neighborhood collective per synchronization point instead
+ * of one point-to-point message per neighbor and direction. This
+ * lets the MPI library schedule and aggregate the transfers, which
+ * pays off if there are many small ghost zone fragments (e.g. 3D
+ * space-filling curve partitions with up to 26 neighbors).
+ *
+ * All Accepters and Providers of a process share one Exchange, which
+ * holds the buffers and a distributed graph communicator spanning
+ * all neighbors. The collective is started once the last Accepter
+ * has delivered its patch and completed when the first Provider
+ * asks for its patch. Fragments use separate buffers, so the
+ * collective addresses them via MPI_BOTTOM and absolute
+ * displacements (MPI_Ineighbor_alltoallw()) instead of requiring
+ * them to be copied into one contiguous send buffer.
+ *
+ * Only cells of fixed serialized size are supported.
+ */
+template<class GRID_TYPE>
+class NeighborhoodPatchLink
+{
+public:
+    typedef typename GRID_TYPE::CellType CellType;
+    typedef typename SerializationBuffer<CellType>::BufferType BufferType;
+    typedef typename SerializationBuffer<CellType>::FixedSize FixedSize;
+
+    const static int DIM = GRID_TYPE::DIM;
+
+    class Exchange
+    {
+    public:
+        explicit inline Exchange(
+            const MPI_Datatype& cellMPIDatatype,
+            MPI_Comm communicator = MPI_COMM_WORLD) :
+            cellMPIDatatype(cellMPIDatatype),
+            communicator(communicator),
+            graphCommunicator(MPI_COMM_NULL),
+            request(MPI_REQUEST_NULL),
+            pendingPuts(0),
+            currentNanoStep(0),
+            started(false)
+        {
+            if (!FixedSize()) {
+                throw std::logic_error("NeighborhoodPatchLink requires cells of fixed serialized size");
+            }
+        }
+
+        ~Exchange()
+        {
+            wait();
+            if (graphCommunicator != MPI_COMM_NULL) {
+                MPI_Comm_free(&graphCommunicator);
+            }
+        }
+
+        /**
+         * Adds a fragment which will be sent to rank dest. Returns the
+         * fragment's index.
+         */
+        std::size_t addDestination(int dest, const Region<DIM>& region)
+        {
+            checkUncommitted();
+            destinations << dest;
+            sendRegions << RegionHandle<DIM>(region);
+            sendBuffers << SerializationBuffer<CellType>::create(region);
+            return destinations.size() - 1;
+        }
+
+        /**
+         * Adds a fragment which will be received from rank source.
+         * Returns the fragment's index.
+         */
+        std::size_t addSource(int source, const Region<DIM>& region)
+        {
+            checkUncommitted();
+            sources << source;
+            recvRegions << RegionHandle<DIM>(region);
+            recvBuffers << SerializationBuffer<CellType>::create(region);
+            return sources.size() - 1;
+        }
+
+        /**
+         * Creates the graph communicator. This is a collective
+         * operation, so all processes need to call it, even those
+         * without any neighbors.
+         */
+        void commit()
+        {
+            checkUncommitted();
+            MPI_Dist_graph_create_adjacent(
+                communicator,
+                int(sources.size()),
+                sources.data(),
+                MPI_UNWEIGHTED,
+                int(destinations.size()),
+                destinations.data(),
+                MPI_UNWEIGHTED,
+                MPI_INFO_NULL,
+                0,
+                &graphCommunicator);
+
+            setupLayout(sendBuffers, &sendCounts, &sendDisplacements, &sendTypes);
+            setupLayout(recvBuffers, &recvCounts, &recvDisplacements, &recvTypes);
+        }
+
+        void put(std::size_t index, const GRID_TYPE& grid, std::size_t nanoStep)
+        {
+            if (pendingPuts == 0) {
+                // previous exchange needs to be finished before we
+                // may overwrite the send buffers:
+                wait();
+                currentNanoStep = nanoStep;
+            }
+            if (nanoStep != currentNanoStep) {
+                throw std::logic_error("NeighborhoodPatchLink fragments need to be sent at identical nano steps");
+            }
+
+            grid.saveRegion(&sendBuffers[index], *sendRegions[index]);
+
+            if (++pendingPuts == destinations.size()) {
+                start(nanoStep);
+            }
+        }
+
+        void get(std::size_t index, GRID_TYPE *grid, std::size_t nanoStep)
+        {
+            if (!started || (currentNanoStep != nanoStep)) {
+                if (!destinations.empty()) {
+                    throw std::logic_error("NeighborhoodPatchLink fragment requested before exchange was started");
+                }
+
+                // nothing to send, so we're in charge of starting the
+                // exchange:
+                currentNanoStep = nanoStep;
+                start(nanoStep);
+            }
+
+            wait();
+            grid->loadRegion(recvBuffers[index], *recvRegions[index]);
+        }
+
+        void progress()
+        {
+            if (request != MPI_REQUEST_NULL) {
+                int flag;
+                MPI_Test(&request, &flag, MPI_STATUS_IGNORE);
+            }
+        }
+
+        void wait()
+        {
+            if (request != MPI_REQUEST_NULL) {
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+            }
+        }
+
+    private:
+        MPI_Datatype cellMPIDatatype;
+        MPI_Comm communicator;
+        MPI_Comm graphCommunicator;
+        MPI_Request request;
+        std::size_t pendingPuts;
+        std::size_t currentNanoStep;
+        bool started;
+
+        std::vector<int> destinations;
+        std::vector<int> sources;
+        std::vector<RegionHandle<DIM> > sendRegions;
+        std::vector<RegionHandle<DIM> > recvRegions;
+        std::vector<BufferType> sendBuffers;
+        std::vector<BufferType> recvBuffers;
+
+        std::vector<int> sendCounts;
+        std::vector<int> recvCounts;
+        std::vector<MPI_Aint> sendDisplacements;
+        std::vector<MPI_Aint> recvDisplacements;
+        std::vector<MPI_Datatype> sendTypes;
+        std::vector<MPI_Datatype> recvTypes;
+
+        void checkUncommitted() const
+        {
+            if (graphCommunicator != MPI_COMM_NULL) {
+                throw std::logic_error("NeighborhoodPatchLink::Exchange has already been committed");
+            }
+        }
+
+        /**
+         * Buffers are never resized after creation, so their absolute
+         * addresses can be computed once.
+         */
+        void setupLayout(
+            std::vector<BufferType>& buffers,
+            std::vector<int> *counts,
+            std::vector<MPI_Aint> *displacements,
+            std::vector<MPI_Datatype> *types)
+        {
+            for (typename std::vector<BufferType>::iterator i = buffers.begin(); i != buffers.end(); ++i) {
+                MPI_Aint address = 0;
+                if (!i->empty()) {
+                    MPI_Get_address(&(*i)[0], &address);
+                }
+
+                *counts << int(i->size());
+                *displacements << address;
+                *types << cellMPIDatatype;
+            }
+        }
+
+        void start(std::size_t nanoStep)
+        {
+            if (graphCommunicator == MPI_COMM_NULL) {
+                throw std::logic_error("NeighborhoodPatchLink::Exchange needs to be committed first");
+            }
+
+            MPI_Ineighbor_alltoallw(
+                MPI_BOTTOM,
+                sendCounts.data(),
+                sendDisplacements.data(),
+                sendTypes.data(),
+                MPI_BOTTOM,
+                recvCounts.data(),
+                recvDisplacements.data(),
+                recvTypes.data(),
+                graphCommunicator,
+                &request);
+
+            pendingPuts = 0;
+            started = true;
+        }
+    };
+
+    typedef typename SharedPtr<Exchange>::Type ExchangePtr;
+
+    class Link
+    {
+    public:
+        inline Link(ExchangePtr exchange, std::size_t index) :
+            lastNanoStep(0),
+            stride(1),
+            exchange(exchange),
+            index(index)
+        {}
+
+        virtual ~Link()
+        {}
+
+        /**
+         * Completes any pending exchange, which might otherwise be
+         * left hanging on our neighbors.
+         */
+        virtual void cleanup()
+        {
+            exchange->wait();
+        }
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            lastNanoStep = last;
+            stride = newStride;
+        }
+
+    protected:
+        std::size_t lastNanoStep;
+        std::size_t stride;
+        ExchangePtr exchange;
+        std::size_t index;
+    };
+
+    class Accepter :
+        public Link,
+        public PatchAccepter<GRID_TYPE>
+    {
+    public:
+        using Link::exchange;
+        using Link::index;
+        using Link::lastNanoStep;
+        using Link::stride;
+        using PatchAccepter<GRID_TYPE>::checkNanoStepPut;
+        using PatchAccepter<GRID_TYPE>::infinity;
+        using PatchAccepter<GRID_TYPE>::pushRequest;
+        using PatchAccepter<GRID_TYPE>::requestedNanoSteps;
+
+        inline Accepter(
+            const Region<DIM>& region,
+            int dest,
+            ExchangePtr exchange) :
+            Link(exchange, exchange->addDestination(dest, region))
+        {}
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            Link::charge(next, last, newStride);
+            pushRequest(next);
+        }
+
+        virtual void put(
+            const GRID_TYPE& grid,
+            const Region<DIM>& /*validRegion*/,
+            const Coord<DIM>& /*globalGridDimensions*/,
+            const std::size_t nanoStep,
+            const std::size_t /*rank*/)
+        {
+            if (!checkNanoStepPut(nanoStep)) {
+                return;
+            }
+
+            exchange->put(index, grid, nanoStep);
+
+            std::size_t nextNanoStep = (min)(requestedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                requestedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(requestedNanoSteps);
+        }
+
+        virtual void progress()
+        {
+            exchange->progress();
+        }
+    };
+
+    class Provider :
+        public Link,
+        public PatchProvider<GRID_TYPE>
+    {
+    public:
+        using Link::exchange;
+        using Link::index;
+        using Link::lastNanoStep;
+        using Link::stride;
+        using PatchProvider<GRID_TYPE>::checkNanoStepGet;
+        using PatchProvider<GRID_TYPE>::infinity;
+        using PatchProvider<GRID_TYPE>::storedNanoSteps;
+        using PatchProvider<GRID_TYPE>::get;
+
+        inline Provider(
+            const Region<DIM>& region,
+            int source,
+            ExchangePtr exchange) :
+            Link(exchange, exchange->addSource(source, region))
+        {}
+
+        virtual void charge(std::size_t next, std::size_t last, std::size_t newStride)
+        {
+            Link::charge(next, last, newStride);
+            storedNanoSteps << next;
+        }
+
+        virtual void get(
+            GRID_TYPE *grid,
+            const Region<DIM>& /*patchableRegion*/,
+            const Coord<DIM>& /*globalGridDimensions*/,
+            const std::size_t nanoStep,
+            const std::size_t /*rank*/,
+            const bool /*remove*/ = true)
+        {
+            if (storedNanoSteps.empty() || (nanoStep < (min)(storedNanoSteps))) {
+                return;
+            }
+
+            checkNanoStepGet(nanoStep);
+            exchange->get(index, grid, nanoStep);
+
+            std::size_t nextNanoStep = (min)(storedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                storedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(storedNanoSteps);
+        }
+
+        virtual void progress()
+        {
+            exchange->progress();
+        }
+    };
+};
+
+}
+
+#endif
+#endif
+#endif
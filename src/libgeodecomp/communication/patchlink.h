@@ -6,18 +6,60 @@
 
 #include <deque>
 #include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/geometry/regionhandle.h>
 #include <libgeodecomp/misc/limits.h>
 #include <libgeodecomp/storage/patchaccepter.h>
+#include <libgeodecomp/storage/halocompressor.h>
 #include <libgeodecomp/storage/patchprovider.h>
 #include <libgeodecomp/storage/serializationbuffer.h>
 
 namespace LibGeoDecomp {
 
+namespace PatchLinkHelpers {
+
+/**
+ * Compressed payloads vary in size, even if the cells' serialization
+ * doesn't.
+ */
+template<typename FIXED_SIZE, typename COMPRESSED>
+class SelectFixedSizeTransport
+{
+public:
+    typedef FIXED_SIZE Value;
+};
+
+template<typename FIXED_SIZE>
+class SelectFixedSizeTransport<FIXED_SIZE, APITraits::TrueType>
+{
+public:
+    typedef APITraits::FalseType Value;
+};
+
+}
+
 /**
  * PatchLink encapsulates the transmission of patches to and from
  * remote processes. PatchLink::Accepter takes the patches from a
  * Stepper hands them on to MPI, while PatchLink::Provider will receive
  * the patches from the net and provide then to a Stepper.
+ *
+ * Ghost zone regions remain fixed for many time steps, so for cells
+ * with a fixed size serialization the links transmit via persistent
+ * MPI requests (MPI_Send_init()/MPI_Recv_init()) on a pre-sized
+ * buffer. Both are only rebuilt if the region is changed via
+ * resetRegion(). Variable size payloads (e.g. Boost.Serialization) use
+ * regular non-blocking messages.
+ *
+ * Models flagged with APITraits::HasInPlaceHaloExchange skip the
+ * buffer altogether: patches are transmitted directly from/to the
+ * grid via a derived MPI datatype which maps the region's Streaks.
+ * As the grid may be modified right after put() returns, and the
+ * target grid isn't known prior to get(), these transfers complete
+ * within the respective call.
+ *
+ * Models flagged with APITraits::HasHaloCompression get their
+ * serialized patches compressed by a HaloCompressor. These are sent
+ * like variable size payloads.
  */
 template<class GRID_TYPE>
 class PatchLink
@@ -28,6 +70,10 @@ public:
     typedef typename GRID_TYPE::CellType CellType;
     typedef typename SerializationBuffer<CellType>::BufferType BufferType;
     typedef typename SerializationBuffer<CellType>::FixedSize FixedSize;
+    typedef typename APITraits::SelectInPlaceHaloExchange<CellType>::Value InPlace;
+    typedef typename APITraits::SelectHaloCompression<CellType>::Value Compressed;
+    typedef typename PatchLinkHelpers::SelectFixedSizeTransport<FixedSize, Compressed>::Value FixedSizeTransport;
+    typedef typename BufferType::value_type BufferElement;
 
     const static int DIM = GRID_TYPE::DIM;
 
@@ -49,12 +95,19 @@ public:
             mpiLayer(communicator),
             region(region),
             buffer(SerializationBuffer<CellType>::create(region)),
-            tag(tag)
+            tag(tag),
+            persistentRequest(MPI_REQUEST_NULL),
+            inPlaceDatatype(MPI_DATATYPE_NULL),
+            compressor(
+                compressionDistance(),
+                APITraits::SelectHaloCompression<CellType>::MANTISSA_BITS)
         {}
 
         virtual ~Link()
         {
             wait();
+            MPILayer::freeRequest(&persistentRequest);
+            freeInPlaceDatatype();
         }
 
         /**
@@ -81,13 +134,95 @@ public:
             mpiLayer.cancelAll();
         }
 
+        /**
+         * Returns true if all transfers of this link have completed.
+         * MPI implementations often advance non-blocking transfers
+         * only from within MPI calls, so Steppers poke their links
+         * via progress() while updating the inner set.
+         */
+        inline bool test()
+        {
+            return mpiLayer.test(tag);
+        }
+
+        /**
+         * Changes the region to be transmitted, e.g. after load
+         * balancing. Waits for pending transmissions, then drops the
+         * persistent request as it's bound to the old buffer.
+         */
+        virtual void resetRegion(const Region<DIM>& newRegion)
+        {
+            wait();
+            MPILayer::freeRequest(&persistentRequest);
+            freeInPlaceDatatype();
+            region = RegionHandle<DIM>(newRegion);
+            buffer = SerializationBuffer<CellType>::create(newRegion);
+        }
+
     protected:
         std::size_t lastNanoStep;
         long stride;
         MPILayer mpiLayer;
-        Region<DIM> region;
+        RegionHandle<DIM> region;
         BufferType buffer;
         int tag;
+        MPI_Request persistentRequest;
+        MPI_Datatype inPlaceDatatype;
+        CoordBox<DIM> inPlaceBox;
+        HaloCompressor compressor;
+        std::vector<char> compressedBuffer;
+
+        /**
+         * SoA and Boost.Serialization buffers are plain bytes, so we
+         * can only guess that they consist of 8 byte values.
+         */
+        static std::size_t compressionDistance()
+        {
+            return (sizeof(BufferElement) == 1) ? HaloCompressor::WORD_SIZE : sizeof(BufferElement);
+        }
+
+        /**
+         * Yields a datatype which addresses the region's cells
+         * relative to grid.data(). Grids with identical bounding
+         * boxes (e.g. a Stepper's old and new grid) share the same
+         * layout, so the datatype is only rebuilt if the region or
+         * the bounding box change.
+         */
+        MPI_Datatype regionDatatype(const GRID_TYPE& grid, const MPI_Datatype& cellMPIDatatype)
+        {
+            CoordBox<DIM> box = grid.boundingBox();
+            if ((inPlaceDatatype != MPI_DATATYPE_NULL) && (box == inPlaceBox)) {
+                return inPlaceDatatype;
+            }
+
+            freeInPlaceDatatype();
+            std::vector<int> lengths;
+            std::vector<MPI_Aint> displacements;
+            const char *base = reinterpret_cast<const char*>(grid.data());
+
+            for (typename Region<DIM>::StreakIterator i = region->beginStreak(); i != region->endStreak(); ++i) {
+                lengths << i->length();
+                displacements << MPI_Aint(reinterpret_cast<const char*>(&grid[i->origin]) - base);
+            }
+
+            MPI_Type_create_hindexed(
+                int(lengths.size()),
+                lengths.data(),
+                displacements.data(),
+                cellMPIDatatype,
+                &inPlaceDatatype);
+            MPI_Type_commit(&inPlaceDatatype);
+            inPlaceBox = box;
+
+            return inPlaceDatatype;
+        }
+
+        void freeInPlaceDatatype()
+        {
+            if (inPlaceDatatype != MPI_DATATYPE_NULL) {
+                MPI_Type_free(&inPlaceDatatype);
+            }
+        }
     };
 
     class Accepter :
@@ -96,8 +231,11 @@ public:
     {
     public:
         using Link::buffer;
+        using Link::compressedBuffer;
+        using Link::compressor;
         using Link::lastNanoStep;
         using Link::mpiLayer;
+        using Link::persistentRequest;
         using Link::region;
         using Link::stride;
         using Link::tag;
@@ -136,10 +274,7 @@ public:
             }
 
             wait();
-            SerializationBuffer<CellType>::resize(&buffer, region.size());
-            grid.saveRegion(&buffer, region);
-            sendHeader(FixedSize());
-            mpiLayer.send(&buffer[0], dest, buffer.size(), tag, cellMPIDatatype);
+            send(grid, InPlace());
 
             std::size_t nextNanoStep = (min)(requestedNanoSteps) + stride;
             if ((lastNanoStep == infinity()) ||
@@ -150,24 +285,73 @@ public:
             erase_min(requestedNanoSteps);
         }
 
+        virtual void progress()
+        {
+            Link::test();
+        }
+
     private:
         int dest;
         int dataSize;
         MPI_Datatype cellMPIDatatype;
 
-        void sendHeader(APITraits::TrueType)
+        void send(const GRID_TYPE& grid, APITraits::TrueType)
         {
-            // we don't need any header for fixed size buffers
+            mpiLayer.send(grid.data(), dest, 1, tag, Link::regionDatatype(grid, cellMPIDatatype));
+            // the Stepper may overwrite the grid right after put():
+            wait();
         }
 
-        void sendHeader(APITraits::FalseType)
+        void send(const GRID_TYPE& grid, APITraits::FalseType)
         {
+            sendBuffered(grid, Compressed());
+        }
+
+        void sendBuffered(const GRID_TYPE& grid, APITraits::TrueType)
+        {
+            SerializationBuffer<CellType>::resize(&buffer, region->size());
+            grid.saveRegion(&buffer, *region);
+            compressor.compress(
+                reinterpret_cast<const char*>(&buffer[0]),
+                buffer.size() * sizeof(BufferElement),
+                &compressedBuffer);
+
+            if (compressedBuffer.size() > std::size_t(Limits<int>::getMax())) {
+                throw std::invalid_argument("buffer size exceeds std::numeric_limits<int>::max()");
+            }
+
+            dataSize = compressedBuffer.size();
+            mpiLayer.send(&dataSize, dest, 1, tag, MPI_INT);
+            mpiLayer.send(&compressedBuffer[0], dest, dataSize, tag, MPI_CHAR);
+        }
+
+        void sendBuffered(const GRID_TYPE& grid, APITraits::FalseType)
+        {
+            sendSerialized(grid, FixedSize());
+        }
+
+        void sendSerialized(const GRID_TYPE& grid, APITraits::TrueType)
+        {
+            // the buffer's size is fixed, so is its address:
+            grid.saveRegion(&buffer, *region);
+            if (persistentRequest == MPI_REQUEST_NULL) {
+                persistentRequest = mpiLayer.sendInit(&buffer[0], dest, buffer.size(), tag, cellMPIDatatype);
+            }
+            mpiLayer.start(persistentRequest, tag);
+        }
+
+        void sendSerialized(const GRID_TYPE& grid, APITraits::FalseType)
+        {
+            SerializationBuffer<CellType>::resize(&buffer, region->size());
+            grid.saveRegion(&buffer, *region);
+
             if (buffer.size() > std::size_t(Limits<int>::getMax())) {
                 throw std::invalid_argument("buffer size exceeds std::numeric_limits<int>::max()");
             }
 
             dataSize = buffer.size();
             mpiLayer.send(&dataSize, dest, 1, tag, MPI_INT);
+            mpiLayer.send(&buffer[0], dest, buffer.size(), tag, cellMPIDatatype);
         }
     };
 
@@ -177,8 +361,11 @@ public:
     {
     public:
         using Link::buffer;
+        using Link::compressedBuffer;
+        using Link::compressor;
         using Link::lastNanoStep;
         using Link::mpiLayer;
+        using Link::persistentRequest;
         using Link::region;
         using Link::stride;
         using Link::tag;
@@ -199,13 +386,14 @@ public:
             source(source),
             dataSize(0),
             cellMPIDatatype(cellMPIDatatype),
-            transmissionInFlight(false)
+            transmissionInFlight(false),
+            payloadPosted(false)
         {}
 
         virtual void cleanup()
         {
             if (transmissionInFlight) {
-                recvSecondPart(FixedSize());
+                drain(InPlace());
             }
         }
 
@@ -228,12 +416,9 @@ public:
             }
 
             checkNanoStepGet(nanoStep);
-            wait();
-            recvSecondPart(FixedSize());
+            receive(grid, InPlace());
             transmissionInFlight = false;
 
-            grid->loadRegion(buffer, region);
-
             std::size_t nextNanoStep = (min)(storedNanoSteps) + stride;
             if ((lastNanoStep == infinity()) ||
                 (nextNanoStep < lastNanoStep)) {
@@ -246,19 +431,96 @@ public:
         void recv(const std::size_t nanoStep)
         {
             storedNanoSteps << nanoStep;
-            recvFirstPart(FixedSize());
+            postReceive(InPlace());
             transmissionInFlight = true;
         }
 
+        /**
+         * For variable size payloads the receive for the actual data
+         * is posted as soon as its header has arrived, so the sender
+         * doesn't need to wait for us to reach get().
+         */
+        virtual void progress()
+        {
+            if (Link::test() && transmissionInFlight) {
+                postPayload(FixedSizeTransport());
+            }
+        }
+
+        /**
+         * Must not be called while a receive is pending, i.e.
+         * between charge() and the retrieval of the last nano step.
+         */
+        virtual void resetRegion(const Region<DIM>& newRegion)
+        {
+            if (transmissionInFlight) {
+                throw std::logic_error("PatchLink::Provider can't change its region while a receive is pending");
+            }
+
+            Link::resetRegion(newRegion);
+        }
+
     private:
         int source;
         int dataSize;
         MPI_Datatype cellMPIDatatype;
         bool transmissionInFlight;
+        bool payloadPosted;
 
-        void recvFirstPart(APITraits::TrueType)
+        void postReceive(APITraits::TrueType)
+        {
+            // deferred to get() as only then the target grid is known
+        }
+
+        void postReceive(APITraits::FalseType)
+        {
+            recvFirstPart(FixedSizeTransport());
+        }
+
+        void receive(GRID_TYPE *grid, APITraits::TrueType)
+        {
+            mpiLayer.recv(grid->data(), source, 1, tag, Link::regionDatatype(*grid, cellMPIDatatype));
+            wait();
+        }
+
+        void receive(GRID_TYPE *grid, APITraits::FalseType)
+        {
+            wait();
+            recvSecondPart(FixedSizeTransport());
+            decompress(Compressed());
+            grid->loadRegion(buffer, *region);
+        }
+
+        void drain(APITraits::TrueType)
         {
+            SerializationBuffer<CellType>::resize(&buffer, region->size());
             mpiLayer.recv(&buffer[0], source, buffer.size(), tag, cellMPIDatatype);
+            wait();
+        }
+
+        void drain(APITraits::FalseType)
+        {
+            recvSecondPart(FixedSizeTransport());
+        }
+
+        void decompress(APITraits::TrueType)
+        {
+            std::size_t size = HaloCompressor::decompressedSize(compressedBuffer);
+            buffer.resize(size / sizeof(BufferElement));
+            compressor.decompress(compressedBuffer, reinterpret_cast<char*>(&buffer[0]));
+        }
+
+        void decompress(APITraits::FalseType)
+        {
+            // payload was received into the buffer directly
+        }
+
+        void recvFirstPart(APITraits::TrueType)
+        {
+            if (persistentRequest == MPI_REQUEST_NULL) {
+                persistentRequest = mpiLayer.recvInit(&buffer[0], source, buffer.size(), tag, cellMPIDatatype);
+            }
+            mpiLayer.start(persistentRequest, tag);
         }
 
         void recvFirstPart(APITraits::FalseType)
@@ -272,10 +534,40 @@ public:
         }
 
         void recvSecondPart(APITraits::FalseType)
+        {
+            postPayload(APITraits::FalseType());
+            wait();
+            payloadPosted = false;
+        }
+
+        void postPayload(APITraits::TrueType)
+        {
+            // payload is part of the first receive
+        }
+
+        /**
+         * Expects the header to have been received already.
+         */
+        void postPayload(APITraits::FalseType)
+        {
+            if (payloadPosted) {
+                return;
+            }
+
+            recvPayload(Compressed());
+            payloadPosted = true;
+        }
+
+        void recvPayload(APITraits::TrueType)
+        {
+            compressedBuffer.resize(dataSize);
+            mpiLayer.recv(&compressedBuffer[0], source, dataSize, tag, MPI_CHAR);
+        }
+
+        void recvPayload(APITraits::FalseType)
         {
             buffer.resize(dataSize);
             mpiLayer.recv(&buffer[0], source, dataSize, tag, cellMPIDatatype);
-            wait();
         }
     };
 
@@ -0,0 +1,414 @@
+#ifndef LIBGEODECOMP_COMMUNICATION_SHAREDMEMORYPATCHLINK_H
+#define LIBGEODECOMP_COMMUNICATION_SHAREDMEMORYPATCHLINK_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/patchlink.h>
+#include <libgeodecomp/misc/sharedptr.h>
+
+#if MPI_VERSION >= 3
+
+#include <algorithm>
+#include <cstring>
+
+namespace LibGeoDecomp {
+
+/**
+ * Intra-node variant of the PatchLink: ghost zones are exchanged via
+ * a shared memory window (MPI_Win_allocate_shared()) instead of
+ * point-to-point messages. Each Accepter owns a double buffered slot
+ * in its process' segment of the window, which the matching
+ * Provider on the neighboring process reads directly. Both sides
+ * synchronize via two sequence counters: the Accepter bumps its
+ * "sent" counter once a patch is complete, the Provider bumps its
+ * "consumed" counter once it has copied the patch. No messages are
+ * exchanged after setup.
+ *
+ * Models flagged with APITraits::HasInPlaceHaloExchange are copied
+ * Streak-wise between the grids and the shared slot, which saves the
+ * serialization buffer on both ends. Other models are serialized as
+ * usual and the buffer is then copied to/from the slot.
+ *
+ * Accepter and Provider derive from their PatchLink counterparts so
+ * that an UpdateGroup can mix them with regular PatchLinks for
+ * neighbors on other nodes (see MPISharedMemoryUpdateGroup).
+ */
+template<class GRID_TYPE>
+class SharedMemoryPatchLink
+{
+public:
+    typedef typename GRID_TYPE::CellType CellType;
+    typedef typename PatchLink<GRID_TYPE>::BufferType BufferType;
+    typedef typename PatchLink<GRID_TYPE>::FixedSize FixedSize;
+    typedef typename PatchLink<GRID_TYPE>::InPlace InPlace;
+    typedef typename BufferType::value_type BufferElement;
+    typedef volatile std::size_t Counter;
+
+    const static int DIM = GRID_TYPE::DIM;
+
+    /**
+     * Counters are padded to a full cache line to avoid false
+     * sharing with the payload.
+     */
+    const static std::size_t HEADER_SIZE = 64;
+
+    /**
+     * Manages the shared memory window of all processes on a node.
+     * Links register their slots prior to commit(), which allocates
+     * the window and tells each link where its peer's slot resides.
+     * Construction, commit() and destruction are collective
+     * operations.
+     */
+    class Window
+    {
+    public:
+        explicit Window(MPI_Comm communicator = MPI_COMM_WORLD) :
+            mpiLayer(communicator),
+            window(MPI_WIN_NULL),
+            base(0),
+            segmentSize(0)
+        {
+            MPI_Comm_split_type(
+                communicator,
+                MPI_COMM_TYPE_SHARED,
+                mpiLayer.rank(),
+                MPI_INFO_NULL,
+                &nodeCommunicator);
+
+            MPI_Group group;
+            MPI_Group nodeGroup;
+            MPI_Comm_group(communicator, &group);
+            MPI_Comm_group(nodeCommunicator, &nodeGroup);
+
+            std::vector<int> ranks;
+            for (int i = 0; i < mpiLayer.size(); ++i) {
+                ranks << i;
+            }
+            nodeRanks.resize(ranks.size());
+            MPI_Group_translate_ranks(group, int(ranks.size()), ranks.data(), nodeGroup, nodeRanks.data());
+
+            MPI_Group_free(&nodeGroup);
+            MPI_Group_free(&group);
+        }
+
+        ~Window()
+        {
+            if (window != MPI_WIN_NULL) {
+                MPI_Win_unlock_all(window);
+                MPI_Win_free(&window);
+            }
+            MPI_Comm_free(&nodeCommunicator);
+        }
+
+        bool isNodeLocal(int rank) const
+        {
+            return nodeRanks[rank] != MPI_UNDEFINED;
+        }
+
+        /**
+         * Reserves a slot of the given size in this process'
+         * segment. Returns the slot's offset. The slot will be paired
+         * with the slot of type peerKind which rank peer registers for
+         * us.
+         */
+        std::size_t addSlot(std::size_t size, int peer, int kind, int peerKind)
+        {
+            if (window != MPI_WIN_NULL) {
+                throw std::logic_error("SharedMemoryPatchLink::Window has already been committed");
+            }
+            if (!isNodeLocal(peer)) {
+                throw std::invalid_argument("SharedMemoryPatchLink peer is not located on this node");
+            }
+
+            std::size_t offset = segmentSize;
+            // keep slots cache line aligned:
+            segmentSize += (size + HEADER_SIZE - 1) / HEADER_SIZE * HEADER_SIZE;
+
+            slots << Slot(offset, peer, kind, peerKind);
+            return slots.size() - 1;
+        }
+
+        void commit()
+        {
+            if (window != MPI_WIN_NULL) {
+                throw std::logic_error("SharedMemoryPatchLink::Window has already been committed");
+            }
+
+            MPI_Win_allocate_shared(
+                MPI_Aint(segmentSize),
+                1,
+                MPI_INFO_NULL,
+                nodeCommunicator,
+                &base,
+                &window);
+            std::fill(base, base + segmentSize, 0);
+            MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+
+            // each process tells its peers where its halves of the
+            // links are located:
+            for (typename std::vector<Slot>::iterator i = slots.begin(); i != slots.end(); ++i) {
+                mpiLayer.send(&i->offset, i->peer, 1, MPILayer::PATCH_LINK + 1 + i->kind, MPI_UNSIGNED_LONG);
+                mpiLayer.recv(&i->peerOffset, i->peer, 1, MPILayer::PATCH_LINK + 1 + i->peerKind, MPI_UNSIGNED_LONG);
+            }
+            mpiLayer.waitAll();
+            sync();
+        }
+
+        char *localSlot(std::size_t index)
+        {
+            return base + slots[index].offset;
+        }
+
+        char *remoteSlot(std::size_t index)
+        {
+            MPI_Aint size;
+            int dispUnit;
+            char *peerBase;
+            MPI_Win_shared_query(window, nodeRanks[slots[index].peer], &size, &dispUnit, &peerBase);
+            return peerBase + slots[index].peerOffset;
+        }
+
+        /**
+         * Acts as a memory barrier for accesses to the window.
+         */
+        void sync()
+        {
+            MPI_Win_sync(window);
+        }
+
+    private:
+        class Slot
+        {
+        public:
+            inline Slot(std::size_t offset, int peer, int kind, int peerKind) :
+                offset(offset),
+                peerOffset(0),
+                peer(peer),
+                kind(kind),
+                peerKind(peerKind)
+            {}
+
+            unsigned long offset;
+            unsigned long peerOffset;
+            int peer;
+            int kind;
+            int peerKind;
+        };
+
+        MPILayer mpiLayer;
+        MPI_Comm nodeCommunicator;
+        MPI_Win window;
+        char *base;
+        std::size_t segmentSize;
+        std::vector<int> nodeRanks;
+        std::vector<Slot> slots;
+    };
+
+    typedef typename SharedPtr<Window>::Type WindowPtr;
+
+    class Accepter : public PatchLink<GRID_TYPE>::Accepter
+    {
+    public:
+        typedef typename PatchLink<GRID_TYPE>::Accepter ParentType;
+
+        using ParentType::buffer;
+        using ParentType::checkNanoStepPut;
+        using ParentType::infinity;
+        using ParentType::lastNanoStep;
+        using ParentType::region;
+        using ParentType::requestedNanoSteps;
+        using ParentType::stride;
+
+        inline Accepter(
+            const Region<DIM>& region,
+            int dest,
+            const MPI_Datatype& cellMPIDatatype,
+            WindowPtr window) :
+            ParentType(region, dest, MPILayer::PATCH_LINK, cellMPIDatatype),
+            window(window),
+            payloadSize(payloadBytes(region, FixedSize())),
+            sent(0),
+            slot(window->addSlot(HEADER_SIZE + 2 * payloadSize, dest, 0, 1))
+        {}
+
+        virtual void put(
+            const GRID_TYPE& grid,
+            const Region<DIM>& /*validRegion*/,
+            const Coord<DIM>& /*globalGridDimensions*/,
+            const std::size_t nanoStep,
+            const std::size_t /*rank*/)
+        {
+            if (!checkNanoStepPut(nanoStep)) {
+                return;
+            }
+
+            // the slot we're about to overwrite needs to have been
+            // consumed by the Provider:
+            Counter *consumed = reinterpret_cast<Counter*>(window->remoteSlot(slot));
+            while (sent - *consumed >= 2) {
+                window->sync();
+            }
+
+            char *payload = window->localSlot(slot) + HEADER_SIZE + (sent % 2) * payloadSize;
+            copyOut(grid, payload, InPlace());
+            window->sync();
+            *reinterpret_cast<Counter*>(window->localSlot(slot)) = ++sent;
+            window->sync();
+
+            std::size_t nextNanoStep = (min)(requestedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                requestedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(requestedNanoSteps);
+        }
+
+        virtual void progress()
+        {}
+
+        virtual void resetRegion(const Region<DIM>& /* newRegion */)
+        {
+            throw std::logic_error("SharedMemoryPatchLink can't change its region as its slot is fixed");
+        }
+
+    private:
+        WindowPtr window;
+        std::size_t payloadSize;
+        std::size_t sent;
+        std::size_t slot;
+
+        void copyOut(const GRID_TYPE& grid, char *payload, APITraits::TrueType)
+        {
+            for (typename Region<DIM>::StreakIterator i = region->beginStreak(); i != region->endStreak(); ++i) {
+                std::size_t length = i->length() * sizeof(CellType);
+                std::memcpy(payload, &grid[i->origin], length);
+                payload += length;
+            }
+        }
+
+        void copyOut(const GRID_TYPE& grid, char *payload, APITraits::FalseType)
+        {
+            grid.saveRegion(&buffer, *region);
+            std::memcpy(payload, &buffer[0], buffer.size() * sizeof(BufferElement));
+        }
+    };
+
+    class Provider : public PatchLink<GRID_TYPE>::Provider
+    {
+    public:
+        typedef typename PatchLink<GRID_TYPE>::Provider ParentType;
+
+        using ParentType::buffer;
+        using ParentType::checkNanoStepGet;
+        using ParentType::infinity;
+        using ParentType::lastNanoStep;
+        using ParentType::region;
+        using ParentType::storedNanoSteps;
+        using ParentType::stride;
+        using ParentType::get;
+
+        inline Provider(
+            const Region<DIM>& region,
+            int source,
+            const MPI_Datatype& cellMPIDatatype,
+            WindowPtr window) :
+            ParentType(region, source, MPILayer::PATCH_LINK, cellMPIDatatype),
+            window(window),
+            payloadSize(payloadBytes(region, FixedSize())),
+            consumed(0),
+            slot(window->addSlot(HEADER_SIZE, source, 1, 0))
+        {}
+
+        virtual void cleanup()
+        {}
+
+        virtual void charge(const std::size_t next, const std::size_t last, const std::size_t newStride)
+        {
+            PatchLink<GRID_TYPE>::Link::charge(next, last, newStride);
+            storedNanoSteps << next;
+        }
+
+        virtual void get(
+            GRID_TYPE *grid,
+            const Region<DIM>& /*patchableRegion*/,
+            const Coord<DIM>& /*globalGridDimensions*/,
+            const std::size_t nanoStep,
+            const std::size_t /*rank*/,
+            const bool /*remove*/ = true)
+        {
+            if (storedNanoSteps.empty() || (nanoStep < (min)(storedNanoSteps))) {
+                return;
+            }
+
+            checkNanoStepGet(nanoStep);
+
+            char *peerSlot = window->remoteSlot(slot);
+            Counter *sent = reinterpret_cast<Counter*>(peerSlot);
+            while (*sent == consumed) {
+                window->sync();
+            }
+
+            copyIn(grid, peerSlot + HEADER_SIZE + (consumed % 2) * payloadSize, InPlace());
+            window->sync();
+            *reinterpret_cast<Counter*>(window->localSlot(slot)) = ++consumed;
+            window->sync();
+
+            std::size_t nextNanoStep = (min)(storedNanoSteps) + stride;
+            if ((lastNanoStep == infinity()) ||
+                (nextNanoStep < lastNanoStep)) {
+                storedNanoSteps << nextNanoStep;
+            }
+
+            erase_min(storedNanoSteps);
+        }
+
+        virtual void progress()
+        {}
+
+        virtual void resetRegion(const Region<DIM>& /* newRegion */)
+        {
+            throw std::logic_error("SharedMemoryPatchLink can't change its region as its slot is fixed");
+        }
+
+    private:
+        WindowPtr window;
+        std::size_t payloadSize;
+        std::size_t consumed;
+        std::size_t slot;
+
+        void copyIn(GRID_TYPE *grid, const char *payload, APITraits::TrueType)
+        {
+            for (typename Region<DIM>::StreakIterator i = region->beginStreak(); i != region->endStreak(); ++i) {
+                std::size_t length = i->length() * sizeof(CellType);
+                std::memcpy(&(*grid)[i->origin], payload, length);
+                payload += length;
+            }
+        }
+
+        void copyIn(GRID_TYPE *grid, const char *payload, APITraits::FalseType)
+        {
+            std::memcpy(&buffer[0], payload, buffer.size() * sizeof(BufferElement));
+            grid->loadRegion(buffer, *region);
+        }
+    };
+
+private:
+    static std::size_t payloadBytes(const Region<DIM>& region, APITraits::TrueType)
+    {
+        return SerializationBuffer<CellType>::create(region).size() * sizeof(BufferElement);
+    }
+
+    static std::size_t payloadBytes(const Region<DIM>& /* region */, APITraits::FalseType)
+    {
+        throw std::logic_error("SharedMemoryPatchLink requires cells of fixed serialized size");
+    }
+};
+
+}
+
+#endif
+#endif
+#endif
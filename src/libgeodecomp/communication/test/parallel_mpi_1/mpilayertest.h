@@ -2,12 +2,31 @@
 #include <mpi.h>
 
 #include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/mpiprogressthread.h>
 #include <libgeodecomp/misc/testcell.h>
 
 using namespace LibGeoDecomp;
 
 namespace LibGeoDecomp {
 
+class CountingCallback : public MPILayer::CompletionCallback
+{
+public:
+    CountingCallback() :
+        calls(0),
+        lastTag(-1)
+    {}
+
+    void operator()(int tag)
+    {
+        ++calls;
+        lastTag = tag;
+    }
+
+    int calls;
+    int lastTag;
+};
+
 class MPILayerTest : public CxxTest::TestSuite
 {
 public:
@@ -72,6 +91,86 @@ public:
         layer.waitAll();
         TS_ASSERT_EQUALS(expected, actual);
     }
+
+    void testProgress()
+    {
+        MPILayer layer;
+        std::vector<double> sendBuffer(100000, 4.7);
+        std::vector<double> recvBuffer(100000, 0);
+        layer.send(&sendBuffer[0], 0, sendBuffer.size(), 11, MPI_DOUBLE);
+        layer.recv(&recvBuffer[0], 0, recvBuffer.size(), 11, MPI_DOUBLE);
+        TS_ASSERT_EQUALS(std::size_t(2), layer.requests[11].size());
+
+        int completed = 0;
+        while (!layer.requests[11].empty()) {
+            completed += layer.progress();
+        }
+        TS_ASSERT_EQUALS(2, completed);
+        TS_ASSERT_EQUALS(sendBuffer, recvBuffer);
+        TS_ASSERT_EQUALS(0, layer.progress());
+    }
+
+    void testCompletionCallbacks()
+    {
+        MPILayer layer;
+        SharedPtr<CountingCallback>::Type callbackA(new CountingCallback);
+        SharedPtr<CountingCallback>::Type callbackB(new CountingCallback);
+        SharedPtr<CountingCallback>::Type callbackC(new CountingCallback);
+
+        // nothing pending, so the callback fires right away:
+        layer.onCompletion(12, callbackA);
+        TS_ASSERT_EQUALS(1, callbackA->calls);
+        TS_ASSERT_EQUALS(12, callbackA->lastTag);
+
+        int sendValue = 47;
+        int recvValue = 0;
+        layer.send(&sendValue, 0, 1, 13, MPI_INT);
+        layer.recv(&recvValue, 0, 1, 13, MPI_INT);
+        layer.onCompletion(13, callbackB);
+        TS_ASSERT_EQUALS(0, callbackB->calls);
+
+        while (callbackB->calls == 0) {
+            layer.progress();
+        }
+        TS_ASSERT_EQUALS(1, callbackB->calls);
+        TS_ASSERT_EQUALS(13, callbackB->lastTag);
+        TS_ASSERT_EQUALS(47, recvValue);
+
+        layer.send(&sendValue, 0, 1, 14, MPI_INT);
+        layer.recv(&recvValue, 0, 1, 14, MPI_INT);
+        layer.onCompletion(14, callbackC);
+        layer.wait(14);
+        TS_ASSERT_EQUALS(1, callbackC->calls);
+
+        // callbacks fire only once:
+        layer.progress();
+        layer.wait(13);
+        layer.wait(14);
+        TS_ASSERT_EQUALS(1, callbackA->calls);
+        TS_ASSERT_EQUALS(1, callbackB->calls);
+        TS_ASSERT_EQUALS(1, callbackC->calls);
+    }
+
+    void testProgressThread()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        int provided;
+        MPI_Query_thread(&provided);
+        if (provided != MPI_THREAD_MULTIPLE) {
+            TS_ASSERT_THROWS(MPIProgressThread(), std::logic_error&);
+            return;
+        }
+
+        MPILayer layer;
+        MPIProgressThread progressThread;
+        int sendValue = 11;
+        int recvValue = 0;
+        layer.send(&sendValue, 0, 1, 15, MPI_INT);
+        layer.recv(&recvValue, 0, 1, 15, MPI_INT);
+        layer.wait(15);
+        TS_ASSERT_EQUALS(11, recvValue);
+#endif
+    }
 };
 
 }
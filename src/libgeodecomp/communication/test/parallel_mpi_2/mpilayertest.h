@@ -165,6 +165,43 @@ public:
         }
     }
 
+    void testSendRecvRegionNonblocking()
+    {
+        MPILayer layer;
+        int other = 1 - layer.rank();
+
+        Region<3> sparse;
+        for (int i = 0; i < 100; ++i) {
+            sparse << Streak<3>(Coord<3>(i * 3 - 50, -i, i % 7), i * 3 - 50 + 1 + layer.rank());
+        }
+        Region<3> box(CoordBox<3>(Coord<3>(-5, 0, 10), Coord<3>(100, 50, 20 + layer.rank())));
+        Region<1> empty;
+
+        layer.isendRegion(sparse, other, 1);
+        layer.isendRegion(box,    other, 1);
+        layer.isendRegion(empty,  other, 1);
+
+        Region<3> actualSparse;
+        Region<3> actualBox;
+        Region<1> actualEmpty;
+        actualEmpty << Coord<1>(47);
+        layer.irecvRegion(&actualSparse, other, 1);
+        layer.irecvRegion(&actualBox,    other, 1);
+        layer.irecvRegion(&actualEmpty,  other, 1);
+        layer.wait(1);
+
+        Region<3> expectedSparse;
+        for (int i = 0; i < 100; ++i) {
+            expectedSparse << Streak<3>(Coord<3>(i * 3 - 50, -i, i % 7), i * 3 - 50 + 1 + other);
+        }
+        Region<3> expectedBox(CoordBox<3>(Coord<3>(-5, 0, 10), Coord<3>(100, 50, 20 + other)));
+
+        TS_ASSERT_EQUALS(actualSparse, expectedSparse);
+        TS_ASSERT_EQUALS(actualBox, expectedBox);
+        TS_ASSERT_EQUALS(actualBox.boundingBox(), expectedBox.boundingBox());
+        TS_ASSERT_EQUALS(actualEmpty, empty);
+    }
+
     void testAllGatherAgain()
     {
         MPILayer layer;
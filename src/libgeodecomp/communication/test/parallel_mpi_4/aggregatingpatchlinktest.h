@@ -0,0 +1,114 @@
+#include <cxxtest/TestSuite.h>
+
+#include <libgeodecomp/communication/aggregatingpatchlink.h>
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class AggregatingPatchLinkTest : public CxxTest::TestSuite
+{
+public:
+    typedef DisplacedGrid<double> GridType;
+    typedef AggregatingPatchLink<GridType> LinkType;
+    typedef SharedPtr<LinkType::Accepter>::Type AccepterPtr;
+    typedef SharedPtr<LinkType::Provider>::Type ProviderPtr;
+
+    void setUp()
+    {
+        mpiLayer.reset(new MPILayer());
+
+        regions.clear();
+        regions << Region<2>();
+        regions.back() << Streak<2>(Coord<2>(0, 0), 6);
+        regions << Region<2>();
+        regions.back() << Streak<2>(Coord<2>(4, 1), 5);
+        regions.back() << Streak<2>(Coord<2>(1, 2), 3);
+        regions << Region<2>();
+        regions.back() << Streak<2>(Coord<2>(0, 4), 7);
+
+        boundingBox = CoordBox<2>(Coord<2>(0, 0), Coord<2>(7, 5));
+        boundingRegion.clear();
+        boundingRegion << boundingBox;
+
+        dest   = (mpiLayer->rank() + 1) % mpiLayer->size();
+        source = (mpiLayer->rank() + mpiLayer->size() - 1) % mpiLayer->size();
+    }
+
+    void tearDown()
+    {
+        mpiLayer.reset();
+    }
+
+    void testAggregation()
+    {
+        LinkType::AggregatorPtr aggregator(new LinkType::Aggregator());
+        std::vector<AccepterPtr> accepters;
+        std::vector<ProviderPtr> providers;
+
+        for (std::size_t i = 0; i < regions.size(); ++i) {
+            accepters << AccepterPtr(new LinkType::Accepter(regions[i], dest, i, aggregator));
+            providers << ProviderPtr(new LinkType::Provider(regions[i], source, i, aggregator));
+
+            // the last link only transmits every other nano step:
+            std::size_t stride = (i == 2) ? 2 : 1;
+            accepters.back()->charge(0, 8, stride);
+            providers.back()->charge(0, 8, stride);
+        }
+
+        for (std::size_t nanoStep = 0; nanoStep < 8; ++nanoStep) {
+            GridType sendGrid(boundingBox, -1);
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                sendGrid[*i] = mpiLayer->rank() * 1000 + nanoStep * 100 + i->y() * 10 + i->x();
+            }
+            for (std::size_t i = 0; i < accepters.size(); ++i) {
+                accepters[i]->put(sendGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+            }
+
+            GridType recvGrid(boundingBox, -1);
+            Region<2> expectedRegion;
+            for (std::size_t i = 0; i < providers.size(); ++i) {
+                providers[i]->get(&recvGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+                if ((i != 2) || (nanoStep % 2 == 0)) {
+                    expectedRegion += regions[i];
+                }
+            }
+
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                double expected = -1;
+                if (expectedRegion.count(*i)) {
+                    expected = source * 1000 + nanoStep * 100 + i->y() * 10 + i->x();
+                }
+                TS_ASSERT_EQUALS(expected, recvGrid[*i]);
+            }
+        }
+
+        // one message per nano step, regardless of the number of links:
+        TS_ASSERT_EQUALS(std::size_t(8), aggregator->sentMessages());
+
+        for (std::size_t i = 0; i < accepters.size(); ++i) {
+            accepters[i]->cleanup();
+            providers[i]->cleanup();
+        }
+    }
+
+    void testDuplicateTag()
+    {
+        LinkType::AggregatorPtr aggregator(new LinkType::Aggregator());
+        LinkType::Accepter accepter(regions[0], dest, 47, aggregator);
+        TS_ASSERT_THROWS(LinkType::Accepter(regions[1], dest, 47, aggregator), std::invalid_argument&);
+    }
+
+private:
+    SharedPtr<MPILayer>::Type mpiLayer;
+    std::vector<Region<2> > regions;
+    Region<2> boundingRegion;
+    CoordBox<2> boundingBox;
+    int dest;
+    int source;
+};
+
+}
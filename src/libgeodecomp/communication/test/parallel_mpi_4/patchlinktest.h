@@ -54,6 +54,56 @@ public:
     std::vector<int> cargo;
 };
 
+/**
+ * Test model with a fat, MPI-mappable cell
+ */
+class MyFatCell
+{
+public:
+    class API :
+        public APITraits::HasOpaqueMPIDataType<MyFatCell>,
+        public APITraits::HasInPlaceHaloExchange
+    {};
+
+    explicit MyFatCell(double value = 0) :
+        tag(-1)
+    {
+        std::fill(values, values + 8, value);
+    }
+
+    template<typename NEIGHBORHOOD>
+    void update(const NEIGHBORHOOD& hood, int nanoStep)
+    {
+    }
+
+    double values[8];
+    int tag;
+};
+
+/**
+ * Test model with lossy halo compression
+ */
+class MyCompressedCell
+{
+public:
+    class API :
+        public APITraits::HasOpaqueMPIDataType<MyCompressedCell>,
+        public APITraits::HasHaloCompression<30>
+    {};
+
+    explicit MyCompressedCell(double value = 0)
+    {
+        std::fill(values, values + 4, value);
+    }
+
+    template<typename NEIGHBORHOOD>
+    void update(const NEIGHBORHOOD& hood, int nanoStep)
+    {
+    }
+
+    double values[4];
+};
+
 class PatchLinkTest : public CxxTest::TestSuite
 {
 public:
@@ -239,6 +289,113 @@ public:
         }
     }
 
+    void testResetRegion()
+    {
+        int dest = (mpiLayer->rank() + 1) % mpiLayer->size();
+        int source = (mpiLayer->rank() + mpiLayer->size() - 1) % mpiLayer->size();
+
+        PatchAccepterType accepter(region1, dest, tag, MPI_INT);
+        PatchProviderType provider(region1, source, tag, MPI_INT);
+
+        for (int pass = 0; pass < 2; ++pass) {
+            Region<2>& region = pass ? region2 : region1;
+            std::size_t begin = pass * 10;
+            std::size_t end = begin + 10;
+
+            // persistent requests need to be rebuilt for the new
+            // region's buffer:
+            accepter.resetRegion(region);
+            provider.resetRegion(region);
+            accepter.charge(begin, end, 1);
+            provider.charge(begin, end, 1);
+            TS_ASSERT_THROWS(provider.resetRegion(region), std::logic_error&);
+
+            for (std::size_t nanoStep = begin; nanoStep < end; ++nanoStep) {
+                GridType mySendGrid = markGrid(region, mpiLayer->rank() * 10000 + nanoStep * 100);
+                accepter.put(mySendGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+                GridType expected = markGrid(region, source * 10000 + nanoStep * 100);
+                GridType actual = zeroGrid;
+                provider.get(&actual, boundingRegion, boundingBox.dimensions, nanoStep, source);
+                TS_ASSERT_EQUALS(actual, expected);
+            }
+        }
+    }
+
+    void testInPlace()
+    {
+        typedef DisplacedGrid<MyFatCell, Topologies::Torus<2>::Topology, true> GridType5;
+        int dest = (mpiLayer->rank() + 1) % mpiLayer->size();
+        int source = (mpiLayer->rank() + mpiLayer->size() - 1) % mpiLayer->size();
+
+        GridType5 sendGrid(boundingBox);
+        GridType5 recvGrid(boundingBox);
+
+        PatchLink<GridType5>::Accepter accepter(region2, dest, tag, APITraits::SelectMPIDataType<MyFatCell>::value());
+        PatchLink<GridType5>::Provider provider(region2, source, tag, APITraits::SelectMPIDataType<MyFatCell>::value());
+        accepter.charge(0, 5, 1);
+        provider.charge(0, 5, 1);
+
+        for (std::size_t nanoStep = 0; nanoStep < 5; ++nanoStep) {
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                MyFatCell cell(i->x() + i->y() * 10 + nanoStep * 100);
+                cell.tag = mpiLayer->rank();
+                sendGrid[*i] = cell;
+            }
+            accepter.put(sendGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+            // the grid may be modified right after put():
+            sendGrid[Coord<2>(0, 0)] = MyFatCell(-1);
+            recvGrid = GridType5(boundingBox);
+            provider.get(&recvGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                MyFatCell cell = recvGrid[*i];
+                if (region2.count(*i)) {
+                    TS_ASSERT_EQUALS(cell.tag, source);
+                    TS_ASSERT_EQUALS(cell.values[7], double(i->x() + i->y() * 10 + nanoStep * 100));
+                } else {
+                    TS_ASSERT_EQUALS(cell.tag, -1);
+                    TS_ASSERT_EQUALS(cell.values[0], 0);
+                }
+            }
+        }
+    }
+
+    void testCompression()
+    {
+        typedef DisplacedGrid<MyCompressedCell> GridType6;
+        int dest = (mpiLayer->rank() + 1) % mpiLayer->size();
+        int source = (mpiLayer->rank() + mpiLayer->size() - 1) % mpiLayer->size();
+        MPI_Datatype datatype = APITraits::SelectMPIDataType<MyCompressedCell>::value();
+
+        PatchLink<GridType6>::Accepter accepter(region2, dest, tag, datatype);
+        PatchLink<GridType6>::Provider provider(region2, source, tag, datatype);
+        accepter.charge(0, 5, 1);
+        provider.charge(0, 5, 1);
+
+        for (std::size_t nanoStep = 0; nanoStep < 5; ++nanoStep) {
+            GridType6 sendGrid(boundingBox);
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                sendGrid[*i] = MyCompressedCell(value(*i, nanoStep, mpiLayer->rank()));
+            }
+            accepter.put(sendGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+            GridType6 recvGrid(boundingBox, MyCompressedCell(-1));
+            provider.get(&recvGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                double expected = -1;
+                double delta = 0;
+                if (region2.count(*i)) {
+                    expected = value(*i, nanoStep, source);
+                    delta = expected * std::pow(2.0, -31);
+                }
+                TS_ASSERT_DELTA(expected, recvGrid[*i].values[3], delta);
+            }
+        }
+    }
+
     void testSoA()
     {
         Coord<3> dim(30, 20, 10);
@@ -386,6 +543,53 @@ public:
 #endif
     }
 
+    void testProgress()
+    {
+#ifdef LIBGEODECOMP_WITH_BOOST_SERIALIZATION
+        Coord<2> dim(30, 20);
+        CoordBox<2> box(Coord<2>(), dim);
+        Region<2> boxRegion;
+        boxRegion << box;
+        Region<2> region;
+        region << Streak<2>(Coord<2>(0, 1), dim.x());
+
+        int dest = (mpiLayer->rank() + 1) % mpiLayer->size();
+        int source = (mpiLayer->rank() + mpiLayer->size() - 1) % mpiLayer->size();
+
+        GridType3 sendGrid(box);
+        GridType3 recvGrid(box);
+
+        PatchLink<GridType3>::Accepter accepter(region, dest, 2702, MPI_CHAR);
+        PatchLink<GridType3>::Provider provider(region, source, 2702, MPI_CHAR);
+        accepter.charge(0, 10, 1);
+        provider.charge(0, 10, 1);
+
+        for (int t = 0; t < 10; ++t) {
+            for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+                MyComplicatedCell cell;
+                cell.cargo = std::vector<int>(t + 1, mpiLayer->rank());
+                cell.x = i->x();
+                sendGrid.set(*i, cell);
+            }
+            accepter.put(sendGrid, boxRegion, dim, t, mpiLayer->rank());
+
+            // the transmission needs to complete without the
+            // receiver blocking in get():
+            while (!accepter.test()) {
+                provider.progress();
+            }
+            provider.progress();
+
+            provider.get(&recvGrid, boxRegion, dim, t, mpiLayer->rank());
+            for (Region<2>::Iterator i = region.begin(); i != region.end(); ++i) {
+                MyComplicatedCell cell = recvGrid.get(*i);
+                TS_ASSERT_EQUALS(cell.cargo, std::vector<int>(t + 1, source));
+                TS_ASSERT_EQUALS(cell.x, i->x());
+            }
+        }
+#endif
+    }
+
     void testBoostSerialization2()
     {
 #ifdef LIBGEODECOMP_WITH_BOOST_SERIALIZATION
@@ -505,6 +709,11 @@ public:
     }
 
 private:
+    double value(const Coord<2>& c, std::size_t nanoStep, int rank)
+    {
+        return 1.0 / 3.0 + c.x() + c.y() * 10 + nanoStep * 100 + rank * 1000;
+    }
+
     int tag;
 
     GridType zeroGrid;
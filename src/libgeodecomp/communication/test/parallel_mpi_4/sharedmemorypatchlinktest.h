@@ -0,0 +1,149 @@
+#include <cxxtest/TestSuite.h>
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/sharedmemorypatchlink.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+/**
+ * Test model which may be copied Streak-wise
+ */
+class SharedMemoryTestCell
+{
+public:
+    class API :
+        public APITraits::HasOpaqueMPIDataType<SharedMemoryTestCell>,
+        public APITraits::HasInPlaceHaloExchange
+    {};
+
+    explicit SharedMemoryTestCell(double value = 0, int tag = -1) :
+        value(value),
+        tag(tag)
+    {}
+
+    double value;
+    int tag;
+};
+
+class SharedMemoryPatchLinkTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        mpiLayer.reset(new MPILayer());
+
+        region.clear();
+        region << Streak<2>(Coord<2>(0, 0), 6);
+        region << Streak<2>(Coord<2>(4, 1), 5);
+        region << Streak<2>(Coord<2>(1, 4), 3);
+
+        boundingBox = CoordBox<2>(Coord<2>(0, 0), Coord<2>(7, 5));
+        boundingRegion.clear();
+        boundingRegion << boundingBox;
+
+        dest   = (mpiLayer->rank() + 1) % mpiLayer->size();
+        source = (mpiLayer->rank() + mpiLayer->size() - 1) % mpiLayer->size();
+    }
+
+    void tearDown()
+    {
+        mpiLayer.reset();
+    }
+
+    void testBuffered()
+    {
+#if MPI_VERSION >= 3
+        typedef DisplacedGrid<double> GridType;
+        typedef SharedMemoryPatchLink<GridType> LinkType;
+
+        LinkType::WindowPtr window(new LinkType::Window());
+        TS_ASSERT(window->isNodeLocal(dest));
+        TS_ASSERT(window->isNodeLocal(source));
+
+        LinkType::Accepter accepter(region, dest, MPI_DOUBLE, window);
+        LinkType::Provider provider(region, source, MPI_DOUBLE, window);
+        window->commit();
+
+        accepter.charge(0, 8, 1);
+        provider.charge(0, 8, 1);
+
+        for (std::size_t nanoStep = 0; nanoStep < 8; ++nanoStep) {
+            GridType sendGrid(boundingBox, -1);
+            GridType recvGrid(boundingBox, -1);
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                sendGrid[*i] = mpiLayer->rank() * 1000 + nanoStep * 100 + i->y() * 10 + i->x();
+            }
+
+            accepter.put(sendGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+            provider.get(&recvGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                double expected = -1;
+                if (region.count(*i)) {
+                    expected = source * 1000 + nanoStep * 100 + i->y() * 10 + i->x();
+                }
+                TS_ASSERT_EQUALS(expected, recvGrid[*i]);
+            }
+        }
+
+        accepter.cleanup();
+        provider.cleanup();
+#endif
+    }
+
+    void testInPlace()
+    {
+#if MPI_VERSION >= 3
+        typedef DisplacedGrid<SharedMemoryTestCell, Topologies::Torus<2>::Topology, true> GridType;
+        typedef SharedMemoryPatchLink<GridType> LinkType;
+        MPI_Datatype datatype = APITraits::SelectMPIDataType<SharedMemoryTestCell>::value();
+
+        LinkType::WindowPtr window(new LinkType::Window());
+        LinkType::Accepter accepter(region, dest, datatype, window);
+        LinkType::Provider provider(region, source, datatype, window);
+        window->commit();
+
+        accepter.charge(0, 8, 2);
+        provider.charge(0, 8, 2);
+
+        GridType sendGrid(boundingBox);
+        for (std::size_t nanoStep = 0; nanoStep < 8; nanoStep += 2) {
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                sendGrid[*i] = SharedMemoryTestCell(nanoStep * 100 + i->y() * 10 + i->x(), mpiLayer->rank());
+            }
+            accepter.put(sendGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+            // the grid may be modified right after put():
+            sendGrid[Coord<2>(0, 0)] = SharedMemoryTestCell(-1);
+
+            GridType recvGrid(boundingBox);
+            provider.get(&recvGrid, boundingRegion, boundingBox.dimensions, nanoStep, mpiLayer->rank());
+
+            for (CoordBox<2>::Iterator i = boundingBox.begin(); i != boundingBox.end(); ++i) {
+                SharedMemoryTestCell cell = recvGrid[*i];
+                if (region.count(*i)) {
+                    TS_ASSERT_EQUALS(source, cell.tag);
+                    TS_ASSERT_EQUALS(double(nanoStep * 100 + i->y() * 10 + i->x()), cell.value);
+                } else {
+                    TS_ASSERT_EQUALS(-1, cell.tag);
+                }
+            }
+        }
+#endif
+    }
+
+private:
+    SharedPtr<MPILayer>::Type mpiLayer;
+    Region<2> region;
+    Region<2> boundingRegion;
+    CoordBox<2> boundingBox;
+    int dest;
+    int source;
+};
+
+}
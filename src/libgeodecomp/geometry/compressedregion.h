@@ -0,0 +1,1124 @@
+#ifndef LIBGEODECOMP_GEOMETRY_COMPRESSEDREGION_H
+#define LIBGEODECOMP_GEOMETRY_COMPRESSEDREGION_H
+
+#include <libgeodecomp/geometry/coordbox.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/regionstreakiterator.h>
+#include <libgeodecomp/geometry/streak.h>
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace CompressedRegionHelpers {
+
+/**
+ * A run of consecutive index pairs whose components both form
+ * arithmetic progressions, i.e. the k-th element of the run equals
+ * (origin.first + k * delta.first, origin.second + k * delta.second).
+ * Dense, box-like Regions consist of very few of these runs.
+ */
+class IndexRun
+{
+public:
+    typedef std::pair<int, int> IntPair;
+
+    inline explicit IndexRun(
+        const IntPair& origin = IntPair(),
+        std::size_t start = 0) :
+        origin(origin),
+        delta(0, 0),
+        length(1),
+        start(start)
+    {}
+
+    inline IntPair operator[](std::size_t k) const
+    {
+        return IntPair(
+            origin.first  + int(k) * delta.first,
+            origin.second + int(k) * delta.second);
+    }
+
+    inline std::size_t end() const
+    {
+        return start + length;
+    }
+
+    inline bool operator==(const IndexRun& other) const
+    {
+        return
+            (origin == other.origin) &&
+            (delta  == other.delta) &&
+            (length == other.length);
+    }
+
+    inline bool operator!=(const IndexRun& other) const
+    {
+        return !(*this == other);
+    }
+
+    IntPair origin;
+    IntPair delta;
+    std::size_t length;
+    // index of the run's first element within the whole vector:
+    std::size_t start;
+};
+
+/**
+ * Stores a sequence of index pairs (as used by Region to store its
+ * coordinates hierarchically) as a list of IndexRuns. Supports
+ * appending/removing elements at the end only, but offers random
+ * access iterators so that Region's streak iteration helpers can work
+ * directly on the compressed form.
+ */
+class RunLengthIndexVector
+{
+public:
+    typedef std::pair<int, int> IntPair;
+    typedef std::vector<IndexRun> RunVector;
+
+    /**
+     * Random access iterator which caches the element it points to
+     * as well as the run said element is stored in. Thus sequential
+     * traversal is O(1) per step, random jumps run in O(log n), with n
+     * being the number of runs.
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef IntPair value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const IntPair *pointer;
+        typedef const IntPair& reference;
+
+        inline explicit const_iterator(
+            const RunLengthIndexVector *vector = 0,
+            std::size_t index = 0) :
+            vector(vector),
+            index(index),
+            run(0)
+        {
+            if (vector) {
+                seek();
+            }
+        }
+
+        inline const IntPair& operator*() const
+        {
+            return value;
+        }
+
+        inline const IntPair *operator->() const
+        {
+            return &value;
+        }
+
+        inline const_iterator& operator++()
+        {
+            ++index;
+            if (index >= vector->runs[run].end()) {
+                ++run;
+            }
+            update();
+            return *this;
+        }
+
+        inline const_iterator operator++(int)
+        {
+            const_iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        inline const_iterator& operator--()
+        {
+            if ((run == vector->runs.size()) || (index == vector->runs[run].start)) {
+                --run;
+            }
+            --index;
+            update();
+            return *this;
+        }
+
+        inline const_iterator operator--(int)
+        {
+            const_iterator ret = *this;
+            --*this;
+            return ret;
+        }
+
+        inline const_iterator& operator+=(std::ptrdiff_t delta)
+        {
+            if (delta == 1) {
+                return ++*this;
+            }
+            if (delta == -1) {
+                return --*this;
+            }
+
+            index = std::size_t(std::ptrdiff_t(index) + delta);
+            if ((run < vector->runs.size()) &&
+                (vector->runs[run].start <= index) &&
+                (index < vector->runs[run].end())) {
+                update();
+            } else {
+                seek();
+            }
+
+            return *this;
+        }
+
+        inline const_iterator& operator-=(std::ptrdiff_t delta)
+        {
+            return *this += -delta;
+        }
+
+        inline const_iterator operator+(std::ptrdiff_t delta) const
+        {
+            const_iterator ret = *this;
+            ret += delta;
+            return ret;
+        }
+
+        inline const_iterator operator-(std::ptrdiff_t delta) const
+        {
+            const_iterator ret = *this;
+            ret -= delta;
+            return ret;
+        }
+
+        inline std::ptrdiff_t operator-(const const_iterator& other) const
+        {
+            return std::ptrdiff_t(index) - std::ptrdiff_t(other.index);
+        }
+
+        inline bool operator==(const const_iterator& other) const
+        {
+            return index == other.index;
+        }
+
+        inline bool operator!=(const const_iterator& other) const
+        {
+            return index != other.index;
+        }
+
+        inline bool operator<(const const_iterator& other) const
+        {
+            return index < other.index;
+        }
+
+        inline bool operator>(const const_iterator& other) const
+        {
+            return index > other.index;
+        }
+
+        inline bool operator<=(const const_iterator& other) const
+        {
+            return index <= other.index;
+        }
+
+        inline bool operator>=(const const_iterator& other) const
+        {
+            return index >= other.index;
+        }
+
+    private:
+        const RunLengthIndexVector *vector;
+        std::size_t index;
+        std::size_t run;
+        IntPair value;
+
+        inline void seek()
+        {
+            run = vector->findRun(index);
+            update();
+        }
+
+        inline void update()
+        {
+            if (run < vector->runs.size()) {
+                const IndexRun& current = vector->runs[run];
+                value = current[index - current.start];
+            }
+        }
+    };
+
+    inline RunLengthIndexVector() :
+        mySize(0)
+    {}
+
+    inline std::size_t size() const
+    {
+        return mySize;
+    }
+
+    inline bool empty() const
+    {
+        return mySize == 0;
+    }
+
+    inline std::size_t numRuns() const
+    {
+        return runs.size();
+    }
+
+    inline void clear()
+    {
+        runs.clear();
+        mySize = 0;
+    }
+
+    inline IntPair operator[](std::size_t index) const
+    {
+        const IndexRun& run = runs[findRun(index)];
+        return run[index - run.start];
+    }
+
+    inline IntPair back() const
+    {
+        const IndexRun& run = runs.back();
+        return run[run.length - 1];
+    }
+
+    inline void push_back(const IntPair& pair)
+    {
+        if (runs.empty()) {
+            runs.push_back(IndexRun(pair, mySize));
+            ++mySize;
+            return;
+        }
+
+        IndexRun& last = runs.back();
+        if (last.length == 1) {
+            last.delta = IntPair(
+                pair.first  - last.origin.first,
+                pair.second - last.origin.second);
+            ++last.length;
+        } else if (last[last.length] == pair) {
+            ++last.length;
+        } else {
+            runs.push_back(IndexRun(pair, mySize));
+        }
+
+        ++mySize;
+    }
+
+    /**
+     * Appends length elements, starting at origin and progressing by
+     * delta. Equivalent to length calls of push_back(), but runs in
+     * O(1).
+     */
+    inline void pushRun(const IntPair& origin, const IntPair& delta, std::size_t length)
+    {
+        std::size_t k = 0;
+        // we need to push elements individually until the last run
+        // has taken up on our stride, otherwise the encoding would
+        // differ from the one push_back() yields:
+        for (; k < length; ++k) {
+            if ((k > 0) && (runs.back().length > 1) && (runs.back().delta == delta)) {
+                break;
+            }
+
+            push_back(IntPair(
+                          origin.first  + int(k) * delta.first,
+                          origin.second + int(k) * delta.second));
+        }
+
+        runs.back().length += length - k;
+        mySize += length - k;
+    }
+
+    inline void pop_back()
+    {
+        IndexRun& last = runs.back();
+        if (last.length == 1) {
+            runs.pop_back();
+        } else {
+            --last.length;
+            // keep encoding canonical so that operator== stays valid:
+            if (last.length == 1) {
+                last.delta = IntPair(0, 0);
+            }
+        }
+
+        --mySize;
+    }
+
+    inline const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    inline const_iterator end() const
+    {
+        return const_iterator(this, mySize);
+    }
+
+    inline bool operator==(const RunLengthIndexVector& other) const
+    {
+        return (mySize == other.mySize) && (runs == other.runs);
+    }
+
+    inline bool operator!=(const RunLengthIndexVector& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    RunVector runs;
+    std::size_t mySize;
+
+    /**
+     * Returns the index of the run containing the element at the
+     * given position or runs.size() for out-of-bounds positions.
+     */
+    inline std::size_t findRun(std::size_t index) const
+    {
+        if (index >= mySize) {
+            return runs.size();
+        }
+        if (index == 0) {
+            return 0;
+        }
+
+        RunVector::const_iterator i = std::upper_bound(
+            runs.begin(),
+            runs.end(),
+            index,
+            compareStart);
+
+        return std::size_t(i - runs.begin()) - 1;
+    }
+
+    static inline bool compareStart(std::size_t index, const IndexRun& run)
+    {
+        return index < run.start;
+    }
+};
+
+}
+
+/**
+ * CompressedRegion is an alternative storage backend for the
+ * coordinate sets described by Region. It uses the same hierarchical
+ * indices, but stores each index vector run-length encoded (see
+ * RunLengthIndexVector). For dense, box-like Regions this reduces
+ * the memory footprint from O(number of Streaks) to roughly
+ * O(number of planes), e.g. a 2048^3 box shrinks from > 64 MB to
+ * some KB.
+ *
+ * Streaks have to be added in order (as yielded by
+ * Region::beginStreak()), which is what all set operations produce
+ * anyway. Set algebra, expansion and streak iteration work directly
+ * on the compressed indices; use toRegion() to obtain a mutable
+ * Region.
+ */
+template<int DIMENSIONS>
+class CompressedRegion
+{
+public:
+    static const int DIM = DIMENSIONS;
+
+    typedef std::pair<int, int> IntPair;
+    typedef CompressedRegionHelpers::RunLengthIndexVector IndexVectorType;
+    typedef RegionStreakIterator<DIM, CompressedRegion<DIM>, IndexVectorType::const_iterator> StreakIterator;
+
+    inline CompressedRegion() :
+        mySize(0)
+    {}
+
+    /**
+     * Creates the CompressedRegion directly from the box' extents,
+     * which runs in O(number of planes), not O(number of Streaks).
+     */
+    explicit inline CompressedRegion(const CoordBox<DIM>& box) :
+        mySize(0)
+    {
+        for (int d = 0; d < DIM; ++d) {
+            if (box.dimensions[d] <= 0) {
+                return;
+            }
+        }
+
+        // number of entries in the index vector above the current one:
+        std::size_t parents = 1;
+        for (int d = DIM - 1; d > 0; --d) {
+            int children = (d > 1) ? box.dimensions[d - 1] : 1;
+            for (std::size_t p = 0; p < parents; ++p) {
+                indices[d].pushRun(
+                    IntPair(box.origin[d], int(p) * box.dimensions[d] * children),
+                    IntPair(1, children),
+                    std::size_t(box.dimensions[d]));
+            }
+
+            parents *= std::size_t(box.dimensions[d]);
+        }
+
+        indices[0].pushRun(
+            IntPair(box.origin.x(), box.origin.x() + box.dimensions.x()),
+            IntPair(0, 0),
+            parents);
+
+        myBoundingBox = box;
+        mySize = volume(box);
+    }
+
+    explicit inline CompressedRegion(const Region<DIM>& region) :
+        mySize(0)
+    {
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak();
+             i != region.endStreak();
+             ++i) {
+            *this << *i;
+        }
+    }
+
+    inline Region<DIM> toRegion() const
+    {
+        Region<DIM> ret;
+        for (StreakIterator i = beginStreak(); i != endStreak(); ++i) {
+            ret << *i;
+        }
+
+        return ret;
+    }
+
+    inline void clear()
+    {
+        for (int i = 0; i < DIM; ++i) {
+            indices[i].clear();
+        }
+        mySize = 0;
+        myBoundingBox = CoordBox<DIM>();
+    }
+
+    inline const CoordBox<DIM>& boundingBox() const
+    {
+        return myBoundingBox;
+    }
+
+    /**
+     * Number of coordinates stored in this CompressedRegion.
+     */
+    inline std::size_t size() const
+    {
+        return mySize;
+    }
+
+    inline const Coord<DIM>& dimension() const
+    {
+        return myBoundingBox.dimensions;
+    }
+
+    inline std::size_t numStreaks() const
+    {
+        return indices[0].size();
+    }
+
+    inline std::size_t numPlanes() const
+    {
+        return indices[DIM - 1].size();
+    }
+
+    /**
+     * Total number of runs in all index vectors, proportional to the
+     * actual memory footprint of this object.
+     */
+    inline std::size_t numRuns() const
+    {
+        std::size_t ret = 0;
+        for (int i = 0; i < DIM; ++i) {
+            ret += indices[i].numRuns();
+        }
+
+        return ret;
+    }
+
+    inline bool empty() const
+    {
+        return indices[0].empty();
+    }
+
+    /**
+     * Returns true if this CompressedRegion is completely described
+     * by its bounding box.
+     */
+    inline bool isBox() const
+    {
+        return !empty() && (size() == volume(myBoundingBox));
+    }
+
+    inline bool operator==(const CompressedRegion& other) const
+    {
+        for (int i = 0; i < DIM; ++i) {
+            if (indices[i] != other.indices[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline bool operator!=(const CompressedRegion& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool count(const Coord<DIM>& c) const
+    {
+        return count(Streak<DIM>(c, c.x() + 1));
+    }
+
+    /**
+     * Checks whether the CompressedRegion includes the given Streak.
+     */
+    bool count(const Streak<DIM>& s) const
+    {
+        if (empty()) {
+            return false;
+        }
+
+        std::size_t start = 0;
+        std::size_t end = indices[DIM - 1].size();
+
+        for (int d = DIM - 1; d > 0; --d) {
+            IndexVectorType::const_iterator begin = indices[d].begin() + std::ptrdiff_t(start);
+            IndexVectorType::const_iterator i = RegionHelpers::upperBound(
+                begin,
+                indices[d].begin() + std::ptrdiff_t(end),
+                IntPair(s.origin[d], 0),
+                RegionHelpers::RegionCommonHelper::pairCompareFirst);
+
+            if (i == begin) {
+                return false;
+            }
+
+            IndexVectorType::const_iterator entry = i - 1;
+            if (entry->first != s.origin[d]) {
+                return false;
+            }
+
+            start = std::size_t(entry->second);
+            end = indices[d - 1].size();
+            if (i != indices[d].end()) {
+                end = std::size_t(i->second);
+            }
+        }
+
+        IndexVectorType::const_iterator begin = indices[0].begin() + std::ptrdiff_t(start);
+        IndexVectorType::const_iterator i = RegionHelpers::upperBound(
+            begin,
+            indices[0].begin() + std::ptrdiff_t(end),
+            IntPair(s.origin.x(), 0),
+            RegionHelpers::RegionCommonHelper::pairCompareFirst);
+
+        if (i == begin) {
+            return false;
+        }
+
+        --i;
+        return (i->first <= s.origin.x()) && (i->second >= s.endX);
+    }
+
+    /**
+     * Appends the Streak to this CompressedRegion. The Streak may
+     * overlap with or touch previously added Streaks of the same row
+     * (they'll be fused), but it must not precede them.
+     */
+    inline CompressedRegion& operator<<(const Streak<DIM>& s)
+    {
+        if (s.endX <= s.origin.x()) {
+            return *this;
+        }
+
+        if (empty()) {
+            appendRows(s, DIM - 1);
+            return *this;
+        }
+
+        for (int d = DIM - 1; d > 0; --d) {
+            int last = indices[d].back().first;
+            if (s.origin[d] < last) {
+                throw std::logic_error("Streaks need to be added to CompressedRegion in order");
+            }
+            if (s.origin[d] > last) {
+                appendRows(s, d);
+                return *this;
+            }
+        }
+
+        appendToLastRow(s);
+        return *this;
+    }
+
+    inline CompressedRegion& operator<<(const Coord<DIM>& c)
+    {
+        return *this << Streak<DIM>(c, c.x() + 1);
+    }
+
+    /**
+     * Computes the intersection of both regions.
+     */
+    inline CompressedRegion operator&(const CompressedRegion& other) const
+    {
+        using std::max;
+        using std::min;
+        if (isBox() && other.isBox()) {
+            return CompressedRegion(boxIntersection(myBoundingBox, other.myBoundingBox));
+        }
+
+        CompressedRegion ret;
+        StreakIterator myIter = beginStreak();
+        StreakIterator otherIter = other.beginStreak();
+
+        StreakIterator myEnd = endStreak();
+        StreakIterator otherEnd = other.endStreak();
+
+        for (;;) {
+            if ((myIter == myEnd) ||
+                (otherIter == otherEnd)) {
+                break;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::intersects(*myIter, *otherIter)) {
+                Streak<DIM> intersection = *myIter;
+                intersection.origin.x() = (max)(myIter->origin.x(), otherIter->origin.x());
+                intersection.endX = (min)(myIter->endX, otherIter->endX);
+                ret << intersection;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*myIter, *otherIter)) {
+                ++myIter;
+            } else {
+                ++otherIter;
+            }
+        }
+
+        return ret;
+    }
+
+    inline void operator&=(const CompressedRegion& other)
+    {
+        CompressedRegion intersection = *this & other;
+        swap(intersection);
+    }
+
+    /**
+     * Equvalent to (A and (not B)) in sets, where other corresponds
+     * to B and *this corresponds to A.
+     */
+    inline CompressedRegion operator-(const CompressedRegion& other) const
+    {
+        using std::max;
+        using std::min;
+        CompressedRegion ret;
+        if (empty()) {
+            return ret;
+        }
+        if (other.empty()) {
+            return *this;
+        }
+
+        StreakIterator myIter = beginStreak();
+        StreakIterator otherIter = other.beginStreak();
+
+        StreakIterator myEnd = endStreak();
+        StreakIterator otherEnd = other.endStreak();
+
+        Streak<DIM> cursor = *myIter;
+
+        for (;;) {
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::intersects(cursor, *otherIter)) {
+                int intersectionOriginX = (max)(cursor.origin.x(), otherIter->origin.x());
+                int intersectionEndX = (min)(cursor.endX, otherIter->endX);
+
+                ret << Streak<DIM>(cursor.origin, intersectionOriginX);
+                cursor.origin.x() = intersectionEndX;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(cursor, *otherIter)) {
+                ret << cursor;
+                ++myIter;
+
+                if (myIter == myEnd) {
+                    break;
+                } else {
+                    cursor = *myIter;
+                }
+            } else {
+                ++otherIter;
+                if (otherIter == otherEnd) {
+                    break;
+                }
+            }
+        }
+
+        // don't loose the remainder
+        ret << cursor;
+        if (myIter != myEnd) {
+            ++myIter;
+            for (; myIter != myEnd; ++myIter) {
+                ret << *myIter;
+            }
+        }
+
+        return ret;
+    }
+
+    inline void operator-=(const CompressedRegion& other)
+    {
+        CompressedRegion difference = *this - other;
+        swap(difference);
+    }
+
+    inline CompressedRegion operator+(const CompressedRegion& other) const
+    {
+        if (other.empty()) {
+            return *this;
+        }
+        if (empty()) {
+            return other;
+        }
+
+        CompressedRegion ret;
+        merge2way(
+            &ret,
+            beginStreak(), endStreak(),
+            other.beginStreak(), other.endStreak());
+
+        return ret;
+    }
+
+    inline void operator+=(const CompressedRegion& other)
+    {
+        CompressedRegion sum = *this + other;
+        swap(sum);
+    }
+
+    /**
+     * See Region::expand()
+     */
+    inline CompressedRegion expand(unsigned width = 1) const
+    {
+        return expand(Coord<DIM>::diagonal(int(width)));
+    }
+
+    /**
+     * Expands the region in each dimension d by radii[d] cells,
+     * equivalent to Region::expand(), but without ever decompressing
+     * the indices.
+     */
+    inline CompressedRegion expand(const Coord<DIM>& radii) const
+    {
+        // short cut for dense Regions:
+        if (isBox()) {
+            return CompressedRegion(CoordBox<DIM>(
+                                        myBoundingBox.origin - radii,
+                                        myBoundingBox.dimensions + radii * 2));
+        }
+
+        CompressedRegion accumulator;
+        CompressedRegion buffer;
+
+        Coord<DIM> xOffset;
+        xOffset[0] = -radii[0];
+
+        StreakIterator end = endStreak(xOffset, radii[0] * 2);
+        for (StreakIterator i = beginStreak(xOffset, radii[0] * 2); i != end; ++i) {
+            accumulator << *i;
+        }
+
+        for (int d = 1; d < DIM; ++d) {
+            expandInOneDimension(d, radii[d], accumulator, buffer);
+        }
+
+        return accumulator;
+    }
+
+    inline StreakIterator beginStreak(const Coord<DIM>& offset = Coord<DIM>(), int additionalLength = 0) const
+    {
+        return StreakIterator(this, RegionHelpers::StreakIteratorInitBegin<DIM - 1>(), offset, additionalLength);
+    }
+
+    inline StreakIterator endStreak(const Coord<DIM>& offset = Coord<DIM>(), int additionalLength = 0) const
+    {
+        return StreakIterator(this, RegionHelpers::StreakIteratorInitEnd<DIM - 1>(), offset, additionalLength);
+    }
+
+    inline std::size_t indicesSize(std::size_t dim) const
+    {
+        return indices[dim].size();
+    }
+
+    inline IndexVectorType::const_iterator indicesAt(std::size_t dim, std::size_t offset) const
+    {
+        return indices[dim].begin() + std::ptrdiff_t(offset);
+    }
+
+    inline IndexVectorType::const_iterator indicesBegin(std::size_t dim) const
+    {
+        return indices[dim].begin();
+    }
+
+    inline IndexVectorType::const_iterator indicesEnd(std::size_t dim) const
+    {
+        return indices[dim].end();
+    }
+
+    inline std::vector<Streak<DIM> > toVector() const
+    {
+        return std::vector<Streak<DIM> >(beginStreak(), endStreak());
+    }
+
+    inline std::string toString() const
+    {
+        std::ostringstream buf;
+        buf << "CompressedRegion<" << DIM << ">(\n";
+        for (StreakIterator i = beginStreak(); i != endStreak(); ++i) {
+            buf << "  " << *i << "\n";
+        }
+        buf << ")\n";
+
+        return buf.str();
+    }
+
+    inline void swap(CompressedRegion& other)
+    {
+        using std::swap;
+        for (int i = 0; i < DIM; ++i) {
+            swap(indices[i], other.indices[i]);
+        }
+        swap(myBoundingBox, other.myBoundingBox);
+        swap(mySize, other.mySize);
+    }
+
+private:
+    IndexVectorType indices[DIM];
+    CoordBox<DIM> myBoundingBox;
+    std::size_t mySize;
+
+    /**
+     * Opens new entries in all index vectors from dimension dim
+     * downwards and stores the Streak there.
+     */
+    inline void appendRows(const Streak<DIM>& s, int dim)
+    {
+        for (int d = dim; d > 0; --d) {
+            indices[d].push_back(IntPair(s.origin[d], int(indices[d - 1].size())));
+        }
+        indices[0].push_back(IntPair(s.origin.x(), s.endX));
+        updateGeometry(s);
+    }
+
+    inline void appendToLastRow(const Streak<DIM>& s)
+    {
+        using std::max;
+        using std::min;
+
+        std::size_t rowStart = 0;
+        if (DIM > 1) {
+            rowStart = std::size_t(indices[1 % DIM].back().second);
+        }
+
+        IntPair streak(s.origin.x(), s.endX);
+        while (indices[0].size() > rowStart) {
+            IntPair last = indices[0].back();
+            if (last.second < streak.first) {
+                break;
+            }
+            if (streak.second < last.first) {
+                throw std::logic_error("Streaks need to be added to CompressedRegion in order");
+            }
+
+            streak = IntPair(
+                (min)(last.first,  streak.first),
+                (max)(last.second, streak.second));
+            mySize -= std::size_t(last.second - last.first);
+            indices[0].pop_back();
+        }
+
+        indices[0].push_back(streak);
+
+        Streak<DIM> fused = s;
+        fused.origin.x() = streak.first;
+        fused.endX = streak.second;
+        updateGeometry(fused);
+    }
+
+    /**
+     * CoordBox::size() would overflow for large boxes.
+     */
+    static inline std::size_t volume(const CoordBox<DIM>& box)
+    {
+        std::size_t ret = 1;
+        for (int d = 0; d < DIM; ++d) {
+            ret *= std::size_t(box.dimensions[d]);
+        }
+
+        return ret;
+    }
+
+    static inline CoordBox<DIM> boxIntersection(const CoordBox<DIM>& a, const CoordBox<DIM>& b)
+    {
+        Coord<DIM> origin = (a.origin.max)(b.origin);
+        Coord<DIM> end = ((a.origin + a.dimensions).min)(b.origin + b.dimensions);
+
+        return CoordBox<DIM>(origin, ((end - origin).max)(Coord<DIM>()));
+    }
+
+    inline void updateGeometry(const Streak<DIM>& s)
+    {
+        mySize += std::size_t(s.length());
+        Coord<DIM> right = s.origin;
+        right.x() = s.endX - 1;
+
+        if (mySize == std::size_t(s.length())) {
+            myBoundingBox = CoordBox<DIM>(s.origin, right - s.origin + Coord<DIM>::diagonal(1));
+            return;
+        }
+
+        Coord<DIM> minCoord = (myBoundingBox.origin.min)(s.origin);
+        Coord<DIM> maxCoord = myBoundingBox.origin + myBoundingBox.dimensions - Coord<DIM>::diagonal(1);
+        maxCoord = (maxCoord.max)(right);
+        myBoundingBox = CoordBox<DIM>(minCoord, maxCoord - minCoord + Coord<DIM>::diagonal(1));
+    }
+
+    static inline void merge2way(
+        CompressedRegion *ret,
+        StreakIterator iterA, const StreakIterator& endA,
+        StreakIterator iterB, const StreakIterator& endB)
+    {
+        for (;;) {
+            if (iterA == endA) {
+                for (; iterB != endB; ++iterB) {
+                    *ret << *iterB;
+                }
+                return;
+            }
+            if (iterB == endB) {
+                for (; iterA != endA; ++iterA) {
+                    *ret << *iterA;
+                }
+                return;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterA, *iterB)) {
+                *ret << *iterA;
+                ++iterA;
+            } else {
+                *ret << *iterB;
+                ++iterB;
+            }
+        }
+    }
+
+    static inline void merge3way(
+        CompressedRegion *ret,
+        StreakIterator iterA, const StreakIterator& endA,
+        StreakIterator iterB, const StreakIterator& endB,
+        StreakIterator iterC, const StreakIterator& endC)
+    {
+        for (;;) {
+            if (iterA == endA) {
+                merge2way(ret, iterB, endB, iterC, endC);
+                return;
+            }
+            if (iterB == endB) {
+                merge2way(ret, iterA, endA, iterC, endC);
+                return;
+            }
+            if (iterC == endC) {
+                merge2way(ret, iterA, endA, iterB, endB);
+                return;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterA, *iterB)) {
+                if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterA, *iterC)) {
+                    *ret << *iterA;
+                    ++iterA;
+                } else {
+                    *ret << *iterC;
+                    ++iterC;
+                }
+            } else {
+                if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterB, *iterC)) {
+                    *ret << *iterB;
+                    ++iterB;
+                } else {
+                    *ret << *iterC;
+                    ++iterC;
+                }
+            }
+        }
+    }
+
+    /**
+     * See Region::expandInOneDimension()
+     */
+    static inline void expandInOneDimension(
+        int dim,
+        int radius,
+        CompressedRegion& accumulator,
+        CompressedRegion& buffer)
+    {
+        int targetWidth = 2 * radius + 1;
+        int width = 1;
+
+        for (; width < ((targetWidth + 2) / 3); width *= 3) {
+            Coord<DIM> offset;
+            offset[dim] = width;
+            buffer.clear();
+
+            merge3way(
+                &buffer,
+                accumulator.beginStreak(-offset), accumulator.endStreak(-offset),
+                accumulator.beginStreak(),        accumulator.endStreak(),
+                accumulator.beginStreak(offset),  accumulator.endStreak(offset));
+            accumulator.swap(buffer);
+        }
+
+        if (width < targetWidth) {
+            Coord<DIM> finalOffset;
+            finalOffset[dim] = radius - width / 2;
+            buffer.clear();
+
+            if ((width * 2) < targetWidth) {
+                merge3way(
+                    &buffer,
+                    accumulator.beginStreak(-finalOffset), accumulator.endStreak(-finalOffset),
+                    accumulator.beginStreak(),             accumulator.endStreak(),
+                    accumulator.beginStreak(finalOffset),  accumulator.endStreak(finalOffset));
+            } else {
+                merge2way(
+                    &buffer,
+                    accumulator.beginStreak(-finalOffset), accumulator.endStreak(-finalOffset),
+                    accumulator.beginStreak(finalOffset),  accumulator.endStreak(finalOffset));
+            }
+            accumulator.swap(buffer);
+        }
+    }
+};
+
+template<int DIM>
+inline void swap(CompressedRegion<DIM>& regionA, CompressedRegion<DIM>& regionB)
+{
+    regionA.swap(regionB);
+}
+
+template<typename _CharT, typename _Traits, int _Dim>
+std::basic_ostream<_CharT, _Traits>&
+operator<<(std::basic_ostream<_CharT, _Traits>& __os,
+           const LibGeoDecomp::CompressedRegion<_Dim>& region)
+{
+    __os << region.toString();
+    return __os;
+}
+
+}
+
+#endif
@@ -0,0 +1,268 @@
+#ifndef LIBGEODECOMP_GEOMETRY_CSRADJACENCY_H
+#define LIBGEODECOMP_GEOMETRY_CSRADJACENCY_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/adjacency.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#include <omp.h>
+#endif
+
+namespace LibGeoDecomp {
+
+/**
+ * Stores the adjacency of a directed graph in compressed sparse row
+ * (CSR) format: the neighbors of node i are found at
+ * columns[rowOffsets[i]] to columns[rowOffsets[i + 1]], sorted in
+ * ascending order. Node IDs need to be non-negative.
+ *
+ * Compared to the RegionBasedAdjacency this trades the run-length
+ * compression for constant time lookups of a node's neighbor range
+ * and linear, multi-threaded bulk construction from an edge list.
+ * Storage complexity for a graph that comprises n nodes and a total
+ * of m edges: O(n * sizeof(std::size_t) + m * sizeof(int)).
+ *
+ * Ordered inserts via insert() (see RegionBasedAdjacency for the
+ * definition) take O(1), random order inserts are linear in the
+ * number of edges. Large graphs should be created via the bulk
+ * constructor instead.
+ */
+class CSRAdjacency : public Adjacency
+{
+public:
+    friend class CSRAdjacencyTest;
+
+    typedef std::pair<int, int> Edge;
+
+    /**
+     * Light-weight view on the neighbors of a single node.
+     */
+    class NeighborRange
+    {
+    public:
+        inline NeighborRange(const int *begin, const int *end) :
+            myBegin(begin),
+            myEnd(end)
+        {}
+
+        inline const int *begin() const
+        {
+            return myBegin;
+        }
+
+        inline const int *end() const
+        {
+            return myEnd;
+        }
+
+        inline std::size_t size() const
+        {
+            return std::size_t(myEnd - myBegin);
+        }
+
+        inline bool empty() const
+        {
+            return myBegin == myEnd;
+        }
+
+    private:
+        const int *myBegin;
+        const int *myEnd;
+    };
+
+    inline CSRAdjacency() :
+        rowOffsets(1, 0)
+    {}
+
+    /**
+     * Builds the adjacency from an unordered list of edges (from,
+     * to). numNodes needs to exceed all node IDs, duplicate edges
+     * will be removed. Uses all OpenMP threads if available.
+     */
+    inline CSRAdjacency(std::size_t numNodes, const std::vector<Edge>& edges)
+    {
+        build(numNodes, edges);
+    }
+
+    /**
+     * Insert a single edge (from, to) to the graph
+     */
+    void insert(int from, int to)
+    {
+        checkID(from);
+        checkID(to);
+
+        std::size_t node = std::size_t(from);
+        if (node + 1 >= rowOffsets.size()) {
+            rowOffsets.resize(node + 2, rowOffsets.back());
+        }
+
+        std::vector<int>::iterator rowBegin = columns.begin() + long(rowOffsets[node + 0]);
+        std::vector<int>::iterator rowEnd   = columns.begin() + long(rowOffsets[node + 1]);
+        std::vector<int>::iterator pos = std::lower_bound(rowBegin, rowEnd, to);
+        if ((pos != rowEnd) && (*pos == to)) {
+            return;
+        }
+
+        columns.insert(pos, to);
+        for (std::size_t i = node + 1; i < rowOffsets.size(); ++i) {
+            ++rowOffsets[i];
+        }
+    }
+
+    /**
+     * Returns all x \in V with (node, x) \in E.
+     */
+    void getNeighbors(int node, std::vector<int> *neighbors) const
+    {
+        NeighborRange range = (*this)[node];
+        neighbors->insert(neighbors->end(), range.begin(), range.end());
+    }
+
+    /**
+     * Returns all x \in V with (node, x) \in E without copying them.
+     * The range is invalidated by subsequent inserts.
+     */
+    inline NeighborRange operator[](int node) const
+    {
+        if ((node < 0) || (std::size_t(node) >= numNodes())) {
+            return NeighborRange(0, 0);
+        }
+
+        const int *base = columns.empty() ? 0 : &columns[0];
+        return NeighborRange(
+            base + rowOffsets[std::size_t(node) + 0],
+            base + rowOffsets[std::size_t(node) + 1]);
+    }
+
+    /**
+     * Retrieves the number of edges in the adjacency
+     */
+    std::size_t size() const
+    {
+        return columns.size();
+    }
+
+    /**
+     * Number of rows, i.e. 1 + the largest node ID for which edges
+     * may be stored.
+     */
+    inline std::size_t numNodes() const
+    {
+        return rowOffsets.size() - 1;
+    }
+
+    inline const std::vector<std::size_t>& getRowOffsets() const
+    {
+        return rowOffsets;
+    }
+
+    inline const std::vector<int>& getColumns() const
+    {
+        return columns;
+    }
+
+private:
+    std::vector<std::size_t> rowOffsets;
+    std::vector<int> columns;
+
+    static inline void checkID(int id)
+    {
+        if (id < 0) {
+            throw std::invalid_argument("CSRAdjacency requires non-negative node IDs");
+        }
+    }
+
+    /**
+     * Counting sort by source node: (1) histogram of the row lengths,
+     * (2) prefix sum, (3) scatter, (4) sort and deduplicate each row,
+     * (5) compact the rows. All but the prefix sums run in parallel.
+     */
+    void build(std::size_t numNodes, const std::vector<Edge>& edges)
+    {
+        long numEdges = long(edges.size());
+        long numRows = long(numNodes);
+        std::vector<std::size_t> counts(numNodes + 1, 0);
+
+        for (long i = 0; i < numEdges; ++i) {
+            if ((edges[std::size_t(i)].first  < 0) || (edges[std::size_t(i)].first  >= numRows) ||
+                (edges[std::size_t(i)].second < 0)) {
+                throw std::invalid_argument("edge references node outside of [0, numNodes)");
+            }
+        }
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(static)
+#endif
+        for (long i = 0; i < numEdges; ++i) {
+            std::size_t row = std::size_t(edges[std::size_t(i)].first);
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp atomic
+#endif
+            ++counts[row + 1];
+        }
+
+        for (std::size_t i = 0; i < numNodes; ++i) {
+            counts[i + 1] += counts[i];
+        }
+
+        std::vector<std::size_t> cursors(counts.begin(), counts.end() - 1);
+        std::vector<int> buffer(edges.size());
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(static)
+#endif
+        for (long i = 0; i < numEdges; ++i) {
+            std::size_t row = std::size_t(edges[std::size_t(i)].first);
+            std::size_t pos;
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp atomic capture
+#endif
+            pos = cursors[row]++;
+
+            buffer[pos] = edges[std::size_t(i)].second;
+        }
+
+        std::vector<std::size_t> uniqueCounts(numNodes + 1, 0);
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(dynamic, 4096)
+#endif
+        for (long row = 0; row < numRows; ++row) {
+            std::vector<int>::iterator begin = buffer.begin() + long(counts[std::size_t(row) + 0]);
+            std::vector<int>::iterator end   = buffer.begin() + long(counts[std::size_t(row) + 1]);
+            std::sort(begin, end);
+            uniqueCounts[std::size_t(row) + 1] = std::size_t(std::unique(begin, end) - begin);
+        }
+
+        for (std::size_t i = 0; i < numNodes; ++i) {
+            uniqueCounts[i + 1] += uniqueCounts[i];
+        }
+
+        columns.resize(uniqueCounts[numNodes]);
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(dynamic, 4096)
+#endif
+        for (long row = 0; row < numRows; ++row) {
+            std::size_t length = uniqueCounts[std::size_t(row) + 1] - uniqueCounts[std::size_t(row)];
+            std::copy(
+                buffer.begin() + long(counts[std::size_t(row)]),
+                buffer.begin() + long(counts[std::size_t(row)] + length),
+                columns.begin() + long(uniqueCounts[std::size_t(row)]));
+        }
+
+        using std::swap;
+        swap(rowOffsets, uniqueCounts);
+    }
+};
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/regionbasedadjacency.h>
 #include <libgeodecomp/misc/sharedptr.h>
+#include <algorithm>
 
 namespace LibGeoDecomp {
 
@@ -62,20 +63,26 @@ public:
      * synchronizations, but the syncs need to communicate more data.
      * This is primarily to combat high latency datapaths (e.g.
      * network latency or if the data needs to go to remote
-     * accelerators).
+     * accelerators). newStencil holds the relative coordinates of all
+     * cells read during one update (see Region::fromStencil()). If
+     * it's empty, the Moore neighborhood of radius 1 is assumed.
+     * Halos and rims are then limited to the cells actually covered
+     * by the stencil, e.g. faces only for von Neumann stencils.
      */
     inline void resetRegions(
         typename SharedPtr<AdjacencyManufacturer<DIM> >::Type newAdjacencyManufacturer,
         const CoordBox<DIM>& newSimulationArea,
         typename SharedPtr<Partition<DIM> >::Type newPartition,
         unsigned newRank,
-        unsigned newGhostZoneWidth)
+        unsigned newGhostZoneWidth,
+        const Region<DIM>& newStencil = Region<DIM>())
     {
         adjacencyManufacturer = newAdjacencyManufacturer;
         partition = newPartition;
         simulationArea = newSimulationArea;
         myRank = newRank;
         ghostZoneWidth = newGhostZoneWidth;
+        resetStencil(newStencil, Topology());
         regions.clear();
         outerGhostZoneFragments.clear();
         innerGhostZoneFragments.clear();
@@ -115,14 +122,14 @@ public:
              i != outerGhostZoneFragments.end();
              ++i) {
             if (i->first != OUTGROUP) {
-                outer -= i->second.back();
+                outer = outer.parallelDifference(i->second.back());
             }
         }
         for (typename RegionVecMap::iterator i = innerGhostZoneFragments.begin();
              i != innerGhostZoneFragments.end();
              ++i) {
             if (i->first != OUTGROUP) {
-                inner -= i->second.back();
+                inner = inner.parallelDifference(i->second.back());
             }
         }
         outerGhostZoneFragments[OUTGROUP] =
@@ -253,6 +260,7 @@ private:
     unsigned ghostZoneWidth;
     std::vector<CoordBox<DIM> > boundingBoxes;
     std::vector<CoordBox<DIM> > expandedBoundingBoxes;
+    Region<DIM> stencil;
 
     const SharedPtr<Adjacency>::Type adjacency(const Region<DIM>& region) const
     {
@@ -264,61 +272,131 @@ private:
         return adjacencyManufacturer->getReverseAdjacency(region);
     }
 
+    /**
+     * The Steppers assume that all cells read by our neighbors are
+     * part of our rim, which only holds for symmetric stencils. Hence
+     * we add the mirrored stencil. The default stencil is dropped to
+     * take the faster box expansion path.
+     */
+    template<typename ANY_TOPOLOGY>
+    inline void resetStencil(const Region<DIM>& newStencil, ANY_TOPOLOGY)
+    {
+        stencil = newStencil;
+
+        for (typename Region<DIM>::StreakIterator i = newStencil.beginStreak();
+             i != newStencil.endStreak();
+             ++i) {
+            Streak<DIM> mirrored = *i;
+            mirrored.origin = -i->origin;
+            mirrored.origin.x() = 1 - i->endX;
+            mirrored.endX = 1 - i->origin.x();
+            stencil << mirrored;
+        }
+
+        if (stencil == Region<DIM>(CoordBox<DIM>(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3)))) {
+            stencil.clear();
+        }
+    }
+
+    /**
+     * Unstructured grids derive their neighborhoods from adjacency
+     * lists, stencils don't apply here.
+     */
+    inline void resetStencil(const Region<DIM>& /* unused */, Topologies::Unstructured::Topology)
+    {
+        stencil.clear();
+    }
+
     inline void fillRegion(unsigned node)
     {
-        std::vector<Region<DIM> >& regionExpansion = regions[node];
-        regionExpansion.resize(getGhostZoneWidth() + 1);
-        regionExpansion[0] = partition->getRegion(node);
-        for (std::size_t i = 1; i <= getGhostZoneWidth(); ++i) {
-            Region<DIM> expanded;
-            const Region<DIM>& reg = regionExpansion[i - 1];
-            expanded = reg.expandWithTopology(
-                1,
+        regions[node] = expandIncrementally(
+            partition->getRegion(node),
+            getGhostZoneWidth(),
+            Topology());
+    }
+
+    /**
+     * Yields the given Region plus its expansions by 1 to width
+     * applications of the stencil, all computed in one pass.
+     */
+    template<typename ANY_TOPOLOGY>
+    inline std::vector<Region<DIM> > expandIncrementally(
+        const Region<DIM>& region,
+        unsigned width,
+        ANY_TOPOLOGY topology)
+    {
+        if (stencil.empty()) {
+            return region.expandWithTopologyIncrementally(
+                width,
                 simulationArea.dimensions,
-                Topology(),
-                *adjacency(reg));
-            regionExpansion[i] = expanded;
+                topology);
         }
+
+        return region.expandWithStencilIncrementally(
+            stencil,
+            width,
+            simulationArea.dimensions,
+            topology);
     }
 
-    inline void fillOwnRegion()
+    /**
+     * Unstructured grids need to consult the adjacency of each
+     * intermediate level, so these are expanded one after another.
+     */
+    inline std::vector<Region<DIM> > expandIncrementally(
+        const Region<DIM>& region,
+        unsigned width,
+        Topologies::Unstructured::Topology topology)
     {
-        fillRegion(myRank);
-        Region<DIM> surface(
-            ownRegion().expandWithTopology(
-                1,
-                simulationArea.dimensions,
-                Topology(),
-                *reverseAdjacency(ownRegion())) - ownRegion());
-        Region<DIM> kernel(
-            ownRegion() -
-            surface.expandWithTopology(
-                getGhostZoneWidth(),
-                simulationArea.dimensions,
-                Topology(),
-                *adjacency(surface)));
-        outerRim = ownExpandedRegion() - ownRegion();
-        ownRims.resize(getGhostZoneWidth() + 1);
-        ownInnerSets.resize(getGhostZoneWidth() + 1);
+        std::vector<Region<DIM> > ret(width + 1);
+        ret[0] = region;
 
-        ownRims.back() = ownRegion() - kernel;
-        for (int i = getGhostZoneWidth() - 1; i >= 0; --i) {
-            ownRims[i] = ownRims[i + 1].expandWithTopology(
+        for (std::size_t i = 1; i <= width; ++i) {
+            const Region<DIM>& reg = ret[i - 1];
+            ret[i] = reg.expandWithTopology(
                 1,
                 simulationArea.dimensions,
-                Topology(),
-                *adjacency(ownRims[i + 1]));
+                topology,
+                *adjacency(reg));
         }
 
-        ownInnerSets[getGhostZoneWidth()] = kernel;
-        for (std::size_t i = getGhostZoneWidth(); i > 0; --i) {
-            ownInnerSets[i - 1] = ownInnerSets[i].expandWithTopology(
-                1,
-                simulationArea.dimensions,
-                Topology(),
-                *adjacency(ownInnerSets[i]));
+        return ret;
+    }
+
+    inline void fillOwnRegion()
+    {
+        fillRegion(myRank);
+        Region<DIM> surface;
+        Region<DIM> kernel;
+
+        if (stencil.empty()) {
+            surface =
+                ownRegion().expandWithTopology(
+                    1,
+                    simulationArea.dimensions,
+                    Topology(),
+                    *reverseAdjacency(ownRegion())) - ownRegion();
+            kernel =
+                ownRegion() -
+                surface.expandWithTopology(
+                    getGhostZoneWidth(),
+                    simulationArea.dimensions,
+                    Topology(),
+                    *adjacency(surface));
+        } else {
+            surface = ownRegion(1) - ownRegion();
+            kernel = ownRegion() - expandIncrementally(surface, getGhostZoneWidth(), Topology()).back();
         }
 
+        outerRim = ownExpandedRegion() - ownRegion();
+
+        // rims and inner sets grow with decreasing distance, hence
+        // the reversal:
+        ownRims = expandIncrementally(ownRegion() - kernel, getGhostZoneWidth(), Topology());
+        std::reverse(ownRims.begin(), ownRims.end());
+        ownInnerSets = expandIncrementally(kernel, getGhostZoneWidth(), Topology());
+        std::reverse(ownInnerSets.begin(), ownInnerSets.end());
+
         volatileKernel = ownInnerSets.back() & rim(0);
         innerRim       = ownInnerSets.back() & rim(0);
     }
@@ -334,8 +412,8 @@ private:
         bool innerFragmentsAllEmpty = true;
 
         for (unsigned i = 0; i <= getGhostZoneWidth(); ++i) {
-            outerGhosts[i] = getRegion(myRank, i) & getRegion(node, 0);
-            innerGhosts[i] = getRegion(myRank, 0) & getRegion(node, i);
+            outerGhosts[i] = getRegion(myRank, i).parallelIntersection(getRegion(node, 0));
+            innerGhosts[i] = getRegion(myRank, 0).parallelIntersection(getRegion(node, i));
 
             outerFragmentsAllEmpty &= outerGhosts[i].empty();
             innerFragmentsAllEmpty &= innerGhosts[i].empty();
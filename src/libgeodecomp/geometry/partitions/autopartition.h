@@ -0,0 +1,151 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_AUTOPARTITION_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_AUTOPARTITION_H
+
+#include <libgeodecomp/geometry/partitions/checkerboardingpartition.h>
+#include <libgeodecomp/geometry/partitions/hilbertpartition.h>
+#include <libgeodecomp/geometry/partitions/hindexingpartition.h>
+#include <libgeodecomp/geometry/partitions/partitionevaluator.h>
+#include <libgeodecomp/geometry/partitions/recursivebisectionpartition.h>
+#include <libgeodecomp/geometry/partitions/stripingpartition.h>
+#include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+#include <libgeodecomp/geometry/stencils.h>
+
+namespace LibGeoDecomp {
+
+namespace AutoPartitionHelpers {
+
+/**
+ * Adds those partitions which are available for all dimensions.
+ */
+template<int DIM>
+class AddCandidates
+{
+public:
+    typedef typename SharedPtr<Partition<DIM> >::Type PartitionPtr;
+
+    void operator()(
+        std::vector<PartitionPtr> *candidates,
+        std::vector<std::string> *names,
+        const Coord<DIM>& origin,
+        const Coord<DIM>& dimensions,
+        const long offset,
+        const std::vector<std::size_t>& weights) const
+    {
+        candidates->push_back(PartitionPtr(new StripingPartition<DIM>(origin, dimensions, offset, weights)));
+        names->push_back("StripingPartition");
+        candidates->push_back(PartitionPtr(new CheckerboardingPartition<DIM>(origin, dimensions, offset, weights)));
+        names->push_back("CheckerboardingPartition");
+        candidates->push_back(PartitionPtr(new RecursiveBisectionPartition<DIM>(origin, dimensions, offset, weights)));
+        names->push_back("RecursiveBisectionPartition");
+        candidates->push_back(PartitionPtr(new ZCurvePartition<DIM>(origin, dimensions, offset, weights)));
+        names->push_back("ZCurvePartition");
+    }
+};
+
+/**
+ * Adds the 2D-only partitions (Hilbert curve and H-indexing) on top
+ * of the generic ones.
+ */
+template<int DIM>
+class AddAllCandidates : public AddCandidates<DIM>
+{};
+
+template<>
+class AddAllCandidates<2>
+{
+public:
+    typedef SharedPtr<Partition<2> >::Type PartitionPtr;
+
+    void operator()(
+        std::vector<PartitionPtr> *candidates,
+        std::vector<std::string> *names,
+        const Coord<2>& origin,
+        const Coord<2>& dimensions,
+        const long offset,
+        const std::vector<std::size_t>& weights) const
+    {
+        AddCandidates<2>()(candidates, names, origin, dimensions, offset, weights);
+
+        candidates->push_back(PartitionPtr(new HilbertPartition(origin, dimensions, offset, weights)));
+        names->push_back("HilbertPartition");
+        candidates->push_back(PartitionPtr(new HIndexingPartition(origin, dimensions, offset, weights)));
+        names->push_back("HIndexingPartition");
+    }
+};
+
+}
+
+/**
+ * AutoPartition evaluates all regular grid partitions via the
+ * PartitionEvaluator and delegates to the one with the lowest cost.
+ * It can be used as a drop-in PARTITION parameter for e.g. the
+ * HiParSimulator so users don't need to guess which decomposition
+ * works best for a given grid size and number of nodes. Ghost zone
+ * width, stencil and topology should match the simulation's
+ * settings, the cost can be tuned via COST_MODEL (see
+ * PartitionCostModel).
+ *
+ * The evaluation runs on each rank and is deterministic, so all
+ * ranks will agree on the selection.
+ */
+template<
+    int DIM,
+    typename TOPOLOGY = typename Topologies::Cube<DIM>::Topology,
+    typename STENCIL = Stencils::Moore<DIM, 1>,
+    unsigned GHOST_ZONE_WIDTH = 1,
+    typename COST_MODEL = PartitionCostModel>
+class AutoPartition : public Partition<DIM>
+{
+public:
+    typedef typename Partition<DIM>::AdjacencyPtr AdjacencyPtr;
+    typedef typename SharedPtr<Partition<DIM> >::Type PartitionPtr;
+
+    inline explicit AutoPartition(
+        const Coord<DIM>& origin = Coord<DIM>(),
+        const Coord<DIM>& dimensions = Coord<DIM>(),
+        const long& offset = 0,
+        const std::vector<std::size_t>& weights = std::vector<std::size_t>(2),
+        const AdjacencyPtr& /* unused: adjacency */ = AdjacencyPtr()) :
+        Partition<DIM>(offset, weights)
+    {
+        std::vector<PartitionPtr> candidates;
+        AutoPartitionHelpers::AddAllCandidates<DIM>()(&candidates, &names, origin, dimensions, offset, weights);
+
+        PartitionEvaluator<DIM, TOPOLOGY, COST_MODEL> evaluator(
+            CoordBox<DIM>(origin, dimensions),
+            GHOST_ZONE_WIDTH,
+            Region<DIM>::fromStencil(STENCIL()));
+        selected = evaluator.selectBest(candidates, weights.size(), &evaluations);
+        delegate = candidates[selected];
+    }
+
+    Region<DIM> getRegion(const std::size_t node) const
+    {
+        return delegate->getRegion(node);
+    }
+
+    inline const std::string& selectedPartition() const
+    {
+        return names[selected];
+    }
+
+    inline const std::vector<std::string>& candidateNames() const
+    {
+        return names;
+    }
+
+    inline const std::vector<PartitionEvaluation>& getEvaluations() const
+    {
+        return evaluations;
+    }
+
+private:
+    PartitionPtr delegate;
+    std::size_t selected;
+    std::vector<std::string> names;
+    std::vector<PartitionEvaluation> evaluations;
+};
+
+}
+
+#endif
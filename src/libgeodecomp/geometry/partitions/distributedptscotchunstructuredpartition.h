@@ -212,31 +212,34 @@ private:
 
         regions = partials;
 
-        // send partial regions to all other nodes so they can build the complete regions
+        // send partial regions to all other nodes so they can build
+        // the complete regions. sends are nonblocking to avoid
+        // serializing the all-to-all exchange:
+        MPILayer layer;
         for (std::size_t j = 0; j < numPartitions; ++j) {
             // dont send own regions to self:
-            if (j != MPILayer().rank()) {
-                // send all partial regions
+            if (j != layer.rank()) {
                 for (std::size_t k = 0; k < numPartitions; ++k) {
-                    MPILayer().sendRegion(partials.at(k), j);
-                }
-            } else {
-                // regions will be received from all ranks except self
-                for (int i = 0; i < numPartitions; ++i) {
-                    if (i == j) continue; // we won't receive regions from ourself
-
-                    // receive parts&  build up own regions
-                    for (std::size_t k = 0; k < numPartitions; ++k) {
-                        Region<1> received;
-                        MPILayer().recvRegion(&received, i);
-
-                        // add the region to ourself
-                        regions.at(k) += received;
-                    }
+                    layer.isendRegion(partials.at(k), j, 0);
                 }
             }
         }
 
+        // regions will be received from all ranks except self
+        for (int i = 0; i < numPartitions; ++i) {
+            if (i == layer.rank()) continue; // we won't receive regions from ourself
+
+            // receive parts & build up own regions
+            for (std::size_t k = 0; k < numPartitions; ++k) {
+                Region<1> received;
+                layer.recvRegion(&received, i);
+
+                // add the region to ourself
+                regions.at(k) += received;
+            }
+        }
+        layer.waitAll();
+
 #if defined(PTSCOTCH_PARTITION_PRETTY_PRINT_GRID_SIZE)
         // pretty print regions. those should all be the same in the end
         for (int i = 0; i < MPILayer().size(); ++i) {
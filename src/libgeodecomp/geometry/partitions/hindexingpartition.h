@@ -543,9 +543,7 @@ public:
 
     inline Region<2> getRegion(const std::size_t node) const
     {
-        return Region<2>(
-            (*this)[startOffsets[node + 0]],
-            (*this)[startOffsets[node + 1]]);
+        return this->regionFromIndex(*this, startOffsets[node + 0], startOffsets[node + 1]);
     }
 
     inline Iterator operator[](unsigned pos) const
@@ -0,0 +1,523 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_MULTILEVELUNSTRUCTUREDPARTITION_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_MULTILEVELUNSTRUCTUREDPARTITION_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/adjacency.h>
+#include <libgeodecomp/geometry/csradjacency.h>
+#include <libgeodecomp/geometry/partitions/partition.h>
+
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * A built-in multilevel graph partitioner for unstructured grids,
+ * following the well known scheme of METIS/Scotch:
+ *
+ * 1. the graph is coarsened by repeatedly contracting a heavy edge
+ *    matching until it's small,
+ * 2. the coarsest graph is partitioned by greedy graph growing,
+ * 3. the partition is projected back level by level and improved by
+ *    a boundary Fiduccia-Mattheyses-style (FM) refinement which moves
+ *    vertices to the neighboring part with the highest gain, subject
+ *    to a balance constraint.
+ *
+ * It's meant as a drop-in replacement for
+ * PTScotchUnstructuredPartition on systems without Scotch. Unlike
+ * UnstructuredStripingPartition it takes the adjacency into account
+ * and hence yields far smaller edge cuts. Cells are identified by
+ * their ID, i.e. origin.x() + i for i in [0, dimensions.x()).
+ *
+ * The algorithm is deterministic, so all ranks will compute
+ * identical partitions.
+ */
+class MultilevelUnstructuredPartition : public Partition<1>
+{
+public:
+    friend class MultilevelUnstructuredPartitionTest;
+
+    using Partition<1>::startOffsets;
+    using Partition<1>::weights;
+    using Partition<1>::AdjacencyPtr;
+
+    /**
+     * Graphs with fewer than COARSEST_VERTICES_PER_PART * number of
+     * parts vertices won't be coarsened any further.
+     */
+    static const int COARSEST_VERTICES_PER_PART = 20;
+
+    /**
+     * Upper bound for the number of FM passes per level.
+     */
+    static const int MAX_REFINEMENT_PASSES = 8;
+
+    /**
+     * Permitted overload of any part, in percent of its target
+     * weight.
+     */
+    static const int IMBALANCE_TOLERANCE = 3;
+
+    MultilevelUnstructuredPartition(
+        const Coord<1>& origin,
+        const Coord<1>& dimensions,
+        const long offset,
+        const std::vector<std::size_t>& weights,
+        const AdjacencyPtr& adjacency = AdjacencyPtr()) :
+        Partition<1>(offset, weights),
+        origin(origin.x()),
+        regions(weights.size())
+    {
+        Graph graph(adjacency, origin.x(), dimensions.x());
+        std::vector<int> parts = partition(graph);
+
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            regions[parts[i]] << Coord<1>(this->origin + int(i));
+        }
+    }
+
+    Region<1> getRegion(const std::size_t node) const
+#ifdef LIBGEODECOMP_WITH_CPP14
+        override
+#endif
+    {
+        return regions.at(node);
+    }
+
+private:
+    /**
+     * An undirected, vertex- and edge-weighted graph in compressed
+     * sparse row (CSR) format.
+     */
+    class Graph
+    {
+    public:
+        inline Graph()
+        {}
+
+        /**
+         * Converts the (directed) adjacency into an undirected graph.
+         * Self-loops and edges to nodes outside of [origin, origin +
+         * numVertices) are dropped, parallel edges are merged.
+         */
+        inline Graph(const AdjacencyPtr& adjacency, int origin, int numVertices) :
+            vertexWeights(numVertices, 1)
+        {
+            std::vector<CSRAdjacency::Edge> edges;
+            std::vector<int> neighbors;
+
+            if (adjacency) {
+                edges.reserve(2 * adjacency->size());
+                for (int i = 0; i < numVertices; ++i) {
+                    neighbors.clear();
+                    adjacency->getNeighbors(origin + i, &neighbors);
+                    for (std::vector<int>::iterator j = neighbors.begin(); j != neighbors.end(); ++j) {
+                        int target = *j - origin;
+                        if ((target == i) || (target < 0) || (target >= numVertices)) {
+                            continue;
+                        }
+
+                        edges.push_back(std::make_pair(i, target));
+                        edges.push_back(std::make_pair(target, i));
+                    }
+                }
+            }
+
+            CSRAdjacency symmetric(std::size_t(numVertices), edges);
+            offsets.assign(symmetric.getRowOffsets().begin(), symmetric.getRowOffsets().end());
+            targets = symmetric.getColumns();
+            edgeWeights.resize(targets.size(), 1);
+        }
+
+        inline int numVertices() const
+        {
+            return vertexWeights.size();
+        }
+
+        inline long totalVertexWeight() const
+        {
+            long ret = 0;
+            for (std::vector<int>::const_iterator i = vertexWeights.begin(); i != vertexWeights.end(); ++i) {
+                ret += *i;
+            }
+            return ret;
+        }
+
+        std::vector<int> offsets;
+        std::vector<int> targets;
+        std::vector<int> edgeWeights;
+        std::vector<int> vertexWeights;
+    };
+
+    int origin;
+    std::vector<Region<1> > regions;
+
+    std::vector<int> partition(const Graph& graph) const
+    {
+        int numParts = weights.size();
+        if (numParts == 0) {
+            throw std::invalid_argument("MultilevelUnstructuredPartition needs at least one weight");
+        }
+        if (graph.numVertices() == 0) {
+            return std::vector<int>();
+        }
+
+        // levels[0] is the original graph, coarseMaps[i] maps
+        // vertices of levels[i] to those of levels[i + 1]:
+        std::vector<Graph> levels(1, graph);
+        std::vector<std::vector<int> > coarseMaps;
+        std::mt19937 generator(4711);
+
+        int coarsestSize = (std::max)(100, COARSEST_VERTICES_PER_PART * numParts);
+        long maxVertexWeight = (std::max)(1l, 3 * graph.totalVertexWeight() / (2 * coarsestSize));
+
+        while (levels.back().numVertices() > coarsestSize) {
+            std::vector<int> coarseMap;
+            Graph coarse = coarsen(levels.back(), &coarseMap, maxVertexWeight, &generator);
+            // stop if the matching degenerated, e.g. for graphs with
+            // few edges:
+            if (coarse.numVertices() > (0.95 * levels.back().numVertices())) {
+                break;
+            }
+
+            levels.push_back(coarse);
+            coarseMaps.push_back(coarseMap);
+        }
+
+        std::vector<int> parts = initialPartition(levels.back());
+        refine(levels.back(), &parts);
+
+        for (int level = int(coarseMaps.size()) - 1; level >= 0; --level) {
+            const std::vector<int>& coarseMap = coarseMaps[level];
+            std::vector<int> fineParts(coarseMap.size());
+            for (std::size_t i = 0; i < coarseMap.size(); ++i) {
+                fineParts[i] = parts[coarseMap[i]];
+            }
+
+            std::swap(parts, fineParts);
+            refine(levels[level], &parts);
+        }
+
+        return parts;
+    }
+
+    /**
+     * Contracts a heavy edge matching: vertices are visited in random
+     * order and matched with the unmatched neighbor to which they're
+     * connected by the heaviest edge.
+     */
+    Graph coarsen(
+        const Graph& graph,
+        std::vector<int> *coarseMap,
+        long maxVertexWeight,
+        std::mt19937 *generator) const
+    {
+        int n = graph.numVertices();
+        std::vector<int> order(n);
+        for (int i = 0; i < n; ++i) {
+            order[i] = i;
+        }
+        for (int i = n - 1; i > 0; --i) {
+            std::swap(order[i], order[(*generator)() % (i + 1)]);
+        }
+
+        std::vector<int> match(n, -1);
+        for (std::vector<int>::iterator i = order.begin(); i != order.end(); ++i) {
+            int v = *i;
+            if (match[v] != -1) {
+                continue;
+            }
+
+            int best = v;
+            int bestWeight = 0;
+            for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                int u = graph.targets[e];
+                if ((match[u] == -1) &&
+                    (graph.edgeWeights[e] > bestWeight) &&
+                    ((graph.vertexWeights[v] + graph.vertexWeights[u]) <= maxVertexWeight)) {
+                    best = u;
+                    bestWeight = graph.edgeWeights[e];
+                }
+            }
+
+            match[v] = best;
+            match[best] = v;
+        }
+
+        coarseMap->assign(n, -1);
+        std::vector<int> members;
+        members.reserve(n);
+        int numCoarse = 0;
+        for (int v = 0; v < n; ++v) {
+            if ((*coarseMap)[v] != -1) {
+                continue;
+            }
+
+            (*coarseMap)[v] = numCoarse;
+            (*coarseMap)[match[v]] = numCoarse;
+            members.push_back(v);
+            ++numCoarse;
+        }
+
+        Graph coarse;
+        coarse.vertexWeights.assign(numCoarse, 0);
+        coarse.offsets.reserve(numCoarse + 1);
+        coarse.offsets.push_back(0);
+        // position of edge (c, x) in coarse.targets, or -1:
+        std::vector<int> edgeIndex(numCoarse, -1);
+
+        for (int c = 0; c < numCoarse; ++c) {
+            int first = members[c];
+            int second = match[first];
+            int rowStart = coarse.targets.size();
+
+            for (int k = 0; k < ((first == second) ? 1 : 2); ++k) {
+                int v = (k == 0) ? first : second;
+                coarse.vertexWeights[c] += graph.vertexWeights[v];
+
+                for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                    int target = (*coarseMap)[graph.targets[e]];
+                    if (target == c) {
+                        continue;
+                    }
+
+                    if (edgeIndex[target] == -1) {
+                        edgeIndex[target] = coarse.targets.size();
+                        coarse.targets.push_back(target);
+                        coarse.edgeWeights.push_back(graph.edgeWeights[e]);
+                    } else {
+                        coarse.edgeWeights[edgeIndex[target]] += graph.edgeWeights[e];
+                    }
+                }
+            }
+
+            for (std::size_t e = rowStart; e < coarse.targets.size(); ++e) {
+                edgeIndex[coarse.targets[e]] = -1;
+            }
+            coarse.offsets.push_back(coarse.targets.size());
+        }
+
+        return coarse;
+    }
+
+    /**
+     * Target weight of each part, proportional to the Partition's
+     * weights vector.
+     */
+    std::vector<double> targetWeights(const Graph& graph) const
+    {
+        double sum = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            sum += weights[i];
+        }
+
+        std::vector<double> ret(weights.size());
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            ret[i] = (sum == 0) ? 0 : (graph.totalVertexWeight() * (weights[i] / sum));
+        }
+
+        return ret;
+    }
+
+    /**
+     * Greedy graph growing: parts are grown one after another from a
+     * seed vertex, always adding the frontier vertex which is most
+     * strongly connected to the part, until the part's target weight
+     * is reached. The last non-empty part takes the rest.
+     */
+    std::vector<int> initialPartition(const Graph& graph) const
+    {
+        typedef std::pair<int, int> GainVertexPair;
+
+        int n = graph.numVertices();
+        std::vector<double> targets = targetWeights(graph);
+        int lastPart = 0;
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            if (targets[i] > 0) {
+                lastPart = i;
+            }
+        }
+
+        std::vector<int> parts(n, -1);
+        std::vector<int> connectivity(n, 0);
+        int nextSeed = 0;
+        double assignedTarget = 0;
+        long assignedWeight = 0;
+
+        for (int part = 0; part < lastPart; ++part) {
+            assignedTarget += targets[part];
+            std::priority_queue<GainVertexPair> frontier;
+            std::vector<int> touched;
+
+            while (assignedWeight < assignedTarget) {
+                int v = -1;
+                while (!frontier.empty()) {
+                    GainVertexPair candidate = frontier.top();
+                    frontier.pop();
+                    if ((parts[candidate.second] == -1) &&
+                        (connectivity[candidate.second] == candidate.first)) {
+                        v = candidate.second;
+                        break;
+                    }
+                }
+                if (v == -1) {
+                    while ((nextSeed < n) && (parts[nextSeed] != -1)) {
+                        ++nextSeed;
+                    }
+                    if (nextSeed == n) {
+                        break;
+                    }
+                    v = nextSeed;
+                }
+
+                // don't overshoot the target by more than half a vertex:
+                if ((assignedWeight + 0.5 * graph.vertexWeights[v]) > assignedTarget) {
+                    break;
+                }
+
+                parts[v] = part;
+                assignedWeight += graph.vertexWeights[v];
+                for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                    int u = graph.targets[e];
+                    if (parts[u] == -1) {
+                        if (connectivity[u] == 0) {
+                            touched.push_back(u);
+                        }
+                        connectivity[u] += graph.edgeWeights[e];
+                        frontier.push(GainVertexPair(connectivity[u], u));
+                    }
+                }
+            }
+
+            for (std::vector<int>::iterator i = touched.begin(); i != touched.end(); ++i) {
+                connectivity[*i] = 0;
+            }
+        }
+
+        for (int v = 0; v < n; ++v) {
+            if (parts[v] == -1) {
+                parts[v] = lastPart;
+            }
+        }
+
+        return parts;
+    }
+
+    /**
+     * Boundary FM refinement: each pass visits all vertices and moves
+     * boundary vertices to the adjacent part with the largest gain
+     * (reduction of edge cut). Moves with zero gain are accepted if
+     * they improve the balance. Parts outside of the permitted
+     * imbalance are fixed by moving vertices even at a loss.
+     */
+    void refine(const Graph& graph, std::vector<int> *parts) const
+    {
+        int n = graph.numVertices();
+        int numParts = weights.size();
+        std::vector<double> targets = targetWeights(graph);
+
+        int maxVertexWeight = 0;
+        std::vector<long> partWeights(numParts, 0);
+        for (int v = 0; v < n; ++v) {
+            partWeights[(*parts)[v]] += graph.vertexWeights[v];
+            maxVertexWeight = (std::max)(maxVertexWeight, graph.vertexWeights[v]);
+        }
+
+        std::vector<double> maxWeights(numParts);
+        std::vector<double> minWeights(numParts);
+        for (int i = 0; i < numParts; ++i) {
+            double tolerance = targets[i] * IMBALANCE_TOLERANCE * 0.01;
+            tolerance = (std::max)(tolerance, double(maxVertexWeight));
+            maxWeights[i] = (targets[i] == 0) ? 0 : targets[i] + tolerance;
+            minWeights[i] = (targets[i] == 0) ? 0 : targets[i] - tolerance;
+        }
+
+        std::vector<int> connectivity(numParts, 0);
+        std::vector<int> adjacentParts;
+
+        for (int pass = 0; pass < MAX_REFINEMENT_PASSES; ++pass) {
+            int moves = 0;
+
+            for (int v = 0; v < n; ++v) {
+                int from = (*parts)[v];
+                int weight = graph.vertexWeights[v];
+
+                adjacentParts.clear();
+                for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                    int part = (*parts)[graph.targets[e]];
+                    if ((connectivity[part] == 0) && (part != from)) {
+                        adjacentParts.push_back(part);
+                    }
+                    connectivity[part] += graph.edgeWeights[e];
+                }
+
+                bool overloaded = partWeights[from] > maxWeights[from];
+                bool mayShrink = overloaded || ((partWeights[from] - weight) >= minWeights[from]);
+                int internal = connectivity[from];
+
+                // best move overall, and best move into an underloaded part:
+                int bestPart = -1;
+                int bestGain = 0;
+                double bestLoad = 0;
+                int bestUnderloadedPart = -1;
+                int bestUnderloadedGain = 0;
+
+                for (std::vector<int>::iterator i = adjacentParts.begin(); i != adjacentParts.end(); ++i) {
+                    int to = *i;
+                    if (!mayShrink || ((partWeights[to] + weight) > maxWeights[to])) {
+                        continue;
+                    }
+
+                    int gain = connectivity[to] - internal;
+                    double load = (partWeights[to] + weight) / targets[to];
+                    if ((bestPart == -1) || (gain > bestGain) || ((gain == bestGain) && (load < bestLoad))) {
+                        bestPart = to;
+                        bestGain = gain;
+                        bestLoad = load;
+                    }
+
+                    if ((partWeights[to] < minWeights[to]) &&
+                        ((bestUnderloadedPart == -1) || (gain > bestUnderloadedGain))) {
+                        bestUnderloadedPart = to;
+                        bestUnderloadedGain = gain;
+                    }
+                }
+
+                bool accept = false;
+                if ((bestPart != -1) && (bestGain <= 0) && (bestUnderloadedPart != -1)) {
+                    bestPart = bestUnderloadedPart;
+                    accept = true;
+                } else if (bestPart != -1) {
+                    double loadFrom = partWeights[from] / targets[from];
+                    accept =
+                        overloaded ||
+                        (bestGain > 0) ||
+                        ((bestGain == 0) && (bestLoad < loadFrom));
+                }
+
+                if (accept) {
+                    (*parts)[v] = bestPart;
+                    partWeights[from] -= weight;
+                    partWeights[bestPart] += weight;
+                    ++moves;
+                }
+
+                connectivity[from] = 0;
+                for (std::vector<int>::iterator i = adjacentParts.begin(); i != adjacentParts.end(); ++i) {
+                    connectivity[*i] = 0;
+                }
+            }
+
+            if (moves == 0) {
+                break;
+            }
+        }
+    }
+};
+
+}
+
+#endif
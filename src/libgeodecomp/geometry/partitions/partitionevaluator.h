@@ -0,0 +1,237 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_PARTITIONEVALUATOR_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_PARTITIONEVALUATOR_H
+
+#include <libgeodecomp/geometry/coordbox.h>
+#include <libgeodecomp/geometry/dummyadjacencymanufacturer.h>
+#include <libgeodecomp/geometry/partitionmanager.h>
+#include <libgeodecomp/geometry/partitions/partition.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/topologies.h>
+#include <libgeodecomp/misc/sharedptr.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Estimates the time a node needs per time step, given its number
+ * of cells, the volume of its outer ghost zone, and the number of
+ * neighbors it has to exchange messages with. All costs are given
+ * relative to the update of a single cell. The defaults assume that
+ * sending a cell is about as expensive as updating it, and that the
+ * latency of a message corresponds to 1000 cell updates. Users
+ * should adjust those to their machine and model.
+ */
+class PartitionCostModel
+{
+public:
+    inline explicit PartitionCostModel(
+        double cellCost = 1.0,
+        double ghostCellCost = 1.0,
+        double messageCost = 1000.0) :
+        cellCost(cellCost),
+        ghostCellCost(ghostCellCost),
+        messageCost(messageCost)
+    {}
+
+    inline double operator()(std::size_t cells, std::size_t ghostCells, std::size_t neighbors) const
+    {
+        return
+            cellCost      * cells +
+            ghostCellCost * ghostCells +
+            messageCost   * neighbors;
+    }
+
+private:
+    double cellCost;
+    double ghostCellCost;
+    double messageCost;
+};
+
+/**
+ * Communication metrics of a decomposition, aggregated over all
+ * nodes. cost is the maximum of the CostModel over all nodes, as the
+ * slowest node determines the pace of the whole simulation.
+ */
+class PartitionEvaluation
+{
+public:
+    inline PartitionEvaluation() :
+        maxCells(0),
+        totalCells(0),
+        maxGhostVolume(0),
+        totalGhostVolume(0),
+        maxNeighbors(0),
+        totalNeighbors(0),
+        cost(0)
+    {}
+
+    /**
+     * Ratio of the maximum to the average load, minus 1.
+     */
+    inline double loadImbalance(std::size_t numNodes) const
+    {
+        if (totalCells == 0) {
+            return 0;
+        }
+
+        return double(maxCells) * numNodes / totalCells - 1;
+    }
+
+    std::string toString() const
+    {
+        std::stringstream buf;
+        buf << "PartitionEvaluation(maxCells: " << maxCells
+            << ", totalCells: " << totalCells
+            << ", maxGhostVolume: " << maxGhostVolume
+            << ", totalGhostVolume: " << totalGhostVolume
+            << ", maxNeighbors: " << maxNeighbors
+            << ", totalNeighbors: " << totalNeighbors
+            << ", cost: " << cost << ")";
+        return buf.str();
+    }
+
+    std::size_t maxCells;
+    std::size_t totalCells;
+    std::size_t maxGhostVolume;
+    std::size_t totalGhostVolume;
+    std::size_t maxNeighbors;
+    std::size_t totalNeighbors;
+    double cost;
+};
+
+/**
+ * Evaluates decompositions by running a PartitionManager for each
+ * node (just like the UpdateGroups would do on the actual ranks) and
+ * reading off the outer ghost zone fragments. This way the metrics
+ * honor the ghost zone width, the stencil and the topology. Useful
+ * for picking a Partition (see AutoPartition) or for tuning the
+ * weights of a PartitionCostModel.
+ *
+ * The evaluation needs to look at each node's neighborhood, so its
+ * time is about that of setting up all PartitionManagers of a run
+ * sequentially.
+ */
+template<int DIM, typename TOPOLOGY = typename Topologies::Cube<DIM>::Topology, typename COST_MODEL = PartitionCostModel>
+class PartitionEvaluator
+{
+public:
+    typedef typename SharedPtr<Partition<DIM> >::Type PartitionPtr;
+    typedef PartitionManager<TOPOLOGY> PartitionManagerType;
+
+    /**
+     * stencil is expected in the format of Region::fromStencil(). An
+     * empty stencil selects the Moore neighborhood.
+     */
+    inline explicit PartitionEvaluator(
+        const CoordBox<DIM>& simulationArea,
+        unsigned ghostZoneWidth = 1,
+        const Region<DIM>& stencil = Region<DIM>(),
+        const COST_MODEL& costModel = COST_MODEL()) :
+        simulationArea(simulationArea),
+        ghostZoneWidth(ghostZoneWidth),
+        stencil(stencil),
+        costModel(costModel)
+    {}
+
+    PartitionEvaluation operator()(const PartitionPtr& partition, std::size_t numNodes) const
+    {
+        std::vector<CoordBox<DIM> > boundingBoxes(numNodes);
+        std::vector<CoordBox<DIM> > expandedBoundingBoxes(numNodes);
+
+        for (std::size_t i = 0; i < numNodes; ++i) {
+            PartitionManagerType manager;
+            resetManager(&manager, partition, i);
+            boundingBoxes[i] = manager.ownRegion().boundingBox();
+            expandedBoundingBoxes[i] = manager.ownExpandedRegion().boundingBox();
+        }
+
+        PartitionEvaluation ret;
+        for (std::size_t i = 0; i < numNodes; ++i) {
+            PartitionManagerType manager;
+            resetManager(&manager, partition, i);
+            manager.resetGhostZones(boundingBoxes, expandedBoundingBoxes);
+
+            std::size_t cells = manager.ownRegion().size();
+            std::size_t ghostVolume = 0;
+            std::size_t neighbors = 0;
+
+            typedef typename PartitionManagerType::RegionVecMap RegionVecMap;
+            const RegionVecMap& fragments = manager.getOuterGhostZoneFragments();
+            for (typename RegionVecMap::const_iterator j = fragments.begin(); j != fragments.end(); ++j) {
+                if (j->first == PartitionManagerType::OUTGROUP) {
+                    continue;
+                }
+
+                ghostVolume += j->second.back().size();
+                ++neighbors;
+            }
+
+            ret.maxCells = (std::max)(ret.maxCells, cells);
+            ret.totalCells += cells;
+            ret.maxGhostVolume = (std::max)(ret.maxGhostVolume, ghostVolume);
+            ret.totalGhostVolume += ghostVolume;
+            ret.maxNeighbors = (std::max)(ret.maxNeighbors, neighbors);
+            ret.totalNeighbors += neighbors;
+            ret.cost = (std::max)(ret.cost, costModel(cells, ghostVolume, neighbors));
+        }
+
+        return ret;
+    }
+
+    /**
+     * Evaluates all candidates and returns the index of the one with
+     * the lowest cost. Evaluations are stored in evaluations, if
+     * given.
+     */
+    std::size_t selectBest(
+        const std::vector<PartitionPtr>& candidates,
+        std::size_t numNodes,
+        std::vector<PartitionEvaluation> *evaluations = 0) const
+    {
+        if (candidates.empty()) {
+            throw std::invalid_argument("no candidate partitions given");
+        }
+
+        std::size_t best = 0;
+        double bestCost = 0;
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            PartitionEvaluation evaluation = (*this)(candidates[i], numNodes);
+            if (evaluations) {
+                evaluations->push_back(evaluation);
+            }
+
+            if ((i == 0) || (evaluation.cost < bestCost)) {
+                best = i;
+                bestCost = evaluation.cost;
+            }
+        }
+
+        return best;
+    }
+
+private:
+    CoordBox<DIM> simulationArea;
+    unsigned ghostZoneWidth;
+    Region<DIM> stencil;
+    COST_MODEL costModel;
+
+    void resetManager(PartitionManagerType *manager, const PartitionPtr& partition, std::size_t node) const
+    {
+        manager->resetRegions(
+            makeShared(new DummyAdjacencyManufacturer<DIM>()),
+            simulationArea,
+            partition,
+            node,
+            ghostZoneWidth,
+            stencil);
+    }
+};
+
+}
+
+#endif
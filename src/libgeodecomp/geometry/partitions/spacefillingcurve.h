@@ -2,8 +2,13 @@
 #define LIBGEODECOMP_GEOMETRY_PARTITIONS_SPACEFILLINGCURVE_H
 
 #include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/partitions/partition.h>
+#include <libgeodecomp/misc/sharedptr.h>
+
+#include <algorithm>
+#include <vector>
 
 namespace LibGeoDecomp {
 
@@ -62,11 +67,202 @@ public:
         SpaceFillingCurveSublevelState sublevelState;
     };
 
+    /**
+     * A contiguous section of the curve which covers exactly the
+     * cells of box, starting at curve position offset.
+     */
+    class IndexEntry
+    {
+    public:
+        inline IndexEntry(const CoordBox<DIM>& box, std::size_t offset) :
+            box(box),
+            offset(offset)
+        {}
+
+        inline std::size_t end() const
+        {
+            return offset + box.dimensions.prod();
+        }
+
+        CoordBox<DIM> box;
+        std::size_t offset;
+    };
+
+    typedef std::vector<IndexEntry> CurveIndex;
+    typedef typename SharedPtr<CurveIndex>::Type CurveIndexPtr;
+
+    /**
+     * Upper bound for the volume of boxes in the curve index. It
+     * limits the number of cells which need to be walked when a
+     * subdomain boundary cuts a box.
+     */
+    static const int MAX_INDEX_BOX_SIZE = 4096;
+
     inline SpaceFillingCurve(
         const long& offset,
         const std::vector<std::size_t>& weights) :
         Partition<DIM>(offset, weights)
     {}
+
+    /**
+     * Re-slices the curve according to newWeights (e.g. as computed
+     * by a LoadBalancer). The curve index is retained, so subsequent
+     * calls to getRegion() don't need to walk the curve again.
+     */
+    inline void setWeights(const std::vector<std::size_t>& newWeights)
+    {
+        weights = newWeights;
+        startOffsets.resize(weights.size() + 1);
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            startOffsets[i + 1] = startOffsets[i] + weights[i];
+        }
+    }
+
+protected:
+    using Partition<DIM>::startOffsets;
+    using Partition<DIM>::weights;
+
+    mutable CurveIndexPtr curveIndex;
+
+    /**
+     * Returns the Region covered by the curve positions [start,
+     * end). The curve is walked only once, to build a compressed
+     * index of boxes traversed contiguously by the curve. Afterwards
+     * a lookup costs O(log(#boxes)) plus time proportional to the
+     * number of Streaks in the result, plus a walk of at most
+     * MAX_INDEX_BOX_SIZE cells at either end of the range.
+     */
+    template<typename CURVE>
+    Region<DIM> regionFromIndex(const CURVE& curve, std::size_t start, std::size_t end) const
+    {
+        if (!curveIndex) {
+            curveIndex = buildIndex(curve);
+        }
+
+        std::vector<Streak<DIM> > streaks;
+        Region<DIM> ret;
+        if (curveIndex->empty()) {
+            return ret;
+        }
+        end = (std::min)(end, curveIndex->back().end());
+        if (start >= end) {
+            return ret;
+        }
+
+        typename CurveIndex::const_iterator i = std::upper_bound(
+            curveIndex->begin(),
+            curveIndex->end(),
+            start,
+            offsetLessThan) - 1;
+
+        for (; (i != curveIndex->end()) && (i->offset < end); ++i) {
+            if ((i->offset >= start) && (i->end() <= end)) {
+                addBox(&streaks, i->box);
+                continue;
+            }
+
+            // range boundary cuts through this box, so we walk it:
+            std::size_t partialStart = (std::max)(start, i->offset);
+            std::size_t partialEnd   = (std::min)(end,   i->end());
+            typename CURVE::Iterator iter = curve[partialStart];
+            for (std::size_t pos = partialStart; pos < partialEnd; ++pos, ++iter) {
+                streaks.push_back(Streak<DIM>(*iter, iter->x() + 1));
+            }
+        }
+
+        // sorted insertion appends to the Region's index vectors,
+        // which is much cheaper than inserting in curve order:
+        std::sort(streaks.begin(), streaks.end(), streakLessThan);
+        for (typename std::vector<Streak<DIM> >::iterator s = streaks.begin(); s != streaks.end(); ++s) {
+            ret << *s;
+        }
+
+        return ret;
+    }
+
+private:
+    template<typename CURVE>
+    static CurveIndexPtr buildIndex(const CURVE& curve)
+    {
+        CurveIndexPtr ret(new CurveIndex);
+        std::size_t pos = 0;
+
+        for (typename CURVE::Iterator i = curve.begin(); i != curve.end(); ++i, ++pos) {
+            ret->push_back(IndexEntry(CoordBox<DIM>(*i, Coord<DIM>::diagonal(1)), pos));
+
+            // merging with predecessors yields a hierarchy of boxes,
+            // just like the recursive structure of the curves:
+            while ((ret->size() >= 2) && tryMerge(&(*ret)[ret->size() - 2], ret->back())) {
+                ret->pop_back();
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * Extends a by b iff their union is again a box (and not too
+     * large).
+     */
+    static bool tryMerge(IndexEntry *a, const IndexEntry& b)
+    {
+        if ((a->box.dimensions.prod() + b.box.dimensions.prod()) > MAX_INDEX_BOX_SIZE) {
+            return false;
+        }
+
+        int mergeDim = -1;
+        for (int d = 0; d < DIM; ++d) {
+            if ((a->box.origin[d] == b.box.origin[d]) &&
+                (a->box.dimensions[d] == b.box.dimensions[d])) {
+                continue;
+            }
+            if (mergeDim != -1) {
+                return false;
+            }
+            mergeDim = d;
+        }
+
+        if (mergeDim == -1) {
+            return false;
+        }
+
+        CoordBox<DIM>& box = a->box;
+        const CoordBox<DIM>& other = b.box;
+        if ((box.origin[mergeDim] + box.dimensions[mergeDim]) == other.origin[mergeDim]) {
+            box.dimensions[mergeDim] += other.dimensions[mergeDim];
+            return true;
+        }
+        if ((other.origin[mergeDim] + other.dimensions[mergeDim]) == box.origin[mergeDim]) {
+            box.origin[mergeDim] = other.origin[mergeDim];
+            box.dimensions[mergeDim] += other.dimensions[mergeDim];
+            return true;
+        }
+
+        return false;
+    }
+
+    static void addBox(std::vector<Streak<DIM> > *streaks, const CoordBox<DIM>& box)
+    {
+        for (typename CoordBox<DIM>::StreakIterator i = box.beginStreak(); i != box.endStreak(); ++i) {
+            streaks->push_back(*i);
+        }
+    }
+
+    static bool offsetLessThan(std::size_t offset, const IndexEntry& entry)
+    {
+        return offset < entry.offset;
+    }
+
+    static bool streakLessThan(const Streak<DIM>& a, const Streak<DIM>& b)
+    {
+        for (int d = DIM - 1; d > 0; --d) {
+            if (a.origin[d] != b.origin[d]) {
+                return a.origin[d] < b.origin[d];
+            }
+        }
+
+        return a.origin.x() < b.origin.x();
+    }
 };
 
 }
@@ -145,6 +145,31 @@ public:
         TS_ASSERT_EQUALS(expectedSorted, actual);
     }
 
+    void testGetRegionAndRebalance()
+    {
+        std::vector<std::size_t> weights;
+        weights << 1000 << 3000 << 123 << 5000 << 877;
+        partition = HilbertPartition(Coord<2>(10, 20), Coord<2>(100, 100), 0, weights);
+        checkRegions();
+
+        weights.clear();
+        weights << 4999 << 1 << 5000;
+        partition.setWeights(weights);
+        checkRegions();
+    }
+
+    void checkRegions()
+    {
+        const std::vector<std::size_t>& weights = partition.getWeights();
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            std::size_t end = start + weights[i];
+            Region<2> expected(partition[start], partition[end]);
+            TS_ASSERT_EQUALS(expected, partition.getRegion(i));
+            start = end;
+        }
+    }
+
 private:
     HilbertPartition partition;
     CoordVector expected, actual;
@@ -180,6 +180,31 @@ public:
         }
     }
 
+    void testGetRegionAndRebalance()
+    {
+        std::vector<std::size_t> weights;
+        weights << 1000 << 200 << 2000 << 1800;
+        HIndexingPartition h(Coord<2>(10, 20), Coord<2>(50, 100), 0, weights);
+        checkRegions(h);
+
+        weights.clear();
+        weights << 2500 << 2500;
+        h.setWeights(weights);
+        checkRegions(h);
+    }
+
+    void checkRegions(const HIndexingPartition& h)
+    {
+        const std::vector<std::size_t>& weights = h.getWeights();
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            std::size_t end = start + weights[i];
+            Region<2> expected(h[start], h[end]);
+            TS_ASSERT_EQUALS(expected, h.getRegion(i));
+            start = end;
+        }
+    }
+
     void testSquareBracketsOperatorForPartialIteration()
     {
         CoordVector expected;
@@ -0,0 +1,163 @@
+#include <libgeodecomp/geometry/partitions/multilevelunstructuredpartition.h>
+#include <libgeodecomp/geometry/partitions/unstructuredstripingpartition.h>
+#include <libgeodecomp/geometry/regionbasedadjacency.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class MultilevelUnstructuredPartitionTest : public CxxTest::TestSuite
+{
+public:
+    typedef SharedPtr<Adjacency>::Type AdjacencyPtr;
+
+    void testEqualWeightsOnScrambledMesh()
+    {
+        int width = 80;
+        int height = 60;
+        int numCells = width * height;
+        AdjacencyPtr adjacency = scrambledMesh(width, height);
+
+        std::vector<std::size_t> weights(4, numCells / 4);
+        MultilevelUnstructuredPartition partition(Coord<1>(0), Coord<1>(numCells), 0, weights, adjacency);
+        UnstructuredStripingPartition striping(Coord<1>(0), Coord<1>(numCells), 0, weights);
+
+        checkCoverage(partition, weights, numCells, 0);
+        checkBalance(partition, weights);
+
+        // an optimal split would cut ~200 edges, striping ~10000:
+        std::size_t cut = edgeCut(partition, weights.size(), *adjacency);
+        TS_ASSERT_LESS_THAN(cut, edgeCut(striping, weights.size(), *adjacency) / 10);
+        TS_ASSERT_LESS_THAN(cut, std::size_t(400));
+    }
+
+    void testUnevenWeights()
+    {
+        int width = 50;
+        int height = 50;
+        int numCells = width * height;
+        AdjacencyPtr adjacency = scrambledMesh(width, height);
+
+        std::vector<std::size_t> weights;
+        weights << 100 << 0 << 1200 << 700 << 500;
+        MultilevelUnstructuredPartition partition(Coord<1>(0), Coord<1>(numCells), 0, weights, adjacency);
+
+        checkCoverage(partition, weights, numCells, 0);
+        checkBalance(partition, weights);
+        TS_ASSERT(partition.getRegion(1).empty());
+    }
+
+    void testNoEdges()
+    {
+        std::vector<std::size_t> weights;
+        weights << 30 << 70;
+        MultilevelUnstructuredPartition partition(Coord<1>(10), Coord<1>(100), 0, weights);
+
+        checkCoverage(partition, weights, 100, 10);
+        checkBalance(partition, weights);
+    }
+
+    void testSinglePart()
+    {
+        int numCells = 400;
+        AdjacencyPtr adjacency = scrambledMesh(20, 20);
+        std::vector<std::size_t> weights(1, numCells);
+        MultilevelUnstructuredPartition partition(Coord<1>(0), Coord<1>(numCells), 0, weights, adjacency);
+
+        Region<1> expected;
+        expected << Streak<1>(Coord<1>(0), numCells);
+        TS_ASSERT_EQUALS(expected, partition.getRegion(0));
+    }
+
+private:
+    /**
+     * A 2D 5-point mesh whose vertex IDs have been permuted so that
+     * naive striping yields a poor decomposition.
+     */
+    AdjacencyPtr scrambledMesh(int width, int height)
+    {
+        int numCells = width * height;
+        AdjacencyPtr ret(new RegionBasedAdjacency());
+
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int id = scramble(y * width + x, numCells);
+                if (x > 0) {
+                    ret->insert(id, scramble(y * width + x - 1, numCells));
+                }
+                if (x < (width - 1)) {
+                    ret->insert(id, scramble(y * width + x + 1, numCells));
+                }
+                if (y > 0) {
+                    ret->insert(id, scramble((y - 1) * width + x, numCells));
+                }
+                if (y < (height - 1)) {
+                    ret->insert(id, scramble((y + 1) * width + x, numCells));
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    int scramble(int index, int numCells)
+    {
+        // 7919 is prime and hence coprime to our mesh sizes:
+        return int((long(index) * 7919) % numCells);
+    }
+
+    void checkCoverage(
+        const Partition<1>& partition,
+        const std::vector<std::size_t>& weights,
+        int numCells,
+        int origin)
+    {
+        Region<1> all;
+        std::size_t totalSize = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            Region<1> region = partition.getRegion(i);
+            all += region;
+            totalSize += region.size();
+        }
+
+        Region<1> expected;
+        expected << Streak<1>(Coord<1>(origin), origin + numCells);
+        TS_ASSERT_EQUALS(expected, all);
+        TS_ASSERT_EQUALS(std::size_t(numCells), totalSize);
+    }
+
+    void checkBalance(const Partition<1>& partition, const std::vector<std::size_t>& weights)
+    {
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            double size = partition.getRegion(i).size();
+            TS_ASSERT_LESS_THAN_EQUALS(size, weights[i] * 1.03 + 1);
+            TS_ASSERT_LESS_THAN_EQUALS(weights[i] * 0.9, size);
+        }
+    }
+
+    std::size_t edgeCut(const Partition<1>& partition, std::size_t numParts, const Adjacency& adjacency)
+    {
+        std::size_t ret = 0;
+        std::vector<int> neighbors;
+
+        for (std::size_t i = 0; i < numParts; ++i) {
+            Region<1> region = partition.getRegion(i);
+            for (Region<1>::Iterator j = region.begin(); j != region.end(); ++j) {
+                neighbors.clear();
+                adjacency.getNeighbors(j->x(), &neighbors);
+                for (std::vector<int>::iterator k = neighbors.begin(); k != neighbors.end(); ++k) {
+                    if (region.count(Coord<1>(*k)) == 0) {
+                        ++ret;
+                    }
+                }
+            }
+        }
+
+        // each cut edge has been counted once from either side:
+        return ret / 2;
+    }
+};
+
+}
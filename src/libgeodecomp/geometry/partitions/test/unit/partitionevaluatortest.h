@@ -0,0 +1,101 @@
+#include <libgeodecomp/geometry/partitions/autopartition.h>
+#include <libgeodecomp/geometry/partitions/checkerboardingpartition.h>
+#include <libgeodecomp/geometry/partitions/partitionevaluator.h>
+#include <libgeodecomp/geometry/partitions/stripingpartition.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class PartitionEvaluatorTest : public CxxTest::TestSuite
+{
+public:
+    typedef SharedPtr<Partition<2> >::Type PartitionPtr;
+
+    void setUp()
+    {
+        box = CoordBox<2>(Coord<2>(), Coord<2>(100, 100));
+        weights = std::vector<std::size_t>(4, 2500);
+        striping.reset(new StripingPartition<2>(box.origin, box.dimensions, 0, weights));
+        checkerboarding.reset(new CheckerboardingPartition<2>(box.origin, box.dimensions, 0, weights));
+    }
+
+    void testStriping()
+    {
+        PartitionEvaluation evaluation = PartitionEvaluator<2>(box)(striping, 4);
+
+        TS_ASSERT_EQUALS(evaluation.maxCells, std::size_t(2500));
+        TS_ASSERT_EQUALS(evaluation.totalCells, std::size_t(10000));
+        TS_ASSERT_EQUALS(evaluation.loadImbalance(4), 0);
+        TS_ASSERT_EQUALS(evaluation.maxGhostVolume, std::size_t(200));
+        TS_ASSERT_EQUALS(evaluation.totalGhostVolume, std::size_t(600));
+        TS_ASSERT_EQUALS(evaluation.maxNeighbors, std::size_t(2));
+        TS_ASSERT_EQUALS(evaluation.totalNeighbors, std::size_t(6));
+        TS_ASSERT_EQUALS(evaluation.cost, 2500 + 200 + 2 * 1000);
+    }
+
+    void testCheckerboardingHonorsStencilAndGhostZoneWidth()
+    {
+        PartitionEvaluation moore = PartitionEvaluator<2>(box)(checkerboarding, 4);
+        TS_ASSERT_EQUALS(moore.maxGhostVolume, std::size_t(101));
+        TS_ASSERT_EQUALS(moore.maxNeighbors, std::size_t(3));
+
+        Region<2> stencil = Region<2>::fromStencil(Stencils::VonNeumann<2, 1>());
+        PartitionEvaluation vonNeumann = PartitionEvaluator<2>(box, 1, stencil)(checkerboarding, 4);
+        TS_ASSERT_EQUALS(vonNeumann.maxGhostVolume, std::size_t(100));
+        TS_ASSERT_EQUALS(vonNeumann.maxNeighbors, std::size_t(2));
+
+        PartitionEvaluation wide = PartitionEvaluator<2>(box, 3)(checkerboarding, 4);
+        TS_ASSERT_EQUALS(wide.maxGhostVolume, std::size_t(3 * 50 + 3 * 50 + 3 * 3));
+    }
+
+    void testSelectBestFollowsCostModel()
+    {
+        std::vector<PartitionPtr> candidates;
+        candidates << checkerboarding
+                   << striping;
+
+        // latency-bound: fewer neighbors win
+        std::vector<PartitionEvaluation> evaluations;
+        PartitionEvaluator<2> latencyBound(box, 1, Region<2>(), PartitionCostModel(1, 1, 1000));
+        TS_ASSERT_EQUALS(latencyBound.selectBest(candidates, 4, &evaluations), std::size_t(1));
+        TS_ASSERT_EQUALS(evaluations.size(), std::size_t(2));
+
+        // bandwidth-bound: smaller halos win
+        PartitionEvaluator<2> bandwidthBound(box, 1, Region<2>(), PartitionCostModel(1, 1, 0));
+        TS_ASSERT_EQUALS(bandwidthBound.selectBest(candidates, 4), std::size_t(0));
+    }
+
+    void testAutoPartition()
+    {
+        Coord<3> dim(64, 64, 64);
+        std::vector<std::size_t> weights3D(8, dim.prod() / 8);
+        AutoPartition<3> partition(Coord<3>(), dim, 0, weights3D);
+
+        TS_ASSERT_EQUALS(partition.candidateNames().size(), std::size_t(4));
+        TS_ASSERT_EQUALS(partition.getEvaluations().size(), std::size_t(4));
+
+        // striping yields the fewest messages, but its halos are
+        // much larger than those of the cubes:
+        TS_ASSERT_DIFFERS(partition.selectedPartition(), "StripingPartition");
+
+        Region<3> all;
+        for (std::size_t i = 0; i < weights3D.size(); ++i) {
+            all += partition.getRegion(i);
+        }
+        TS_ASSERT_EQUALS(all, Region<3>(CoordBox<3>(Coord<3>(), dim)));
+
+        AutoPartition<2> partition2D(box.origin, box.dimensions, 0, weights);
+        TS_ASSERT_EQUALS(partition2D.candidateNames().size(), std::size_t(6));
+    }
+
+private:
+    CoordBox<2> box;
+    std::vector<std::size_t> weights;
+    PartitionPtr striping;
+    PartitionPtr checkerboarding;
+};
+
+}
@@ -186,6 +186,47 @@ public:
         largeTest(Coord<3>(50, 8, 8));
     }
 
+    void testGetRegionAndRebalance()
+    {
+        std::vector<std::size_t> weights;
+        weights << 100 << 4000 << 333 << 1 << 2566;
+        ZCurvePartition<2> partition2D(Coord<2>(10, 20), Coord<2>(70, 100), 0, weights);
+        checkRegions(partition2D);
+
+        weights.clear();
+        weights << 7000;
+        partition2D.setWeights(weights);
+        checkRegions(partition2D);
+
+        weights.clear();
+        weights << 2000 << 2000 << 0 << 3000;
+        partition2D.setWeights(weights);
+        checkRegions(partition2D);
+
+        weights.clear();
+        weights << 1000 << 1700 << 3000 << 4000 << 2300;
+        ZCurvePartition<3> partition3D(Coord<3>(1, 2, 3), Coord<3>(20, 30, 20), 0, weights);
+        checkRegions(partition3D);
+
+        weights.clear();
+        weights << 5000 << 5000 << 2000;
+        partition3D.setWeights(weights);
+        checkRegions(partition3D);
+    }
+
+    template<int DIM>
+    void checkRegions(const ZCurvePartition<DIM>& partition)
+    {
+        const std::vector<std::size_t>& weights = partition.getWeights();
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            std::size_t end = start + weights[i];
+            Region<DIM> expected(partition[start], partition[end]);
+            TS_ASSERT_EQUALS(expected, partition.getRegion(i));
+            start = end;
+        }
+    }
+
 
 private:
     ZCurvePartition<2> partition;
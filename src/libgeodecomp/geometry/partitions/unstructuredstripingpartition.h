@@ -12,7 +12,8 @@ namespace LibGeoDecomp {
  * their numerical ID. This naive strategy will be inefficient for
  * almost all grids, but is useful for some debugging purpoeses. Users
  * are advised to use partitions based on actual graph partitioners,
- * e.g. the PTScotchUnstructuredPartition.
+ * e.g. the PTScotchUnstructuredPartition or, if Scotch is not
+ * available, the MultilevelUnstructuredPartition.
  */
 class UnstructuredStripingPartition : public Partition<1>
 {
@@ -304,9 +304,7 @@ public:
 
     inline Region<DIM> getRegion(const std::size_t node) const
     {
-        return Region<DIM>(
-            (*this)[startOffsets[node + 0]],
-            (*this)[startOffsets[node + 1]]);
+        return this->regionFromIndex(*this, startOffsets[node + 0], startOffsets[node + 1]);
     }
 
     static inline bool fillCaches()
@@ -1,6 +1,7 @@
 #ifndef LIBGEODECOMP_GEOMETRY_REGION_H
 #define LIBGEODECOMP_GEOMETRY_REGION_H
 
+#include <libgeodecomp/config.h>
 #include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/regionstreakiterator.h>
 #include <libgeodecomp/geometry/streak.h>
@@ -10,6 +11,10 @@
 #include <cstddef>
 #include <vector>
 
+#ifdef LIBGEODECOMP_WITH_THREADS
+#include <omp.h>
+#endif
+
 namespace LibGeoDecomp {
 
 template<typename CELL_TYPE, int DIM>
@@ -17,6 +22,9 @@ class BOVOutput;
 
 class RegionTest;
 
+template<int DIM>
+class RegionWireFormat;
+
 namespace RegionHelpers {
 
 /**
@@ -117,10 +125,10 @@ public:
     typedef std::pair<int, int> IntPair;
     typedef std::vector<IntPair> IndexVectorType;
 
-    template<int STREAK_DIM>
+    template<int STREAK_DIM, typename INDEX_ITERATOR>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const Coord<STREAK_DIM>& offset,
         int additionalLength)
     {
@@ -139,10 +147,10 @@ public:
     typedef std::pair<int, int> IntPair;
     typedef std::vector<IntPair> IndexVectorType;
 
-    template<int STREAK_DIM>
+    template<int STREAK_DIM, typename INDEX_ITERATOR>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const Coord<STREAK_DIM>& offset,
         int additionalLength)
     {
@@ -177,10 +185,10 @@ public:
     inline StreakIteratorInitPlaneOffset(StreakIteratorInitPlaneOffset&& other) = default;
 #endif
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& unusedOffsets,
         int unusedAdditionalLength) const
@@ -217,16 +225,16 @@ public:
     inline StreakIteratorInitSingleOffset(StreakIteratorInitSingleOffset&& other) = default;
 #endif
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline std::size_t operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region) const
     {
         StreakIteratorInitSingleOffset<DIM - 1> delegate(offsetIndex);
         std::size_t newOffset = delegate(streak, iterators, region);
 
-        IndexVectorType::const_iterator upperBound = RegionHelpers::upperBound(
+        INDEX_ITERATOR upperBound = RegionHelpers::upperBound(
             region.indicesBegin(DIM),
             region.indicesEnd(DIM),
             IntPair(0, newOffset),
@@ -260,10 +268,10 @@ public:
     inline StreakIteratorInitSingleOffset(StreakIteratorInitSingleOffset&& other) = default;
 #endif
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline std::size_t operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region) const
     {
         iterators[0] = region.indicesBegin(0) + offsetIndex;
@@ -292,10 +300,10 @@ public:
         offsetIndex(offsetIndex)
     {}
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& offset,
         int additionalLength) const
@@ -335,10 +343,10 @@ public:
     inline StreakIteratorInitOffsets(StreakIteratorInitOffsets&& other) = default;
 #endif
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& offset,
         int additionalLength) const
@@ -372,10 +380,10 @@ public:
     inline StreakIteratorInitOffsets(StreakIteratorInitOffsets<0, COORD_DIM>&& other) = default;
 #endif
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& offset,
         int additionalLength) const
@@ -405,10 +413,10 @@ public:
     typedef std::pair<int, int> IntPair;
     typedef std::vector<IntPair> IndexVectorType;
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& offset,
         int additionalLength) const
@@ -428,10 +436,10 @@ public:
     typedef std::pair<int, int> IntPair;
     typedef std::vector<IntPair> IndexVectorType;
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& offset,
         int additionalLength) const
@@ -454,10 +462,10 @@ public:
     typedef std::pair<int, int> IntPair;
     typedef std::vector<IntPair> IndexVectorType;
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM> *streak,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& offset,
         int additionalLength) const
@@ -477,10 +485,10 @@ public:
     typedef std::pair<int, int> IntPair;
     typedef std::vector<IntPair> IndexVectorType;
 
-    template<int STREAK_DIM, typename REGION>
+    template<int STREAK_DIM, typename INDEX_ITERATOR, typename REGION>
     inline void operator()(
         Streak<STREAK_DIM>* /* streak */,
-        IndexVectorType::const_iterator *iterators,
+        INDEX_ITERATOR *iterators,
         const REGION& region,
         const Coord<STREAK_DIM>& /* offset */,
         int /* additionalLength */) const
@@ -592,6 +600,7 @@ public:
     template<int MY_DIM> friend class RegionHelpers::RegionInsertHelper;
     template<int MY_DIM> friend class RegionHelpers::RegionRemoveHelper;
     friend class LibGeoDecomp::RegionTest;
+    friend class RegionWireFormat<DIMENSIONS>;
 
     typedef std::pair<int, int> IntPair;
     typedef std::vector<IntPair> IndexVectorType;
@@ -777,19 +786,39 @@ public:
     }
 
     /**
-     * Generate an expanded Region which contains the neighborhood
-     * specified by the stencil class (see class Stencils).
+     * Yields a Region which contains the relative coordinates of all
+     * neighbors addressed by the stencil class (see class Stencils).
      */
     template<typename STENCIL>
-    inline Region expandWithStencil(STENCIL) const
+    static inline Region fromStencil(STENCIL)
     {
-        Region stencil;
+        Region ret;
 
         Stencils::Repeat<
             STENCIL::VOLUME,
             RegionHelpers::AddCoord,
-            STENCIL>()(&stencil);
+            STENCIL>()(&ret);
+
+        return ret;
+    }
 
+    /**
+     * Generate an expanded Region which contains the neighborhood
+     * specified by the stencil class (see class Stencils).
+     */
+    template<typename STENCIL>
+    inline Region expandWithStencil(STENCIL) const
+    {
+        return expandWithStencil(fromStencil(STENCIL()));
+    }
+
+    /**
+     * Same as above, but the stencil is given as a Region of relative
+     * coordinates, e.g. as generated by fromStencil(). The result is
+     * the Minkowski sum of both Regions.
+     */
+    inline Region expandWithStencil(const Region& stencil) const
+    {
         Region accumulator;
         Region current;
 
@@ -823,16 +852,7 @@ public:
         Coord<DIM> dia = Coord<DIM>::diagonal(width);
         Region buffer = expand(dia);
         Region ret;
-
-        for (StreakIterator i = buffer.beginStreak(); i != buffer.endStreak(); ++i) {
-            Streak<DIM> streak = *i;
-            if (TOPOLOGY::template WrapsAxis<0>::VALUE) {
-                splitStreak<TOPOLOGY>(streak, &ret, globalDimensions);
-            } else {
-                normalizeStreak<TOPOLOGY>(
-                    trimStreak(streak, globalDimensions), &ret, globalDimensions);
-            }
-        }
+        applyTopology<TOPOLOGY>(&buffer, &ret, globalDimensions);
 
         return ret;
     }
@@ -857,6 +877,72 @@ public:
         return expandWithAdjacency(width, adjacency);
     }
 
+    /**
+     * Yields all nested expansions of this Region up to the given
+     * width: element i of the result equals expand(i). Each level is
+     * derived from its predecessor via expandByOne(), so the total
+     * effort is linear in the number of Streaks of all levels.
+     */
+    inline std::vector<Region> expandIncrementally(unsigned width) const
+    {
+        std::vector<Region> ret(width + 1);
+        ret[0] = *this;
+
+        for (unsigned i = 1; i <= width; ++i) {
+            ret[i - 1].expandByOne(&ret[i]);
+        }
+
+        return ret;
+    }
+
+    /**
+     * Topology-aware counterpart of expandIncrementally(): element i
+     * of the result equals element i - 1 expanded via
+     * expandWithTopology(1, globalDimensions, TOPOLOGY()).
+     */
+    template<typename TOPOLOGY>
+    inline std::vector<Region> expandWithTopologyIncrementally(
+        unsigned width,
+        const Coord<DIM>& globalDimensions,
+        TOPOLOGY /* unused */) const
+    {
+        std::vector<Region> ret(width + 1);
+        ret[0] = *this;
+        Region buffer;
+
+        for (unsigned i = 1; i <= width; ++i) {
+            buffer.clear();
+            ret[i - 1].expandByOne(&buffer);
+            applyTopology<TOPOLOGY>(&buffer, &ret[i], globalDimensions);
+        }
+
+        return ret;
+    }
+
+    /**
+     * Counterpart of expandWithTopologyIncrementally() for arbitrary
+     * stencil shapes: element i of the result is element i - 1
+     * expanded by the stencil Region (see expandWithStencil()) and
+     * mapped to the simulation space as defined by TOPOLOGY.
+     */
+    template<typename TOPOLOGY>
+    inline std::vector<Region> expandWithStencilIncrementally(
+        const Region& stencil,
+        unsigned width,
+        const Coord<DIM>& globalDimensions,
+        TOPOLOGY /* unused */) const
+    {
+        std::vector<Region> ret(width + 1);
+        ret[0] = *this;
+
+        for (unsigned i = 1; i <= width; ++i) {
+            Region buffer = ret[i - 1].expandWithStencil(stencil);
+            applyTopology<TOPOLOGY>(&buffer, &ret[i], globalDimensions);
+        }
+
+        return ret;
+    }
+
     /**
      * does the same as expand, but reads adjacent indices out of
      * an adjacency list
@@ -1040,61 +1126,8 @@ public:
      */
     inline Region operator-(const Region& other) const
     {
-        using std::max;
-        using std::min;
         Region ret;
-        // these conditionals are less a shortcut but more a guarantee
-        // that the derefernce below will succeed:
-        if (this->empty()) {
-            return ret;
-        }
-        if (other.empty()) {
-            return *this;
-        }
-
-        StreakIterator myIter = beginStreak();
-        StreakIterator otherIter = other.beginStreak();
-
-        StreakIterator myEnd = endStreak();
-        StreakIterator otherEnd = other.endStreak();
-
-        Streak<DIM> cursor = *myIter;
-
-        for (;;) {
-            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::intersects(cursor, *otherIter)) {
-                int intersectionOriginX = (max)(cursor.origin.x(), otherIter->origin.x());
-                int intersectionEndX = (min)(cursor.endX, otherIter->endX);
-
-                ret << Streak<DIM>(cursor.origin, intersectionOriginX);
-                cursor.origin.x() = intersectionEndX;
-            }
-
-            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(cursor, *otherIter)) {
-                ret << cursor;
-                ++myIter;
-
-                if (myIter == myEnd) {
-                    break;
-                } else {
-                    cursor = *myIter;
-                }
-            } else {
-                ++otherIter;
-                if (otherIter == otherEnd) {
-                    break;
-                }
-            }
-        }
-
-        // don't loose the remainder
-        ret << cursor;
-        if (myIter != myEnd) {
-            ++myIter;
-            for (; myIter != myEnd; ++myIter) {
-                ret << *myIter;
-            }
-        }
-
+        subtract(&ret, beginStreak(), endStreak(), other.beginStreak(), other.endStreak());
         return ret;
     }
 
@@ -1109,35 +1142,8 @@ public:
      */
     inline Region operator&(const Region& other) const
     {
-        using std::max;
-        using std::min;
         Region ret;
-        StreakIterator myIter = beginStreak();
-        StreakIterator otherIter = other.beginStreak();
-
-        StreakIterator myEnd = endStreak();
-        StreakIterator otherEnd = other.endStreak();
-
-        for (;;) {
-            if ((myIter == myEnd) ||
-                (otherIter == otherEnd)) {
-                break;
-            }
-
-            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::intersects(*myIter, *otherIter)) {
-                Streak<DIM> intersection = *myIter;
-                intersection.origin.x() = (max)(myIter->origin.x(), otherIter->origin.x());
-                intersection.endX = (min)(myIter->endX, otherIter->endX);
-                ret << intersection;
-            }
-
-            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*myIter, *otherIter)) {
-                ++myIter;
-            } else {
-                ++otherIter;
-            }
-        }
-
+        intersect(&ret, beginStreak(), endStreak(), other.beginStreak(), other.endStreak());
         return ret;
     }
 
@@ -1216,6 +1222,38 @@ public:
         return ret;
     }
 
+    /**
+     * Multi-threaded equivalent of operator&. See
+     * parallelSetOperation() for how the work is partitioned.
+     */
+    inline Region parallelIntersection(const Region& other, std::size_t numChunks = 0) const
+    {
+        return parallelSetOperation(other, numChunks, &Region::intersect);
+    }
+
+    /**
+     * Multi-threaded equivalent of operator+.
+     */
+    inline Region parallelUnion(const Region& other, std::size_t numChunks = 0) const
+    {
+        if (other.empty()) {
+            return *this;
+        }
+        if (empty()) {
+            return other;
+        }
+
+        return parallelSetOperation(other, numChunks, &Region::unite);
+    }
+
+    /**
+     * Multi-threaded equivalent of operator-.
+     */
+    inline Region parallelDifference(const Region& other, std::size_t numChunks = 0) const
+    {
+        return parallelSetOperation(other, numChunks, &Region::subtract);
+    }
+
     inline std::vector<Streak<DIM> > toVector() const
     {
         std::vector<Streak<DIM> > ret(numStreaks());
@@ -1479,6 +1517,234 @@ private:
         return RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*lastStreakIter, *other.beginStreak());
     }
 
+    typedef void (*SetOperation)(
+        Region *ret,
+        const StreakIterator& beginA, const StreakIterator& endA,
+        const StreakIterator& beginB, const StreakIterator& endB);
+
+    /**
+     * Below this number of Streaks per chunk the overhead of spawning
+     * threads outweighs the speedup of the parallel set operations.
+     */
+    static const std::size_t MIN_STREAKS_PER_CHUNK = 4096;
+
+    /**
+     * Splits the outermost dimension's index range into numChunks
+     * slices (balanced by the number of planes in this Region) and
+     * applies the set operation to each slice independently. As no
+     * Streak can cross a plane boundary, the partial results can
+     * simply be concatenated. Setting numChunks to 0 will select a
+     * chunk count based on the number of available threads and the
+     * size of the operands. 1D Regions can't be split this way and
+     * are always handled sequentially.
+     */
+    inline Region parallelSetOperation(
+        const Region& other,
+        std::size_t numChunks,
+        SetOperation operation) const
+    {
+        using std::min;
+
+        if (numChunks == 0) {
+            numChunks = defaultNumChunks(numStreaks() + other.numStreaks());
+        }
+        numChunks = (min)(numChunks, numPlanes());
+
+        Region ret;
+        if ((DIM == 1) || (numChunks < 2)) {
+            operation(&ret, beginStreak(), endStreak(), other.beginStreak(), other.endStreak());
+            return ret;
+        }
+
+        std::vector<Region> chunks(numChunks);
+        int numChunksInt = int(numChunks);
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < numChunksInt; ++i) {
+            std::size_t chunk = std::size_t(i);
+            std::size_t myBegin = numPlanes() * (chunk + 0) / numChunks;
+            std::size_t myEnd   = numPlanes() * (chunk + 1) / numChunks;
+            // the first and last chunk need to include all of the
+            // other Region's planes which lie before/after ours:
+            std::size_t otherBegin = 0;
+            std::size_t otherEnd = other.numPlanes();
+
+            if (chunk > 0) {
+                otherBegin = other.planeOnOrAfter(indices[DIM - 1][myBegin].first);
+            }
+            if (chunk < (numChunks - 1)) {
+                otherEnd = other.planeOnOrAfter(indices[DIM - 1][myEnd].first);
+            }
+
+            operation(
+                &chunks[chunk],
+                planeStreakIterator(myBegin),
+                planeStreakIterator(myEnd),
+                other.planeStreakIterator(otherBegin),
+                other.planeStreakIterator(otherEnd));
+        }
+
+        for (int d = 0; d < DIM; ++d) {
+            std::size_t size = 0;
+            for (std::size_t i = 0; i < numChunks; ++i) {
+                size += chunks[i].indices[d].size();
+            }
+            ret.indices[d].reserve(size);
+        }
+        for (std::size_t i = 0; i < numChunks; ++i) {
+            ret.concat(chunks[i]);
+        }
+
+        return ret;
+    }
+
+    inline static std::size_t defaultNumChunks(std::size_t numStreaks)
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        using std::min;
+        return (min)(std::size_t(omp_get_max_threads()), numStreaks / MIN_STREAKS_PER_CHUNK);
+#else
+        return 1;
+#endif
+    }
+
+    /**
+     * Returns the index of the first plane whose coordinate in the
+     * outermost dimension is equal or larger than the given value.
+     */
+    inline std::size_t planeOnOrAfter(int coord) const
+    {
+        IndexVectorType::const_iterator i = RegionHelpers::lowerBound(
+            indices[DIM - 1].begin(),
+            indices[DIM - 1].end(),
+            IntPair(coord, 0),
+            RegionHelpers::RegionCommonHelper::pairCompareFirst);
+
+        return std::size_t(i - indices[DIM - 1].begin());
+    }
+
+    /**
+     * Appends the other Region, assuming that all of its Streaks are
+     * located in planes succeeding our last plane.
+     */
+    inline void concat(const Region& other)
+    {
+        for (int d = DIM - 1; d >= 0; --d) {
+            int offset = (d > 0) ? int(indices[d - 1].size()) : 0;
+            for (IndexVectorType::const_iterator i = other.indices[d].begin();
+                 i != other.indices[d].end();
+                 ++i) {
+                indices[d].push_back(IntPair(i->first, i->second + offset));
+            }
+        }
+
+        geometryCacheTainted = true;
+    }
+
+    inline static void intersect(
+        Region *ret,
+        const StreakIterator& beginA, const StreakIterator& endA,
+        const StreakIterator& beginB, const StreakIterator& endB)
+    {
+        using std::max;
+        using std::min;
+        StreakIterator myIter = beginA;
+        StreakIterator otherIter = beginB;
+
+        for (;;) {
+            if ((myIter == endA) ||
+                (otherIter == endB)) {
+                break;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::intersects(*myIter, *otherIter)) {
+                Streak<DIM> intersection = *myIter;
+                intersection.origin.x() = (max)(myIter->origin.x(), otherIter->origin.x());
+                intersection.endX = (min)(myIter->endX, otherIter->endX);
+                *ret << intersection;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*myIter, *otherIter)) {
+                ++myIter;
+            } else {
+                ++otherIter;
+            }
+        }
+    }
+
+    /**
+     * Equvalent to (A and (not B)) in sets.
+     */
+    inline static void subtract(
+        Region *ret,
+        const StreakIterator& beginA, const StreakIterator& endA,
+        const StreakIterator& beginB, const StreakIterator& endB)
+    {
+        using std::max;
+        using std::min;
+        // these conditionals are less a shortcut but more a guarantee
+        // that the derefernce below will succeed:
+        if (beginA == endA) {
+            return;
+        }
+        if (beginB == endB) {
+            for (StreakIterator i = beginA; i != endA; ++i) {
+                *ret << *i;
+            }
+            return;
+        }
+
+        StreakIterator myIter = beginA;
+        StreakIterator otherIter = beginB;
+
+        Streak<DIM> cursor = *myIter;
+
+        for (;;) {
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::intersects(cursor, *otherIter)) {
+                int intersectionOriginX = (max)(cursor.origin.x(), otherIter->origin.x());
+                int intersectionEndX = (min)(cursor.endX, otherIter->endX);
+
+                *ret << Streak<DIM>(cursor.origin, intersectionOriginX);
+                cursor.origin.x() = intersectionEndX;
+            }
+
+            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(cursor, *otherIter)) {
+                *ret << cursor;
+                ++myIter;
+
+                if (myIter == endA) {
+                    break;
+                } else {
+                    cursor = *myIter;
+                }
+            } else {
+                ++otherIter;
+                if (otherIter == endB) {
+                    break;
+                }
+            }
+        }
+
+        // don't loose the remainder
+        *ret << cursor;
+        if (myIter != endA) {
+            ++myIter;
+            for (; myIter != endA; ++myIter) {
+                *ret << *myIter;
+            }
+        }
+    }
+
+    inline static void unite(
+        Region *ret,
+        const StreakIterator& beginA, const StreakIterator& endA,
+        const StreakIterator& beginB, const StreakIterator& endB)
+    {
+        merge2way(*ret, beginA, endA, beginB, endB);
+    }
+
     inline static void merge2way(
         Region& ret,
         const StreakIterator& beginA, const StreakIterator& endA,
@@ -1629,6 +1895,133 @@ private:
         geometryCacheTainted = false;
     }
 
+    /**
+     * Minkowski sum of this Region and the unit box, equivalent to
+     * expand(1). Instead of expanding one dimension after another, we
+     * sweep over the 3^(DIM-1) neighboring rows of each output row in
+     * lockstep. This way no intermediate Regions need to be built and
+     * every Streak is read a constant number of times.
+     */
+    inline void expandByOne(Region *target) const
+    {
+        using std::max;
+        int numNeighbors = 1;
+        for (int d = 1; d < DIM; ++d) {
+            numNeighbors *= 3;
+        }
+
+        std::vector<StreakIterator> iterators;
+        std::vector<StreakIterator> ends;
+        iterators.reserve(numNeighbors);
+        ends.reserve(numNeighbors);
+
+        for (int i = 0; i < numNeighbors; ++i) {
+            Coord<DIM> offset;
+            offset.x() = -1;
+            int index = i;
+            for (int d = 1; d < DIM; ++d) {
+                offset[d] = index % 3 - 1;
+                index /= 3;
+            }
+
+            iterators.push_back(beginStreak(offset, 2));
+            ends.push_back(endStreak(offset, 2));
+        }
+
+        std::vector<IntPair> row;
+
+        for (;;) {
+            int next = -1;
+            for (int i = 0; i < numNeighbors; ++i) {
+                if ((iterators[i] != ends[i]) &&
+                    ((next == -1) || rowLessThan(*iterators[i], *iterators[next]))) {
+                    next = i;
+                }
+            }
+            if (next == -1) {
+                break;
+            }
+
+            Streak<DIM> cursor = *iterators[next];
+            row.clear();
+            for (int i = 0; i < numNeighbors; ++i) {
+                for (; (iterators[i] != ends[i]) && sameRow(*iterators[i], cursor); ++iterators[i]) {
+                    row.push_back(IntPair(iterators[i]->origin.x(), iterators[i]->endX));
+                }
+            }
+
+            // rows typically hold very few Streaks, so sorting is cheap:
+            std::sort(row.begin(), row.end());
+            cursor.origin.x() = row[0].first;
+            cursor.endX = row[0].second;
+
+            for (std::vector<IntPair>::iterator i = row.begin() + 1; i != row.end(); ++i) {
+                if (i->first > cursor.endX) {
+                    *target << cursor;
+                    cursor.origin.x() = i->first;
+                }
+                cursor.endX = (max)(cursor.endX, i->second);
+            }
+            *target << cursor;
+        }
+    }
+
+    inline static bool rowLessThan(const Streak<DIM>& a, const Streak<DIM>& b)
+    {
+        for (int d = DIM - 1; d > 0; --d) {
+            if (a.origin[d] != b.origin[d]) {
+                return a.origin[d] < b.origin[d];
+            }
+        }
+
+        return false;
+    }
+
+    inline static bool sameRow(const Streak<DIM>& a, const Streak<DIM>& b)
+    {
+        for (int d = DIM - 1; d > 0; --d) {
+            if (a.origin[d] != b.origin[d]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Maps all Streaks of the source Region to the simulation space
+     * as defined by TOPOLOGY and globalDimensions (wrapping around
+     * periodic boundaries, cutting off at others). The source Region
+     * is just moved to the target if it fits the simulation space
+     * anyway.
+     */
+    template<typename TOPOLOGY>
+    inline void applyTopology(
+        Region *source,
+        Region *target,
+        const Coord<DIM>& globalDimensions) const
+    {
+        using std::swap;
+        CoordBox<DIM> globalBox(Coord<DIM>(), globalDimensions);
+        const CoordBox<DIM>& box = source->boundingBox();
+        if (source->empty() ||
+            (globalBox.inBounds(box.origin) &&
+             globalBox.inBounds(box.origin + box.dimensions - Coord<DIM>::diagonal(1)))) {
+            swap(*source, *target);
+            return;
+        }
+
+        for (StreakIterator i = source->beginStreak(); i != source->endStreak(); ++i) {
+            Streak<DIM> streak = *i;
+            if (TOPOLOGY::template WrapsAxis<0>::VALUE) {
+                splitStreak<TOPOLOGY>(streak, target, globalDimensions);
+            } else {
+                normalizeStreak<TOPOLOGY>(
+                    trimStreak(streak, globalDimensions), target, globalDimensions);
+            }
+        }
+    }
+
     inline Streak<DIM> trimStreak(
         const Streak<DIM>& s,
         const Coord<DIM>& dimensions) const
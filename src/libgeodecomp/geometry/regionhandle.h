@@ -0,0 +1,219 @@
+#ifndef LIBGEODECOMP_GEOMETRY_REGIONHANDLE_H
+#define LIBGEODECOMP_GEOMETRY_REGIONHANDLE_H
+
+#include <libgeodecomp/geometry/region.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace LibGeoDecomp {
+
+namespace RegionHandleHelpers {
+
+/**
+ * Mixes value into seed, equivalent to boost::hash_combine().
+ */
+inline void hashCombine(std::size_t *seed, std::size_t value)
+{
+    *seed ^= value + 0x9e3779b9 + (*seed << 6) + (*seed >> 2);
+}
+
+}
+
+/**
+ * RegionHandle is an immutable, reference counted view of a Region.
+ * All handles are interned: the constructor looks up a process-wide
+ * pool and reuses any Region with the same set of coordinates. Hence
+ * identical Regions (e.g. the rims of multiple PatchLinks) are stored
+ * only once, copying a handle boils down to a refcount increment,
+ * and operator== is a mere pointer comparison. The hash is computed
+ * once on construction.
+ *
+ * Interning costs one pass over the Region's streaks plus, on a hash
+ * hit, one full comparison, so handles are meant for Regions which
+ * are set up once and kept for a long time.
+ */
+template<int DIM>
+class RegionHandle
+{
+public:
+    typedef Region<DIM> RegionType;
+
+    /**
+     * Functor for std::unordered_map and friends.
+     */
+    class Hash
+    {
+    public:
+        inline std::size_t operator()(const RegionHandle& handle) const
+        {
+            return handle.hash();
+        }
+    };
+
+    inline RegionHandle() :
+        entry(intern(RegionType()))
+    {}
+
+    inline explicit RegionHandle(const RegionType& region) :
+        entry(intern(region))
+    {}
+
+    inline const RegionType& operator*() const
+    {
+        return entry->region;
+    }
+
+    inline const RegionType *operator->() const
+    {
+        return &entry->region;
+    }
+
+    inline std::size_t hash() const
+    {
+        return entry->hash;
+    }
+
+    inline bool operator==(const RegionHandle& other) const
+    {
+        return entry == other.entry;
+    }
+
+    inline bool operator!=(const RegionHandle& other) const
+    {
+        return entry != other.entry;
+    }
+
+    /**
+     * Number of distinct Regions currently referenced by handles of
+     * this dimension.
+     */
+    static std::size_t poolSize()
+    {
+        Pool& p = pool();
+        std::lock_guard<std::mutex> lock(p.mutex);
+        p.sweep();
+        return p.entries.size();
+    }
+
+    static std::size_t computeHash(const RegionType& region)
+    {
+        std::size_t ret = region.size();
+        for (typename RegionType::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            for (int d = 0; d < DIM; ++d) {
+                RegionHandleHelpers::hashCombine(&ret, std::size_t(i->origin[d]));
+            }
+            RegionHandleHelpers::hashCombine(&ret, std::size_t(i->endX));
+        }
+
+        return ret;
+    }
+
+private:
+    class Entry
+    {
+    public:
+        inline explicit Entry(const RegionType& region, std::size_t hash) :
+            region(region),
+            hash(hash)
+        {
+            // the Region is shared between threads, so its lazily
+            // updated geometry cache must not be tainted:
+            this->region.boundingBox();
+        }
+
+        const RegionType region;
+        const std::size_t hash;
+    };
+
+    typedef std::shared_ptr<const Entry> EntryPtr;
+    typedef std::weak_ptr<const Entry> WeakEntryPtr;
+    typedef std::unordered_multimap<std::size_t, WeakEntryPtr> EntryMap;
+
+    /**
+     * The pool holds only weak references, so a Region is released
+     * as soon as its last handle is gone. Expired slots are purged
+     * during lookups and by an amortized sweep whenever the map has
+     * doubled in size.
+     */
+    class Pool
+    {
+    public:
+        inline Pool() :
+            sweepThreshold(MIN_SWEEP_THRESHOLD)
+        {}
+
+        void sweep()
+        {
+            for (typename EntryMap::iterator i = entries.begin(); i != entries.end();) {
+                if (i->second.expired()) {
+                    i = entries.erase(i);
+                } else {
+                    ++i;
+                }
+            }
+
+            sweepThreshold = (std::max)(MIN_SWEEP_THRESHOLD, 2 * entries.size());
+        }
+
+        std::mutex mutex;
+        EntryMap entries;
+        std::size_t sweepThreshold;
+
+    private:
+        static const std::size_t MIN_SWEEP_THRESHOLD = 64;
+    };
+
+    EntryPtr entry;
+
+    static Pool& pool()
+    {
+        static Pool instance;
+        return instance;
+    }
+
+    static EntryPtr intern(const RegionType& region)
+    {
+        std::size_t hash = computeHash(region);
+        Pool& p = pool();
+        std::lock_guard<std::mutex> lock(p.mutex);
+
+        typedef typename EntryMap::iterator Iterator;
+        std::pair<Iterator, Iterator> range = p.entries.equal_range(hash);
+        for (Iterator i = range.first; i != range.second;) {
+            EntryPtr candidate = i->second.lock();
+            if (!candidate) {
+                i = p.entries.erase(i);
+                continue;
+            }
+            if (candidate->region == region) {
+                return candidate;
+            }
+            ++i;
+        }
+
+        // not using make_shared here as that would tie the Region's
+        // memory to the lifetime of the pool's weak reference:
+        EntryPtr ret(new Entry(region, hash));
+        p.entries.insert(std::make_pair(hash, WeakEntryPtr(ret)));
+        if (p.entries.size() > p.sweepThreshold) {
+            p.sweep();
+        }
+
+        return ret;
+    }
+};
+
+template<typename _CharT, typename _Traits, int DIM>
+std::basic_ostream<_CharT, _Traits>&
+operator<<(std::basic_ostream<_CharT, _Traits>& __os,
+           const RegionHandle<DIM>& handle)
+{
+    __os << *handle;
+    return __os;
+}
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define LIBGEODECOMP_GEOMETRY_REGIONSTREAKITERATOR_H
 
 #include <algorithm>
+#include <vector>
 #include <libgeodecomp/geometry/streak.h>
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
 
@@ -17,12 +18,10 @@ template<int DIM>
 class Compare
 {
 public:
-    typedef std::pair<int, int> IntPair;
-    typedef std::vector<IntPair> IndexVectorType;
-
+    template<typename INDEX_ITERATOR>
     inline bool operator()(
-        const IndexVectorType::const_iterator *a,
-        const IndexVectorType::const_iterator *b)
+        const INDEX_ITERATOR *a,
+        const INDEX_ITERATOR *b)
     {
         if (a[DIM] != b[DIM]) {
             return false;
@@ -39,12 +38,10 @@ template<>
 class Compare<0>
 {
 public:
-    typedef std::pair<int, int> IntPair;
-    typedef std::vector<IntPair> IndexVectorType;
-
+    template<typename INDEX_ITERATOR>
     inline bool operator()(
-        const IndexVectorType::const_iterator *a,
-        const IndexVectorType::const_iterator *b)
+        const INDEX_ITERATOR *a,
+        const INDEX_ITERATOR *b)
     {
         return a[0] == b[0];
     }
@@ -58,21 +55,26 @@ public:
  * inner loop for iteration through the Streak) reduces the effective
  * overhead. It also preserves the original runlenght coding within
  * the Region.
+ *
+ * INDEX_ITERATOR is the type of the iterators into REGION's per
+ * dimension index vectors. It defaults to the plain std::vector used
+ * by Region, but compressed storage backends (see CompressedRegion)
+ * may supply their own random access iterator.
  */
-template<int DIM, typename REGION>
+template<int DIM, typename REGION, typename INDEX_ITERATOR = std::vector<std::pair<int, int> >::const_iterator>
 class RegionStreakIterator : public std::iterator<std::forward_iterator_tag, const Streak<DIM> >
 {
 public:
-    template<typename REGION_TYPE>
-    friend Coord<DIM> operator-(const RegionStreakIterator<DIM, REGION_TYPE>& a,
-                                const RegionStreakIterator<DIM, REGION_TYPE>& b);
+    template<typename REGION_TYPE, typename INDEX_ITERATOR_TYPE>
+    friend Coord<DIM> operator-(const RegionStreakIterator<DIM, REGION_TYPE, INDEX_ITERATOR_TYPE>& a,
+                                const RegionStreakIterator<DIM, REGION_TYPE, INDEX_ITERATOR_TYPE>& b);
 
     template<int> friend class InitIterators;
     template<int> friend class Region;
     friend class RegionStreakIteratorTest;
 
     typedef std::pair<int, int> IntPair;
-    typedef std::vector<IntPair> IndexVectorType;
+    typedef INDEX_ITERATOR IndexIterator;
 
     template<typename INIT_HELPER>
     inline RegionStreakIterator(
@@ -109,10 +111,12 @@ public:
                 return;
             }
 
-            IndexVectorType::const_iterator nextEnd =
-                region->indicesBegin(std::size_t(i - 1)) + (iterators[i] + 1)->second;
+            // comparing offsets instead of iterators saves us from
+            // constructing a new iterator, which is costly for
+            // compressed index vectors:
+            std::ptrdiff_t nextEnd = (iterators[i] + 1)->second;
 
-            if (iterators[i - 1] != nextEnd) {
+            if ((iterators[i - 1] - region->indicesBegin(std::size_t(i - 1))) != nextEnd) {
                 return;
             }
 
@@ -156,33 +160,33 @@ protected:
     Streak<DIM> streak;
 
 private:
-    IndexVectorType::const_iterator iterators[DIM];
+    IndexIterator iterators[DIM];
     Coord<DIM> offset;
     int additionalLength;
     const REGION *region;
 };
 
-template<typename REGION>
+template<typename REGION, typename INDEX_ITERATOR>
 inline Coord<1> operator-(
-    const RegionStreakIterator<1, REGION>& a,
-    const RegionStreakIterator<1, REGION>& b)
+    const RegionStreakIterator<1, REGION, INDEX_ITERATOR>& a,
+    const RegionStreakIterator<1, REGION, INDEX_ITERATOR>& b)
 {
     return Coord<1>(a.iterators[0] - b.iterators[0]);
 }
 
-template<typename REGION>
+template<typename REGION, typename INDEX_ITERATOR>
 inline Coord<2> operator-(
-    const RegionStreakIterator<2, REGION>& a,
-    const RegionStreakIterator<2, REGION>& b)
+    const RegionStreakIterator<2, REGION, INDEX_ITERATOR>& a,
+    const RegionStreakIterator<2, REGION, INDEX_ITERATOR>& b)
 {
     return Coord<2>(a.iterators[0] - b.iterators[0],
                     a.iterators[1] - b.iterators[1]);
 }
 
-template<typename REGION>
+template<typename REGION, typename INDEX_ITERATOR>
 inline Coord<3> operator-(
-    const RegionStreakIterator<3, REGION>& a,
-    const RegionStreakIterator<3, REGION>& b)
+    const RegionStreakIterator<3, REGION, INDEX_ITERATOR>& a,
+    const RegionStreakIterator<3, REGION, INDEX_ITERATOR>& b)
 {
     return Coord<3>(a.iterators[0] - b.iterators[0],
                     a.iterators[1] - b.iterators[1],
@@ -0,0 +1,175 @@
+#ifndef LIBGEODECOMP_GEOMETRY_REGIONTILING_H
+#define LIBGEODECOMP_GEOMETRY_REGIONTILING_H
+
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/streak.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * RegionTiling cuts a Region into rectangular tiles (2D) or bricks
+ * (3D) of a fixed size and orders these along a Z-order (Morton)
+ * space-filling curve. Streaks are split at tile boundaries, so each
+ * tile is a self-contained work package for the UpdateFunctor. As
+ * neighboring tiles on the curve are neighbors in space, a thread
+ * which processes consecutive tiles finds the y/z neighbor lines of
+ * its stencil mostly in its cache -- unlike plane-wise scheduling,
+ * which streams whole planes per thread.
+ *
+ * Tile boundaries are aligned to multiples of the tile dimensions in
+ * absolute coordinates. Within a tile, Streaks retain the Region's
+ * order.
+ */
+template<int DIM>
+class RegionTiling
+{
+public:
+    typedef typename std::vector<Streak<DIM> >::const_iterator StreakIterator;
+
+    /**
+     * Tile width along the x-axis will be a multiple of this, so
+     * that updateLineX() can be vectorized efficiently.
+     */
+    static const int LINE_GRANULARITY = 64;
+
+    RegionTiling(const Region<DIM>& region, const Coord<DIM>& tileDimensions) :
+        tileDimensions(tileDimensions)
+    {
+        if (region.empty()) {
+            tileOffsets << 0;
+            return;
+        }
+
+        Coord<DIM> originTile = tileIndex(region.boundingBox().origin);
+        std::vector<TileStreak> tileStreaks;
+        tileStreaks.reserve(region.numStreaks());
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            Streak<DIM> streak = *i;
+            while (streak.length() > 0) {
+                Coord<DIM> tile = tileIndex(streak.origin);
+                Streak<DIM> tranche = streak;
+                tranche.endX = (std::min)(streak.endX, (tile.x() + 1) * tileDimensions.x());
+
+                tileStreaks << TileStreak(mortonKey(tile - originTile), tileStreaks.size(), tranche);
+                streak.origin.x() = tranche.endX;
+            }
+        }
+
+        std::sort(tileStreaks.begin(), tileStreaks.end());
+
+        streaks.reserve(tileStreaks.size());
+        for (std::size_t i = 0; i < tileStreaks.size(); ++i) {
+            if ((i == 0) || (tileStreaks[i].key != tileStreaks[i - 1].key)) {
+                tileOffsets << i;
+            }
+            streaks << tileStreaks[i].streak;
+        }
+        tileOffsets << streaks.size();
+    }
+
+    /**
+     * Suggests tile dimensions for which one tile of cells of the
+     * given size fits into cacheSize bytes. The x-extent is kept
+     * at least at LINE_GRANULARITY cells, the remaining budget is
+     * spread evenly among the other axes.
+     */
+    static Coord<DIM> defaultTileDimensions(std::size_t cellSize, std::size_t cacheSize = 1 << 18)
+    {
+        double cells = (std::max)(std::size_t(1), cacheSize / (std::max)(std::size_t(1), cellSize));
+        int edge = std::pow(cells, 1.0 / DIM);
+        int width = (edge + LINE_GRANULARITY - 1) / LINE_GRANULARITY * LINE_GRANULARITY;
+
+        Coord<DIM> ret = Coord<DIM>::diagonal(1);
+        ret.x() = (std::max)(width, int(LINE_GRANULARITY));
+        if (DIM > 1) {
+            int remainder = std::pow((std::max)(1.0, cells / ret.x()), 1.0 / (DIM - 1));
+            for (int d = 1; d < DIM; ++d) {
+                ret[d] = (std::max)(1, remainder);
+            }
+        }
+
+        return ret;
+    }
+
+    std::size_t numTiles() const
+    {
+        return tileOffsets.size() - 1;
+    }
+
+    StreakIterator beginTile(std::size_t tile) const
+    {
+        return streaks.begin() + tileOffsets[tile];
+    }
+
+    StreakIterator endTile(std::size_t tile) const
+    {
+        return streaks.begin() + tileOffsets[tile + 1];
+    }
+
+    const Coord<DIM>& getTileDimensions() const
+    {
+        return tileDimensions;
+    }
+
+private:
+    class TileStreak
+    {
+    public:
+        TileStreak(uint64_t key, std::size_t index, const Streak<DIM>& streak) :
+            key(key),
+            index(index),
+            streak(streak)
+        {}
+
+        bool operator<(const TileStreak& other) const
+        {
+            return (key < other.key) || ((key == other.key) && (index < other.index));
+        }
+
+        uint64_t key;
+        std::size_t index;
+        Streak<DIM> streak;
+    };
+
+    Coord<DIM> tileDimensions;
+    std::vector<Streak<DIM> > streaks;
+    std::vector<std::size_t> tileOffsets;
+
+    Coord<DIM> tileIndex(const Coord<DIM>& coord) const
+    {
+        Coord<DIM> ret;
+        for (int d = 0; d < DIM; ++d) {
+            // round towards negative infinity:
+            int c = coord[d];
+            int t = tileDimensions[d];
+            ret[d] = (c >= 0) ? (c / t) : -((t - 1 - c) / t);
+        }
+        return ret;
+    }
+
+    /**
+     * Interleaves the bits of the (non-negative) tile indices.
+     */
+    static uint64_t mortonKey(const Coord<DIM>& tile)
+    {
+        const int bits = (std::min)(64 / DIM, 31);
+        uint64_t key = 0;
+        for (int bit = 0; bit < bits; ++bit) {
+            for (int d = 0; d < DIM; ++d) {
+                key |= uint64_t((tile[d] >> bit) & 1) << (bit * DIM + d);
+            }
+        }
+        return key;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef LIBGEODECOMP_GEOMETRY_REGIONWIREFORMAT_H
+#define LIBGEODECOMP_GEOMETRY_REGIONWIREFORMAT_H
+
+#include <libgeodecomp/geometry/region.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * RegionWireFormat converts a Region into a compact byte stream and
+ * back, e.g. for shipping it via MPI. Instead of a list of Streaks it
+ * transmits the Region's internal index vectors directly. Each entry
+ * is stored as the difference to its predecessor, encoded as a
+ * variable length integer (7 bits per byte, MSB flags continuation).
+ * Signed differences (coordinates) are zigzag encoded to keep small
+ * negative values short. Boxes and other regular shapes thus need
+ * roughly 2-3 bytes per index pair instead of 4 * (DIM + 1) bytes per
+ * Streak.
+ *
+ * Layout: for each dimension d in [0, DIM) the number of pairs in
+ * indices[d], followed by the pairs themselves. For d = 0 a pair
+ * (origin, end) is encoded as (origin - previous origin, end -
+ * origin), for d > 0 a pair (coord, offset) as (coord - previous
+ * coord, offset - previous offset).
+ */
+template<int DIM>
+class RegionWireFormat
+{
+public:
+    typedef std::vector<char> BufferType;
+    typedef typename Region<DIM>::IndexVectorType IndexVectorType;
+
+    /**
+     * Replaces the contents of buffer by the encoded Region.
+     */
+    static void encode(const Region<DIM>& region, BufferType *buffer)
+    {
+        buffer->clear();
+
+        for (int d = 0; d < DIM; ++d) {
+            const IndexVectorType& indices = region.indices[d];
+            putUnsigned(buffer, indices.size());
+
+            int lastFirst = 0;
+            int lastSecond = 0;
+            for (typename IndexVectorType::const_iterator i = indices.begin(); i != indices.end(); ++i) {
+                putSigned(buffer, i->first - lastFirst);
+                if (d == 0) {
+                    putUnsigned(buffer, std::size_t(i->second - i->first));
+                } else {
+                    putUnsigned(buffer, std::size_t(i->second - lastSecond));
+                }
+
+                lastFirst = i->first;
+                lastSecond = i->second;
+            }
+        }
+    }
+
+    /**
+     * Overwrites region with the contents of the first size bytes of
+     * data. Throws if the data is truncated or otherwise malformed.
+     */
+    static void decode(Region<DIM> *region, const char *data, std::size_t size)
+    {
+        region->clear();
+        const char *end = data + size;
+
+        for (int d = 0; d < DIM; ++d) {
+            IndexVectorType& indices = region->indices[d];
+            std::size_t length = getUnsigned(&data, end);
+            if (length > std::size_t(end - data)) {
+                // each pair takes at least two bytes, so this is
+                // certainly garbage and we shouldn't allocate for it:
+                throw std::logic_error("RegionWireFormat: invalid number of index pairs");
+            }
+            indices.reserve(length);
+
+            int lastFirst = 0;
+            int lastSecond = 0;
+            for (std::size_t i = 0; i < length; ++i) {
+                int first = lastFirst + getSigned(&data, end);
+                int second;
+                if (d == 0) {
+                    second = first + int(getUnsigned(&data, end));
+                } else {
+                    second = lastSecond + int(getUnsigned(&data, end));
+                }
+
+                indices.push_back(std::make_pair(first, second));
+                lastFirst = first;
+                lastSecond = second;
+            }
+        }
+
+        if (data != end) {
+            throw std::logic_error("RegionWireFormat: trailing bytes after Region");
+        }
+
+        region->geometryCacheTainted = true;
+    }
+
+    static void decode(Region<DIM> *region, const BufferType& buffer)
+    {
+        decode(region, buffer.empty() ? 0 : &buffer[0], buffer.size());
+    }
+
+private:
+    static inline void putUnsigned(BufferType *buffer, std::size_t value)
+    {
+        while (value >= 0x80) {
+            buffer->push_back(char((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        buffer->push_back(char(value));
+    }
+
+    static inline void putSigned(BufferType *buffer, int value)
+    {
+        // zigzag encoding maps 0, -1, 1, -2, 2... to 0, 1, 2, 3, 4...
+        unsigned zigzag = (unsigned(value) << 1) ^ unsigned(value >> 31);
+        putUnsigned(buffer, zigzag);
+    }
+
+    static inline std::size_t getUnsigned(const char **cursor, const char *end)
+    {
+        std::size_t ret = 0;
+        for (int shift = 0; shift < int(sizeof(std::size_t) * 8); shift += 7) {
+            if (*cursor == end) {
+                throw std::logic_error("RegionWireFormat: buffer truncated");
+            }
+
+            unsigned char byte = static_cast<unsigned char>(**cursor);
+            ++*cursor;
+            ret |= std::size_t(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return ret;
+            }
+        }
+
+        throw std::logic_error("RegionWireFormat: varint too long");
+    }
+
+    static inline int getSigned(const char **cursor, const char *end)
+    {
+        unsigned zigzag = unsigned(getUnsigned(cursor, end));
+        return int(zigzag >> 1) ^ -int(zigzag & 1);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef LIBGEODECOMP_GEOMETRY_STREAKSCHEDULE_H
+#define LIBGEODECOMP_GEOMETRY_STREAKSCHEDULE_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/streak.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+
+#include <map>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Splits a Region into work packages (tasks) for parallel updates.
+ * If granularity is positive, each task is a single Streak of at
+ * most granularity cells, split just like in the fine grained OpenMP
+ * schedule of the UpdateFunctor. Otherwise each task comprises all
+ * Streaks of one plane.
+ */
+template<int DIM>
+class StreakSchedule
+{
+public:
+    typedef typename std::vector<Streak<DIM> >::const_iterator StreakIterator;
+
+    explicit StreakSchedule(const Region<DIM>& region = Region<DIM>(), int granularity = 0)
+    {
+        reset(region, granularity);
+    }
+
+    void reset(const Region<DIM>& newRegion, int newGranularity)
+    {
+        region = newRegion;
+        granularity = newGranularity;
+        streaks.clear();
+        taskOffsets.clear();
+        streaks.reserve(region.numStreaks());
+
+        if (granularity > 0) {
+            for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+                Streak<DIM> s = *i;
+                while (s.length() > granularity) {
+                    Streak<DIM> tranche = s;
+                    tranche.endX = s.origin.x() + granularity - (s.origin.x() % granularity);
+                    taskOffsets << streaks.size();
+                    streaks << tranche;
+                    s.origin.x() = tranche.endX;
+                }
+                taskOffsets << streaks.size();
+                streaks << s;
+            }
+        } else {
+            for (std::size_t c = 0; c < region.numPlanes(); ++c) {
+                taskOffsets << streaks.size();
+                typename Region<DIM>::StreakIterator end = region.planeStreakIterator(c + 1);
+                for (typename Region<DIM>::StreakIterator i = region.planeStreakIterator(c); i != end; ++i) {
+                    streaks << *i;
+                }
+            }
+        }
+
+        taskOffsets << streaks.size();
+    }
+
+    /**
+     * Checks whether this schedule was built for the given
+     * parameters. Comparing Regions is a lot cheaper than
+     * decomposing them again.
+     */
+    bool matches(const Region<DIM>& otherRegion, int otherGranularity) const
+    {
+        return (granularity == otherGranularity) && (region == otherRegion);
+    }
+
+    std::size_t numTasks() const
+    {
+        return taskOffsets.size() - 1;
+    }
+
+    StreakIterator beginTask(std::size_t task) const
+    {
+        return streaks.begin() + taskOffsets[task];
+    }
+
+    StreakIterator endTask(std::size_t task) const
+    {
+        return streaks.begin() + taskOffsets[task + 1];
+    }
+
+private:
+    Region<DIM> region;
+    int granularity;
+    std::vector<Streak<DIM> > streaks;
+    std::vector<std::size_t> taskOffsets;
+};
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+/**
+ * Steppers update the same few Regions (inner set, rims, ghost
+ * zones) in every time step. StreakScheduleCache keeps their
+ * schedules, keyed by the Region's address and validated by
+ * comparing the Region itself. Each thread has its own cache, so no
+ * locking is required. A returned schedule is valid until the next
+ * lookup for a different Region at the same address.
+ */
+template<int DIM>
+class StreakScheduleCache
+{
+public:
+    static const std::size_t MAX_ENTRIES = 64;
+
+    static StreakScheduleCache& instance()
+    {
+        static thread_local StreakScheduleCache cache;
+        return cache;
+    }
+
+    const StreakSchedule<DIM>& operator()(const Region<DIM>& region, int granularity)
+    {
+        typename ScheduleMap::iterator i = schedules.find(&region);
+        if (i != schedules.end()) {
+            if (!i->second.matches(region, granularity)) {
+                ++misses;
+                i->second.reset(region, granularity);
+            } else {
+                ++hits;
+            }
+            return i->second;
+        }
+
+        ++misses;
+        if (schedules.size() >= MAX_ENTRIES) {
+            schedules.clear();
+        }
+        return schedules.insert(std::make_pair(&region, StreakSchedule<DIM>(region, granularity))).first->second;
+    }
+
+    std::size_t numHits() const
+    {
+        return hits;
+    }
+
+    std::size_t numMisses() const
+    {
+        return misses;
+    }
+
+private:
+    typedef std::map<const Region<DIM>*, StreakSchedule<DIM> > ScheduleMap;
+
+    ScheduleMap schedules;
+    std::size_t hits;
+    std::size_t misses;
+
+    StreakScheduleCache() :
+        hits(0),
+        misses(0)
+    {}
+};
+
+#endif
+
+}
+
+#endif
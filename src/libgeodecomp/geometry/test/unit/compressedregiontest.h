@@ -0,0 +1,291 @@
+#include <libgeodecomp/geometry/compressedregion.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/misc/random.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class CompressedRegionTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        sparse = Region<3>();
+        for (int z = 0; z < 20; z += 3) {
+            for (int y = 0; y < 20; y += 2) {
+                for (int x = 0; x < 50; x += 10) {
+                    int length = Random::genUnsigned(8) + 1;
+                    sparse << Streak<3>(Coord<3>(x + y % 3, y, z), x + y % 3 + length);
+                }
+            }
+        }
+
+        dense = Region<3>(CoordBox<3>(Coord<3>(5, 6, 7), Coord<3>(40, 30, 20)));
+        other = Region<3>(CoordBox<3>(Coord<3>(0, 10, 10), Coord<3>(30, 40, 5)));
+    }
+
+    void testIndexVectorPushPop()
+    {
+        typedef CompressedRegionHelpers::RunLengthIndexVector::IntPair IntPair;
+        CompressedRegionHelpers::RunLengthIndexVector vec;
+        std::vector<IntPair> expected;
+
+        for (int i = 0; i < 10; ++i) {
+            expected << IntPair(i, 2 * i + 1);
+        }
+        expected << IntPair(3, 5);
+        expected << IntPair(3, 5);
+        expected << IntPair(3, 5);
+        expected << IntPair(-1, 9);
+
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            vec.push_back(expected[i]);
+        }
+
+        TS_ASSERT_EQUALS(expected.size(), vec.size());
+        TS_ASSERT_EQUALS(std::size_t(3), vec.numRuns());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            TS_ASSERT_EQUALS(expected[i], vec[i]);
+        }
+
+        std::size_t i = 0;
+        for (CompressedRegionHelpers::RunLengthIndexVector::const_iterator iter = vec.begin();
+             iter != vec.end();
+             ++iter) {
+            TS_ASSERT_EQUALS(expected[i], *iter);
+            TS_ASSERT_EQUALS(expected[i], *(vec.begin() + std::ptrdiff_t(i)));
+            ++i;
+        }
+        TS_ASSERT_EQUALS(expected.size(), i);
+        TS_ASSERT_EQUALS(expected.back(), *(vec.end() - 1));
+
+        // popping and re-pushing must yield the identical encoding:
+        CompressedRegionHelpers::RunLengthIndexVector copy = vec;
+        for (int k = 0; k < 5; ++k) {
+            vec.pop_back();
+        }
+        TS_ASSERT_EQUALS(expected.size() - 5, vec.size());
+        TS_ASSERT_EQUALS(expected[expected.size() - 6], vec.back());
+        TS_ASSERT_DIFFERS(copy, vec);
+
+        for (std::size_t k = expected.size() - 5; k < expected.size(); ++k) {
+            vec.push_back(expected[k]);
+        }
+        TS_ASSERT_EQUALS(copy, vec);
+    }
+
+    void testBoxIsCompact()
+    {
+        CoordBox<3> box(Coord<3>(1, 2, 3), Coord<3>(200, 300, 400));
+        CompressedRegion<3> region(box);
+
+        TS_ASSERT_EQUALS(box.size(), region.size());
+        TS_ASSERT_EQUALS(box, region.boundingBox());
+        TS_ASSERT_EQUALS(std::size_t(300 * 400), region.numStreaks());
+        TS_ASSERT_EQUALS(std::size_t(400), region.numPlanes());
+        // one run for the x-indices, one per plane for the
+        // y-indices, and one for the z-indices:
+        TS_ASSERT_EQUALS(std::size_t(1 + 400 + 1), region.numRuns());
+
+        TS_ASSERT( region.count(Coord<3>(  1,   2,   3)));
+        TS_ASSERT( region.count(Coord<3>(200, 301, 402)));
+        TS_ASSERT(!region.count(Coord<3>(201, 301, 402)));
+        TS_ASSERT(!region.count(Coord<3>(  0, 100, 100)));
+        TS_ASSERT(!region.count(Coord<3>( 50, 100, 403)));
+        TS_ASSERT( region.count(Streak<3>(Coord<3>(1, 100, 100), 201)));
+        TS_ASSERT(!region.count(Streak<3>(Coord<3>(1, 100, 100), 202)));
+    }
+
+    void testBoxConstructorMatchesAppends()
+    {
+        checkBoxConstructor(CoordBox<1>(Coord<1>(-5), Coord<1>(10)));
+        checkBoxConstructor(CoordBox<2>(Coord<2>(-5, 3), Coord<2>(10, 1)));
+        checkBoxConstructor(CoordBox<2>(Coord<2>(-5, 3), Coord<2>(10, 20)));
+        checkBoxConstructor(CoordBox<3>(Coord<3>(1, 2, 3), Coord<3>(1, 1, 1)));
+        checkBoxConstructor(CoordBox<3>(Coord<3>(1, 2, 3), Coord<3>(4, 1, 7)));
+        checkBoxConstructor(CoordBox<3>(Coord<3>(1, 2, 3), Coord<3>(4, 5, 6)));
+
+        CompressedRegion<3> empty(CoordBox<3>(Coord<3>(1, 2, 3), Coord<3>(4, 0, 6)));
+        TS_ASSERT(empty.empty());
+        TS_ASSERT_EQUALS(std::size_t(0), empty.size());
+        TS_ASSERT_EQUALS(CompressedRegion<3>(), empty);
+    }
+
+    void testIsBox()
+    {
+        CompressedRegion<3> region(dense);
+        TS_ASSERT(region.isBox());
+        TS_ASSERT(!CompressedRegion<3>().isBox());
+        TS_ASSERT(!CompressedRegion<3>(sparse).isBox());
+
+        Region<3> holey = dense;
+        holey >> Coord<3>(10, 10, 10);
+        TS_ASSERT(!CompressedRegion<3>(holey).isBox());
+        TS_ASSERT_EQUALS(holey.expand(2), CompressedRegion<3>(holey).expand(2).toRegion());
+    }
+
+    void testRoundTrip()
+    {
+        checkRoundTrip(sparse);
+        checkRoundTrip(dense);
+        checkRoundTrip(Region<3>());
+
+        Region<2> region;
+        region << Streak<2>(Coord<2>(10, 10), 20)
+               << Streak<2>(Coord<2>(30, 10), 40)
+               << Streak<2>(Coord<2>(10, 11), 20)
+               << Streak<2>(Coord<2>( 5, 20), 50);
+        CompressedRegion<2> compressed(region);
+        TS_ASSERT_EQUALS(region, compressed.toRegion());
+        TS_ASSERT_EQUALS(region.toVector(), compressed.toVector());
+    }
+
+    void testCount()
+    {
+        CompressedRegion<3> compressed(sparse);
+        CoordBox<3> box = sparse.boundingBox();
+        box.origin -= Coord<3>::diagonal(1);
+        box.dimensions += Coord<3>::diagonal(2);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(sparse.count(*i), compressed.count(*i));
+        }
+    }
+
+    void testFusingAppend()
+    {
+        CompressedRegion<2> region;
+        region << Streak<2>(Coord<2>(10, 5), 15)
+               << Streak<2>(Coord<2>(20, 5), 25)
+               << Streak<2>(Coord<2>(12, 5), 30)
+               << Streak<2>(Coord<2>(30, 5), 32)
+               << Streak<2>(Coord<2>( 0, 7),  1);
+
+        Region<2> expected;
+        expected << Streak<2>(Coord<2>(10, 5), 32)
+                 << Streak<2>(Coord<2>( 0, 7),  1);
+
+        TS_ASSERT_EQUALS(expected, region.toRegion());
+        TS_ASSERT_EQUALS(expected.size(), region.size());
+        TS_ASSERT_EQUALS(expected.boundingBox(), region.boundingBox());
+        TS_ASSERT_EQUALS(CompressedRegion<2>(expected), region);
+    }
+
+    void testOutOfOrderAppend()
+    {
+        CompressedRegion<2> region;
+        region << Streak<2>(Coord<2>(10, 5), 15);
+
+        TS_ASSERT_THROWS(region << Streak<2>(Coord<2>(0, 5), 5), std::logic_error&);
+        TS_ASSERT_THROWS(region << Streak<2>(Coord<2>(0, 4), 5), std::logic_error&);
+    }
+
+    void testSetAlgebra()
+    {
+        checkSetAlgebra(sparse, dense);
+        checkSetAlgebra(dense, sparse);
+        checkSetAlgebra(dense, other);
+        checkSetAlgebra(sparse, sparse);
+        checkSetAlgebra(sparse, Region<3>());
+        checkSetAlgebra(Region<3>(), other);
+    }
+
+    void testAssignmentOperators()
+    {
+        CompressedRegion<3> a(dense);
+        CompressedRegion<3> b(other);
+
+        CompressedRegion<3> c = a;
+        c += b;
+        TS_ASSERT_EQUALS(a + b, c);
+
+        c = a;
+        c -= b;
+        TS_ASSERT_EQUALS(a - b, c);
+
+        c = a;
+        c &= b;
+        TS_ASSERT_EQUALS(a & b, c);
+    }
+
+    void testExpand()
+    {
+        checkExpand(sparse, Coord<3>(1, 1, 1));
+        checkExpand(sparse, Coord<3>(3, 0, 2));
+        checkExpand(dense,  Coord<3>(5, 5, 5));
+        checkExpand(dense + sparse, Coord<3>(2, 7, 1));
+
+        Region<2> region;
+        region << Coord<2>(10, 10)
+               << Coord<2>(20, 12);
+        TS_ASSERT_EQUALS(region.expand(4), CompressedRegion<2>(region).expand(4).toRegion());
+    }
+
+private:
+    Region<3> sparse;
+    Region<3> dense;
+    Region<3> other;
+
+    template<int DIM>
+    void checkRoundTrip(const Region<DIM>& region)
+    {
+        CompressedRegion<DIM> compressed(region);
+
+        TS_ASSERT_EQUALS(region, compressed.toRegion());
+        TS_ASSERT_EQUALS(region.size(), compressed.size());
+        TS_ASSERT_EQUALS(region.numStreaks(), compressed.numStreaks());
+        TS_ASSERT_EQUALS(region.boundingBox(), compressed.boundingBox());
+        TS_ASSERT_EQUALS(region.empty(), compressed.empty());
+        TS_ASSERT(compressed.numRuns() <= region.numStreaks() * DIM);
+
+        typename Region<DIM>::StreakIterator i = region.beginStreak();
+        typename CompressedRegion<DIM>::StreakIterator j = compressed.beginStreak();
+        for (; i != region.endStreak(); ++i, ++j) {
+            TS_ASSERT_EQUALS(*i, *j);
+        }
+        TS_ASSERT_EQUALS(j, compressed.endStreak());
+    }
+
+    template<int DIM>
+    void checkBoxConstructor(const CoordBox<DIM>& box)
+    {
+        CompressedRegion<DIM> expected;
+        for (typename CoordBox<DIM>::StreakIterator i = box.beginStreak(); i != box.endStreak(); ++i) {
+            expected << *i;
+        }
+
+        CompressedRegion<DIM> actual(box);
+        TS_ASSERT_EQUALS(expected, actual);
+        TS_ASSERT_EQUALS(expected.size(), actual.size());
+        TS_ASSERT_EQUALS(expected.boundingBox(), actual.boundingBox());
+        TS_ASSERT_EQUALS(Region<DIM>(box), actual.toRegion());
+    }
+
+    void checkSetAlgebra(const Region<3>& a, const Region<3>& b)
+    {
+        CompressedRegion<3> compressedA(a);
+        CompressedRegion<3> compressedB(b);
+
+        TS_ASSERT_EQUALS(a & b, (compressedA & compressedB).toRegion());
+        TS_ASSERT_EQUALS(a - b, (compressedA - compressedB).toRegion());
+        TS_ASSERT_EQUALS(a + b, (compressedA + compressedB).toRegion());
+
+        TS_ASSERT_EQUALS(CompressedRegion<3>(a & b), compressedA & compressedB);
+        TS_ASSERT_EQUALS(CompressedRegion<3>(a - b), compressedA - compressedB);
+        TS_ASSERT_EQUALS(CompressedRegion<3>(a + b), compressedA + compressedB);
+
+        TS_ASSERT_EQUALS((a + b).size(), (compressedA + compressedB).size());
+        TS_ASSERT_EQUALS((a + b).boundingBox(), (compressedA + compressedB).boundingBox());
+    }
+
+    void checkExpand(const Region<3>& region, const Coord<3>& radii)
+    {
+        CompressedRegion<3> compressed(region);
+        TS_ASSERT_EQUALS(region.expand(radii), compressed.expand(radii).toRegion());
+    }
+};
+
+}
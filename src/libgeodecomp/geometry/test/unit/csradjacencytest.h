@@ -0,0 +1,122 @@
+#include <libgeodecomp/geometry/csradjacency.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/regionbasedadjacency.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class CSRAdjacencyTest : public CxxTest::TestSuite
+{
+public:
+    void testInsert()
+    {
+        CSRAdjacency adjacency;
+        adjacency.insert(0, 0);
+        adjacency.insert(0, 6);
+        adjacency.insert(0, 4);
+        adjacency.insert(0, 2);
+
+        adjacency.insert(5, 1);
+        adjacency.insert(5, 2);
+        adjacency.insert(5, 3);
+
+        adjacency.insert(3, 9);
+        adjacency.insert(3, 0);
+        adjacency.insert(3, 0);
+
+        std::vector<int> expected;
+        std::vector<int> actual;
+        expected << 0 << 2 << 4 << 6;
+        adjacency.getNeighbors(0, &actual);
+        TS_ASSERT_EQUALS(expected, actual);
+
+        expected.clear();
+        actual.clear();
+        adjacency.getNeighbors(1, &actual);
+        adjacency.getNeighbors(4, &actual);
+        adjacency.getNeighbors(6, &actual);
+        adjacency.getNeighbors(-1, &actual);
+        TS_ASSERT_EQUALS(expected, actual);
+
+        expected << 0 << 9;
+        adjacency.getNeighbors(3, &actual);
+        TS_ASSERT_EQUALS(expected, actual);
+
+        expected.clear();
+        actual.clear();
+        expected << 1 << 2 << 3;
+        adjacency.getNeighbors(5, &actual);
+        TS_ASSERT_EQUALS(expected, actual);
+
+        TS_ASSERT_EQUALS(std::size_t(9), adjacency.size());
+        TS_ASSERT_EQUALS(std::size_t(6), adjacency.numNodes());
+        TS_ASSERT_EQUALS(std::size_t(3), adjacency[5].size());
+        TS_ASSERT_EQUALS(1, *adjacency[5].begin());
+
+        TS_ASSERT_THROWS(adjacency.insert(-1, 5), std::invalid_argument&);
+    }
+
+    void testBulkConstructionMatchesRegionBasedAdjacency()
+    {
+        int numNodes = 20000;
+        std::vector<CSRAdjacency::Edge> edges;
+        RegionBasedAdjacency reference;
+
+        // insert edges in scrambled order and with duplicates:
+        for (int i = 0; i < numNodes * 8; ++i) {
+            int from = int((long(i) * 7919) % numNodes);
+            int to = (from * 31 + i % 13) % numNodes;
+
+            edges << std::make_pair(from, to);
+            reference.insert(from, to);
+        }
+
+        CSRAdjacency adjacency(std::size_t(numNodes), edges);
+        TS_ASSERT_EQUALS(reference.size(), adjacency.size());
+
+        std::vector<int> expected;
+        std::vector<int> actual;
+        for (int i = 0; i < numNodes; ++i) {
+            expected.clear();
+            actual.clear();
+            reference.getNeighbors(i, &expected);
+            adjacency.getNeighbors(i, &actual);
+            TS_ASSERT_EQUALS(expected, actual);
+        }
+
+        std::vector<CSRAdjacency::Edge> invalidEdges;
+        invalidEdges << std::make_pair(0, 1)
+                     << std::make_pair(int(numNodes), 1);
+        TS_ASSERT_THROWS(CSRAdjacency(std::size_t(numNodes), invalidEdges), std::invalid_argument&);
+    }
+
+    void testExpandWithAdjacency()
+    {
+        // a ring of 100 nodes:
+        std::vector<CSRAdjacency::Edge> edges;
+        for (int i = 0; i < 100; ++i) {
+            edges << std::make_pair(i, (i + 1) % 100)
+                  << std::make_pair((i + 1) % 100, i);
+        }
+        CSRAdjacency adjacency(100, edges);
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>(10), 20);
+
+        Region<1> expected;
+        expected << Streak<1>(Coord<1>(7), 23);
+        TS_ASSERT_EQUALS(expected, region.expandWithAdjacency(3, adjacency));
+
+        region.clear();
+        region << Coord<1>(0);
+        expected.clear();
+        expected << Streak<1>(Coord<1>(0), 3)
+                 << Streak<1>(Coord<1>(98), 100);
+        TS_ASSERT_EQUALS(expected, region.expandWithAdjacency(2, adjacency));
+    }
+};
+
+}
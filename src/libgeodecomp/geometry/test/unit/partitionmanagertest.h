@@ -275,6 +275,105 @@ public:
 
     }
 
+    void testStencilAwareGhostZones()
+    {
+        unsigned ghostZoneWidth = 2;
+        CoordBox<3> box(Coord<3>(), Coord<3>(30, 30, 30));
+        std::vector<std::size_t> weights(8, box.dimensions.prod() / 8);
+        SharedPtr<Partition<3> >::Type partition(
+            new RecursiveBisectionPartition<3>(Coord<3>(), box.dimensions, 0, weights));
+        SharedPtr<AdjacencyManufacturer<3> >::Type dummyAdjacencyManufacturer(new DummyAdjacencyManufacturer<3>);
+        Region<3> stencil = Region<3>::fromStencil(Stencils::VonNeumann<3, 1>());
+
+        PartitionManager<Topologies::Cube<3>::Topology> mooreManager;
+        mooreManager.resetRegions(
+            dummyAdjacencyManufacturer,
+            box,
+            partition,
+            3,
+            ghostZoneWidth);
+
+        PartitionManager<Topologies::Cube<3>::Topology> vonNeumannManager;
+        vonNeumannManager.resetRegions(
+            dummyAdjacencyManufacturer,
+            box,
+            partition,
+            3,
+            ghostZoneWidth,
+            stencil);
+
+        Region<3> expected = vonNeumannManager.ownRegion();
+        for (unsigned i = 1; i <= ghostZoneWidth; ++i) {
+            expected = expected.expandWithStencil(stencil) & Region<3>(box);
+            TS_ASSERT_EQUALS(expected, vonNeumannManager.ownRegion(i));
+        }
+
+        TS_ASSERT_EQUALS(mooreManager.ownRegion(), vonNeumannManager.ownRegion());
+        TS_ASSERT_LESS_THAN(
+            vonNeumannManager.getOuterRim().size(),
+            mooreManager.getOuterRim().size());
+        TS_ASSERT_EQUALS(
+            vonNeumannManager.ownRegion(),
+            vonNeumannManager.rim(ghostZoneWidth) + vonNeumannManager.innerSet(ghostZoneWidth));
+        TS_ASSERT_EQUALS(
+            vonNeumannManager.innerSet(0),
+            vonNeumannManager.innerSet(1).expandWithStencil(stencil) & Region<3>(box));
+
+        // passing the default stencil explicitly should make no difference:
+        PartitionManager<Topologies::Cube<3>::Topology> explicitMooreManager;
+        explicitMooreManager.resetRegions(
+            dummyAdjacencyManufacturer,
+            box,
+            partition,
+            3,
+            ghostZoneWidth,
+            Region<3>::fromStencil(Stencils::Moore<3, 1>()));
+
+        for (unsigned i = 0; i <= ghostZoneWidth; ++i) {
+            TS_ASSERT_EQUALS(mooreManager.ownRegion(i), explicitMooreManager.ownRegion(i));
+            TS_ASSERT_EQUALS(mooreManager.rim(i),       explicitMooreManager.rim(i));
+            TS_ASSERT_EQUALS(mooreManager.innerSet(i),  explicitMooreManager.innerSet(i));
+        }
+    }
+
+    void testAsymmetricStencilGetsMirrored()
+    {
+        CoordBox<2> box(Coord<2>(), Coord<2>(20, 20));
+        std::vector<std::size_t> weights(4, 100);
+        SharedPtr<Partition<2> >::Type partition(
+            new RecursiveBisectionPartition<2>(Coord<2>(), box.dimensions, 0, weights));
+        SharedPtr<AdjacencyManufacturer<2> >::Type dummyAdjacencyManufacturer(new DummyAdjacencyManufacturer<2>);
+
+        Region<2> stencil;
+        stencil << Coord<2>(0, 0)
+                << Coord<2>(1, 0);
+        Region<2> mirrored = stencil;
+        mirrored << Coord<2>(-1, 0);
+
+        PartitionManager<Topologies::Cube<2>::Topology> manager;
+        manager.resetRegions(
+            dummyAdjacencyManufacturer,
+            box,
+            partition,
+            3,
+            1,
+            stencil);
+
+        Region<2> expected;
+        for (Region<2>::StreakIterator i = manager.ownRegion().beginStreak();
+             i != manager.ownRegion().endStreak();
+             ++i) {
+            Streak<2> s = *i;
+            s.origin.x() -= 1;
+            s.endX += 1;
+            expected << s;
+        }
+        expected &= Region<2>(box);
+
+        TS_ASSERT_EQUALS(expected, manager.ownRegion(1));
+        TS_ASSERT_EQUALS(manager.ownRegion().expandWithStencil(mirrored) & Region<2>(box), manager.ownRegion(1));
+    }
+
 private:
     Coord<2> dimensions;
     unsigned offset;
@@ -0,0 +1,93 @@
+#include <libgeodecomp/geometry/regionhandle.h>
+
+#include <cxxtest/TestSuite.h>
+#include <unordered_set>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class RegionHandleTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        box = Region<3>(CoordBox<3>(Coord<3>(1, 2, 3), Coord<3>(20, 30, 40)));
+
+        for (int y = 0; y < 50; y += 2) {
+            stripes << Streak<3>(Coord<3>(y % 7, y, 5), 30 + y % 5);
+        }
+    }
+
+    void testEquality()
+    {
+        RegionHandle<3> a(box);
+        RegionHandle<3> b(Region<3>(CoordBox<3>(Coord<3>(1, 2, 3), Coord<3>(20, 30, 40))));
+        RegionHandle<3> c(stripes);
+
+        TS_ASSERT_EQUALS(a, b);
+        TS_ASSERT_EQUALS(a.hash(), b.hash());
+        TS_ASSERT_DIFFERS(a, c);
+        TS_ASSERT_EQUALS(*a, box);
+        TS_ASSERT_EQUALS(*c, stripes);
+        TS_ASSERT_EQUALS(a->size(), box.size());
+
+        // same coordinates, different insertion order:
+        Region<3> reversed;
+        for (int y = 48; y >= 0; y -= 2) {
+            reversed << Streak<3>(Coord<3>(y % 7, y, 5), 30 + y % 5);
+        }
+        TS_ASSERT_EQUALS(RegionHandle<3>(reversed), c);
+
+        TS_ASSERT_EQUALS(RegionHandle<3>(), RegionHandle<3>(Region<3>()));
+        TS_ASSERT_DIFFERS(RegionHandle<3>(), a);
+    }
+
+    void testDeduplication()
+    {
+        std::size_t baseline = RegionHandle<3>::poolSize();
+        {
+            std::vector<RegionHandle<3> > handles;
+            for (int i = 0; i < 100; ++i) {
+                handles << RegionHandle<3>(i % 2 ? box : stripes);
+            }
+
+            TS_ASSERT_EQUALS(RegionHandle<3>::poolSize(), baseline + 2);
+            TS_ASSERT_EQUALS(&*handles[0], &*handles[98]);
+            TS_ASSERT_EQUALS(&*handles[1], &*handles[99]);
+        }
+
+        TS_ASSERT_EQUALS(RegionHandle<3>::poolSize(), baseline);
+    }
+
+    void testExpiredEntriesGetPurged()
+    {
+        std::size_t baseline = RegionHandle<2>::poolSize();
+        RegionHandle<2> keeper(Region<2>(CoordBox<2>(Coord<2>(), Coord<2>(3, 3))));
+
+        for (int i = 0; i < 1000; ++i) {
+            RegionHandle<2> temp(Region<2>(CoordBox<2>(Coord<2>(i, 0), Coord<2>(5, 5))));
+            TS_ASSERT_EQUALS(temp->size(), std::size_t(25));
+        }
+
+        TS_ASSERT_EQUALS(RegionHandle<2>::poolSize(), baseline + 1);
+        TS_ASSERT_EQUALS(keeper->size(), std::size_t(9));
+    }
+
+    void testHashFunctor()
+    {
+        std::unordered_set<RegionHandle<3>, RegionHandle<3>::Hash> set;
+        set.insert(RegionHandle<3>(box));
+        set.insert(RegionHandle<3>(stripes));
+        set.insert(RegionHandle<3>(box));
+
+        TS_ASSERT_EQUALS(set.size(), std::size_t(2));
+        TS_ASSERT_EQUALS(set.count(RegionHandle<3>(stripes)), std::size_t(1));
+    }
+
+private:
+    Region<3> box;
+    Region<3> stripes;
+};
+
+}
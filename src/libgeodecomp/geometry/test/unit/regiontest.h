@@ -2,6 +2,7 @@
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/regionbasedadjacency.h>
 #include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/misc/random.h>
 #include <libgeodecomp/storage/displacedgrid.h>
 
 #include <cxxtest/TestSuite.h>
@@ -1346,6 +1347,40 @@ public:
         TS_ASSERT_EQUALS(expected, actual);
     }
 
+    void testExpandIncrementally()
+    {
+        Region<2> region2 = randomRegion(CoordBox<2>(Coord<2>(0, 0), Coord<2>(60, 40)), 50);
+        std::vector<Region<2> > levels2 = region2.expandIncrementally(5);
+        TS_ASSERT_EQUALS(std::size_t(6), levels2.size());
+        for (unsigned i = 0; i < levels2.size(); ++i) {
+            TS_ASSERT_EQUALS(region2.expand(i), levels2[i]);
+        }
+
+        Region<3> region3 = randomRegion(CoordBox<3>(Coord<3>(0, 0, 0), Coord<3>(30, 20, 20)), 100);
+        region3 << CoordBox<3>(Coord<3>(40, 30, 20), Coord<3>(5, 6, 7));
+        std::vector<Region<3> > levels3 = region3.expandIncrementally(4);
+        TS_ASSERT_EQUALS(std::size_t(5), levels3.size());
+        for (unsigned i = 0; i < levels3.size(); ++i) {
+            TS_ASSERT_EQUALS(region3.expand(i), levels3[i]);
+        }
+
+        TS_ASSERT_EQUALS(std::size_t(1), region3.expandIncrementally(0).size());
+        TS_ASSERT(Region<3>().expandIncrementally(3).back().empty());
+    }
+
+    void testExpandWithTopologyIncrementally()
+    {
+        Coord<2> globalDim2(40, 30);
+        Region<2> region2 = randomRegion(CoordBox<2>(Coord<2>(0, 0), globalDim2), 30);
+        checkExpandWithTopologyIncrementally(region2, globalDim2, Topologies::Torus<2>::Topology());
+        checkExpandWithTopologyIncrementally(region2, globalDim2, Topologies::Cube<2>::Topology());
+
+        Coord<3> globalDim3(20, 15, 10);
+        Region<3> region3 = randomRegion(CoordBox<3>(Coord<3>(0, 0, 0), globalDim3), 40);
+        checkExpandWithTopologyIncrementally(region3, globalDim3, Topologies::Torus<3>::Topology());
+        checkExpandWithTopologyIncrementally(region3, globalDim3, Topologies::Cube<3>::Topology());
+    }
+
     void testExpandWithTopology1()
     {
         Region<2> region;
@@ -2258,6 +2293,34 @@ public:
         TS_ASSERT( r6.isAppendable(r5));
     }
 
+    void testParallelSetAlgebra2D()
+    {
+        Region<2> a = randomRegion(CoordBox<2>(Coord<2>( 0,  0), Coord<2>(100, 80)), 400);
+        Region<2> b = randomRegion(CoordBox<2>(Coord<2>(10, -5), Coord<2>( 80, 90)), 400);
+        checkParallelSetAlgebra(a, b);
+        checkParallelSetAlgebra(b, a);
+        checkParallelSetAlgebra(a, Region<2>());
+        checkParallelSetAlgebra(Region<2>(), b);
+    }
+
+    void testParallelSetAlgebra3D()
+    {
+        Region<3> a = randomRegion(CoordBox<3>(Coord<3>( 0,  0,   0), Coord<3>(50, 40, 30)), 800);
+        Region<3> b = randomRegion(CoordBox<3>(Coord<3>(-5, 10, -10), Coord<3>(40, 40, 50)), 800);
+        Region<3> c(CoordBox<3>(Coord<3>(10, 10, 10), Coord<3>(20, 20, 20)));
+        checkParallelSetAlgebra(a, b);
+        checkParallelSetAlgebra(b, a);
+        checkParallelSetAlgebra(a, c);
+        checkParallelSetAlgebra(c, b);
+    }
+
+    void testParallelSetAlgebra1D()
+    {
+        Region<1> a = randomRegion(CoordBox<1>(Coord<1>( 0), Coord<1>(1000)), 100);
+        Region<1> b = randomRegion(CoordBox<1>(Coord<1>(50), Coord<1>(1000)), 100);
+        checkParallelSetAlgebra(a, b);
+    }
+
 private:
     Region<2> c;
     CoordVector bigInsertOrdered;
@@ -2277,6 +2340,50 @@ private:
         return ret;
     }
 
+    template<int DIM>
+    Region<DIM> randomRegion(const CoordBox<DIM>& box, int numStreaks)
+    {
+        Region<DIM> ret;
+        for (int i = 0; i < numStreaks; ++i) {
+            Coord<DIM> origin = box.origin;
+            for (int d = 0; d < DIM; ++d) {
+                origin[d] += Random::genUnsigned(box.dimensions[d]);
+            }
+            int length = 1 + Random::genUnsigned(box.dimensions.x() / 4);
+            ret << Streak<DIM>(origin, origin.x() + length);
+        }
+
+        return ret;
+    }
+
+    template<int DIM, typename TOPOLOGY>
+    void checkExpandWithTopologyIncrementally(
+        const Region<DIM>& region,
+        const Coord<DIM>& globalDimensions,
+        TOPOLOGY topology)
+    {
+        std::vector<Region<DIM> > levels = region.expandWithTopologyIncrementally(4, globalDimensions, topology);
+        TS_ASSERT_EQUALS(std::size_t(5), levels.size());
+        TS_ASSERT_EQUALS(region, levels[0]);
+
+        for (std::size_t i = 1; i < levels.size(); ++i) {
+            TS_ASSERT_EQUALS(levels[i - 1].expandWithTopology(1, globalDimensions, topology), levels[i]);
+        }
+    }
+
+    template<int DIM>
+    void checkParallelSetAlgebra(const Region<DIM>& a, const Region<DIM>& b)
+    {
+        for (std::size_t chunks = 0; chunks < 9; ++chunks) {
+            TS_ASSERT_EQUALS(a & b, a.parallelIntersection(b, chunks));
+            TS_ASSERT_EQUALS(a + b, a.parallelUnion(b, chunks));
+            TS_ASSERT_EQUALS(a - b, a.parallelDifference(b, chunks));
+
+            TS_ASSERT_EQUALS((a & b).size(), a.parallelIntersection(b, chunks).size());
+            TS_ASSERT_EQUALS((a + b).boundingBox(), a.parallelUnion(b, chunks).boundingBox());
+        }
+    }
+
     int bongo(const Coord<2>& c) const
     {
         return c.x() % 13 + c.y() % 17;
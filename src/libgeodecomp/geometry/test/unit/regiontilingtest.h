@@ -0,0 +1,89 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/geometry/regiontiling.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class RegionTilingTest : public CxxTest::TestSuite
+{
+public:
+    void testCoverage()
+    {
+        Region<3> region;
+        region << CoordBox<3>(Coord<3>(-5, 3, 1), Coord<3>(200, 17, 9));
+        region >> CoordBox<3>(Coord<3>(20, 5, 2), Coord<3>(30, 4, 3));
+
+        RegionTiling<3> tiling(region, Coord<3>(64, 8, 4));
+        // x: [-64, 256[ -> 5 tiles, y: [0, 24[ -> 3, z: [0, 12[ -> 3
+        TS_ASSERT_EQUALS(std::size_t(5 * 3 * 3), tiling.numTiles());
+
+        Region<3> actual;
+        for (std::size_t t = 0; t < tiling.numTiles(); ++t) {
+            Region<3> tile;
+            for (RegionTiling<3>::StreakIterator i = tiling.beginTile(t); i != tiling.endTile(t); ++i) {
+                tile << *i;
+            }
+
+            // all streaks of a tile lie within the same tile:
+            CoordBox<3> box = tile.boundingBox();
+            Coord<3> last = box.origin + box.dimensions - Coord<3>::diagonal(1);
+            for (int d = 0; d < 3; ++d) {
+                TS_ASSERT_EQUALS(floorDiv(box.origin[d], tiling.getTileDimensions()[d]),
+                                 floorDiv(last[d],       tiling.getTileDimensions()[d]));
+            }
+
+            TS_ASSERT((actual & tile).empty());
+            actual += tile;
+        }
+
+        TS_ASSERT_EQUALS(region, actual);
+    }
+
+    void testMortonOrder()
+    {
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(0, 0), Coord<2>(20, 20));
+
+        RegionTiling<2> tiling(region, Coord<2>(10, 10));
+        TS_ASSERT_EQUALS(std::size_t(4), tiling.numTiles());
+
+        std::vector<Coord<2> > expected;
+        expected << Coord<2>( 0,  0)
+                 << Coord<2>(10,  0)
+                 << Coord<2>( 0, 10)
+                 << Coord<2>(10, 10);
+
+        for (std::size_t t = 0; t < tiling.numTiles(); ++t) {
+            TS_ASSERT_EQUALS(std::size_t(10), std::size_t(tiling.endTile(t) - tiling.beginTile(t)));
+            TS_ASSERT_EQUALS(Streak<2>(expected[t], expected[t].x() + 10), *tiling.beginTile(t));
+        }
+    }
+
+    void testEmpty()
+    {
+        RegionTiling<3> tiling(Region<3>(), Coord<3>(64, 4, 4));
+        TS_ASSERT_EQUALS(std::size_t(0), tiling.numTiles());
+    }
+
+    void testDefaultTileDimensions()
+    {
+        Coord<3> dim = RegionTiling<3>::defaultTileDimensions(8, 1 << 18);
+        TS_ASSERT_EQUALS(0, dim.x() % RegionTiling<3>::LINE_GRANULARITY);
+        TS_ASSERT_LESS_THAN_EQUALS(dim.prod() * 8, 1 << 18);
+        TS_ASSERT_LESS_THAN(1, dim.y());
+        TS_ASSERT_EQUALS(dim.y(), dim.z());
+
+        // huge cells still yield valid tiles:
+        dim = RegionTiling<3>::defaultTileDimensions(1 << 20, 1 << 18);
+        TS_ASSERT_EQUALS(Coord<3>(RegionTiling<3>::LINE_GRANULARITY, 1, 1), dim);
+    }
+
+private:
+    int floorDiv(int a, int b)
+    {
+        return (a >= 0) ? (a / b) : -((b - 1 - a) / b);
+    }
+};
+
+}
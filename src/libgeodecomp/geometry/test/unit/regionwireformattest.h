@@ -0,0 +1,98 @@
+#include <libgeodecomp/geometry/regionwireformat.h>
+#include <libgeodecomp/misc/random.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class RegionWireFormatTest : public CxxTest::TestSuite
+{
+public:
+    void testRoundTrip1D()
+    {
+        Region<1> region;
+        region << Streak<1>(Coord<1>(-1000), -990)
+               << Streak<1>(Coord<1>(5), 6)
+               << Streak<1>(Coord<1>(1 << 20), (1 << 20) + 300);
+
+        checkRoundTrip(region);
+        checkRoundTrip(Region<1>());
+    }
+
+    void testRoundTrip2D()
+    {
+        Region<2> region;
+        for (int i = 0; i < 200; ++i) {
+            int x = int(Random::genUnsigned(1000)) - 500;
+            int y = int(Random::genUnsigned(1000)) - 500;
+            region << Streak<2>(Coord<2>(x, y), x + 1 + int(Random::genUnsigned(20)));
+        }
+
+        checkRoundTrip(region);
+        checkRoundTrip(Region<2>());
+    }
+
+    void testRoundTrip3D()
+    {
+        Region<3> region(CoordBox<3>(Coord<3>(-10, -20, -30), Coord<3>(40, 50, 60)));
+        region -= Region<3>(CoordBox<3>(Coord<3>(0, 0, 0), Coord<3>(5, 5, 5)));
+        region << Streak<3>(Coord<3>(1000, 2000, 3000), 1100);
+
+        checkRoundTrip(region);
+        checkRoundTrip(Region<3>());
+    }
+
+    void testCompactness()
+    {
+        Region<3> box(CoordBox<3>(Coord<3>(100, 200, 300), Coord<3>(200, 300, 400)));
+        std::vector<char> buffer;
+        RegionWireFormat<3>::encode(box, &buffer);
+
+        // 300 * 400 streaks of 4 ints each would take 1.92 MB:
+        std::size_t streakFormatSize = box.numStreaks() * sizeof(Streak<3>);
+        TS_ASSERT_LESS_THAN(buffer.size() * 3, streakFormatSize);
+    }
+
+    void testMalformedInputThrows()
+    {
+        Region<2> region(CoordBox<2>(Coord<2>(1, 2), Coord<2>(30, 40)));
+        std::vector<char> buffer;
+        RegionWireFormat<2>::encode(region, &buffer);
+
+        Region<2> actual;
+        TS_ASSERT_THROWS(
+            RegionWireFormat<2>::decode(&actual, &buffer[0], buffer.size() - 1),
+            std::logic_error&);
+
+        buffer.push_back(0);
+        TS_ASSERT_THROWS(
+            RegionWireFormat<2>::decode(&actual, buffer),
+            std::logic_error&);
+
+        std::vector<char> garbage(20, char(0xff));
+        TS_ASSERT_THROWS(
+            RegionWireFormat<2>::decode(&actual, garbage),
+            std::logic_error&);
+    }
+
+private:
+    template<int DIM>
+    void checkRoundTrip(const Region<DIM>& region)
+    {
+        std::vector<char> buffer;
+        RegionWireFormat<DIM>::encode(region, &buffer);
+
+        Region<DIM> actual;
+        actual << Streak<DIM>(Coord<DIM>::diagonal(4711), 4800);
+        RegionWireFormat<DIM>::decode(&actual, buffer);
+
+        TS_ASSERT_EQUALS(actual, region);
+        TS_ASSERT_EQUALS(actual.size(), region.size());
+        TS_ASSERT_EQUALS(actual.boundingBox(), region.boundingBox());
+        TS_ASSERT_EQUALS(actual.numStreaks(), region.numStreaks());
+    }
+};
+
+}
@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/geometry/streakschedule.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class StreakScheduleTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        region.clear();
+        region << CoordBox<3>(Coord<3>(0, 0, 0), Coord<3>(100, 4, 3));
+        region >> Streak<3>(Coord<3>(10, 2, 1), 90);
+    }
+
+    void testPlanes()
+    {
+        StreakSchedule<3> schedule(region);
+        TS_ASSERT_EQUALS(std::size_t(3), schedule.numTasks());
+
+        Region<3> actual;
+        for (std::size_t t = 0; t < schedule.numTasks(); ++t) {
+            for (StreakSchedule<3>::StreakIterator i = schedule.beginTask(t); i != schedule.endTask(t); ++i) {
+                TS_ASSERT_EQUALS(int(t), i->origin.z());
+                actual << *i;
+            }
+        }
+        TS_ASSERT_EQUALS(region, actual);
+    }
+
+    void testTranches()
+    {
+        StreakSchedule<3> schedule(region, 32);
+        // 11 full lines of 100 cells (4 tranches each) plus [0, 10[
+        // and [90, 100[:
+        TS_ASSERT_EQUALS(std::size_t(11 * 4 + 2), schedule.numTasks());
+
+        Region<3> actual;
+        for (std::size_t t = 0; t < schedule.numTasks(); ++t) {
+            TS_ASSERT_EQUALS(schedule.beginTask(t) + 1, schedule.endTask(t));
+            Streak<3> streak = *schedule.beginTask(t);
+            TS_ASSERT_LESS_THAN_EQUALS(streak.length(), 32);
+            actual << streak;
+        }
+        TS_ASSERT_EQUALS(region, actual);
+    }
+
+    void testMatches()
+    {
+        StreakSchedule<3> schedule(region, 32);
+        TS_ASSERT(schedule.matches(region, 32));
+        TS_ASSERT(!schedule.matches(region, 0));
+
+        Region<3> other = region;
+        other << Coord<3>(10, 2, 1);
+        TS_ASSERT(!schedule.matches(other, 32));
+    }
+
+    void testCache()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        StreakScheduleCache<3>& cache = StreakScheduleCache<3>::instance();
+        std::size_t hits = cache.numHits();
+        std::size_t misses = cache.numMisses();
+
+        const StreakSchedule<3> *schedule = &cache(region, 0);
+        TS_ASSERT_EQUALS(std::size_t(3), schedule->numTasks());
+        TS_ASSERT_EQUALS(misses + 1, cache.numMisses());
+
+        TS_ASSERT_EQUALS(schedule, &cache(region, 0));
+        TS_ASSERT_EQUALS(hits + 1, cache.numHits());
+
+        // modifications of the Region invalidate the schedule:
+        region << Coord<3>(0, 0, 5);
+        TS_ASSERT_EQUALS(std::size_t(4), cache(region, 0).numTasks());
+        TS_ASSERT_EQUALS(misses + 2, cache.numMisses());
+#endif
+    }
+
+private:
+    Region<3> region;
+};
+
+}
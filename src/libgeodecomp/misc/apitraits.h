@@ -686,6 +686,85 @@ public:
 
     // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+    /**
+     * Decide whether ghost zones may be sent/received directly from/to
+     * the grid, without staging them in a buffer.
+     */
+    template<typename CELL, typename HAS_IN_PLACE_HALO_EXCHANGE = void>
+    class SelectInPlaceHaloExchange
+    {
+    public:
+        typedef FalseType Value;
+    };
+
+    template<typename CELL>
+    class SelectInPlaceHaloExchange<CELL, typename CELL::API::SupportsInPlaceHaloExchange>
+    {
+    public:
+        typedef TrueType Value;
+    };
+
+    /**
+     * Models with fat cells (e.g. LBM codes) may use this flag to let
+     * the PatchLink exchange ghost zones via a derived MPI datatype
+     * which maps the ghost zone's Streaks directly within the grid.
+     * This saves copying the cells into/out of an intermediate buffer,
+     * but transfers can't overlap with the following computation as
+     * the grid will be modified soon after. Requires an MPI datatype
+     * for the cell (see HasAutoGeneratedMPIDataType and
+     * HasPredefinedMPIDataType) and a model which runs on a regular
+     * grid without Struct of Arrays storage.
+     */
+    class HasInPlaceHaloExchange
+    {
+    public:
+        typedef void SupportsInPlaceHaloExchange;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+    /**
+     * Decide whether ghost zones are compressed prior to sending them.
+     */
+    template<typename CELL, typename HAS_HALO_COMPRESSION = void>
+    class SelectHaloCompression
+    {
+    public:
+        typedef FalseType Value;
+
+        static const int MANTISSA_BITS = 52;
+    };
+
+    template<typename CELL>
+    class SelectHaloCompression<CELL, typename CELL::API::SupportsHaloCompression>
+    {
+    public:
+        typedef TrueType Value;
+
+        static const int MANTISSA_BITS = CELL::API::HALO_COMPRESSION_MANTISSA_BITS;
+    };
+
+    /**
+     * Lets the PatchLink compress ghost zones (see HaloCompressor),
+     * which pays off for smooth floating point fields on bandwidth
+     * limited networks. Compression is lossless by default. Setting
+     * MANTISSA_BITS to less than 52 enables the lossy mode, which
+     * rounds each double to the given number of mantissa bits (i.e.
+     * a relative error of at most 2^-(MANTISSA_BITS + 1)). The lossy
+     * mode is only valid for models whose serialized cells consist of
+     * doubles exclusively. Ignored if HasInPlaceHaloExchange is set.
+     */
+    template<int MANTISSA_BITS = 52>
+    class HasHaloCompression
+    {
+    public:
+        typedef void SupportsHaloCompression;
+
+        static const int HALO_COMPRESSION_MANTISSA_BITS = MANTISSA_BITS;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
     template<typename CELL, typename HAS_SPEED = void>
     class SelectStaticData
     {
@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/threadpool.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class ThreadPoolTest : public CxxTest::TestSuite
+{
+public:
+    void testRun()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        ThreadPool pool(4, false);
+        TS_ASSERT_EQUALS(std::size_t(4), pool.size());
+
+        for (int repeat = 0; repeat < 100; ++repeat) {
+            std::vector<int> counters(1000, 0);
+            pool.run(counters.size(), [&](std::size_t i) {
+                    counters[i] += repeat;
+                });
+
+            for (std::size_t i = 0; i < counters.size(); ++i) {
+                TS_ASSERT_EQUALS(repeat, counters[i]);
+            }
+        }
+#endif
+    }
+
+    void testNestedRun()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        ThreadPool pool(3, false);
+        std::vector<int> counters(20 * 30, 0);
+        pool.run(20, [&](std::size_t i) {
+                pool.run(30, [&](std::size_t j) {
+                        ++counters[i * 30 + j];
+                    });
+            });
+
+        TS_ASSERT_EQUALS(std::vector<int>(20 * 30, 1), counters);
+#endif
+    }
+
+    void testException()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        ThreadPool pool(4, false);
+        TS_ASSERT_THROWS(
+            pool.run(100, [](std::size_t i) {
+                    if (i == 47) {
+                        throw std::runtime_error("boom");
+                    }
+                }),
+            std::runtime_error&);
+
+        // the pool needs to remain usable afterwards:
+        std::vector<int> counters(100, 0);
+        pool.run(counters.size(), [&](std::size_t i) {
+                counters[i] = 1;
+            });
+        TS_ASSERT_EQUALS(std::vector<int>(100, 1), counters);
+#endif
+    }
+
+    void testSingleThread()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        ThreadPool pool(1);
+        std::vector<int> counters(10, 0);
+        pool.run(counters.size(), [&](std::size_t i) {
+                counters[i] = i;
+            });
+
+        for (std::size_t i = 0; i < counters.size(); ++i) {
+            TS_ASSERT_EQUALS(int(i), counters[i]);
+        }
+#endif
+    }
+};
+
+}
@@ -0,0 +1,267 @@
+#ifndef LIBGEODECOMP_MISC_THREADPOOL_H
+#define LIBGEODECOMP_MISC_THREADPOOL_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace LibGeoDecomp {
+
+/**
+ * A persistent pool of worker threads for data parallel loops. In
+ * contrast to OpenMP's fork/join model, the threads are created
+ * once and are kept alive across all calls to run(), so frequent
+ * small updates (e.g. small subdomains at high step rates) don't pay
+ * for thread team setup.
+ *
+ * The calling thread participates in the work, so a pool with n
+ * threads spawns n - 1 workers. Tasks are handed out dynamically
+ * via an atomic counter. Idle workers spin for a short while before
+ * they block on a condition variable, so back-to-back calls are
+ * picked up with low latency without burning CPU time in between
+ * time steps.
+ *
+ * On Linux, workers are pinned to the CPUs of the process' affinity
+ * mask (which is typically set up by mpirun), worker i to the
+ * (i + 1)-th CPU. Memory first touched by a worker hence stays local
+ * to its NUMA domain.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t numThreads = defaultNumThreads(), bool pinThreads = true) :
+        numThreads((std::max)(numThreads, std::size_t(1))),
+        generation(0),
+        pending(0),
+        stopping(false),
+        job(0),
+        jobContext(0),
+        numTasks(0),
+        nextTask(0)
+    {
+        for (std::size_t i = 1; i < this->numThreads; ++i) {
+            workers.push_back(std::thread(&ThreadPool::workerLoop, this, i, pinThreads));
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            ++generation;
+        }
+        wakeup.notify_all();
+
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+    }
+
+    /**
+     * The pool which is shared by all ConcurrencyEnableThreadPool
+     * instances. Created upon first use.
+     */
+    static ThreadPool& instance()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /**
+     * Number of CPUs this process may run on.
+     */
+    static std::size_t defaultNumThreads()
+    {
+#ifdef __linux__
+        cpu_set_t cpus;
+        if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0) {
+            return CPU_COUNT(&cpus);
+        }
+#endif
+        return (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Calls functor(i) for all i in [0, numTasks) and returns once
+     * all calls have completed. The first exception thrown by any
+     * task is rethrown here. Concurrent calls are serialized, nested
+     * calls (from within a task) are executed serially by the
+     * calling thread.
+     */
+    template<typename FUNCTOR>
+    void run(std::size_t numTasks, const FUNCTOR& functor)
+    {
+        if (numTasks == 0) {
+            return;
+        }
+
+        if ((numTasks == 1) || workers.empty() || insideTask()) {
+            for (std::size_t i = 0; i < numTasks; ++i) {
+                functor(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(runMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &invoke<FUNCTOR>;
+            jobContext = &functor;
+            this->numTasks = numTasks;
+            nextTask = 0;
+            error = std::exception_ptr();
+            pending = workers.size();
+            ++generation;
+        }
+        wakeup.notify_all();
+
+        work();
+
+        // lightweight barrier: the workers only need to process the
+        // tail of the task list, so we don't block:
+        while (pending.load() != 0) {
+            std::this_thread::yield();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::size_t size() const
+    {
+        return numThreads;
+    }
+
+private:
+    typedef void (*Job)(const void *context, std::size_t task);
+
+    static const int SPIN_LIMIT = 4096;
+
+    std::size_t numThreads;
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::atomic<std::size_t> generation;
+    std::atomic<std::size_t> pending;
+    bool stopping;
+
+    Job job;
+    const void *jobContext;
+    std::size_t numTasks;
+    std::atomic<std::size_t> nextTask;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    ThreadPool(const ThreadPool& other);
+    ThreadPool& operator=(const ThreadPool& other);
+
+    template<typename FUNCTOR>
+    static void invoke(const void *context, std::size_t task)
+    {
+        (*static_cast<const FUNCTOR*>(context))(task);
+    }
+
+    static bool& insideTask()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    void work()
+    {
+        insideTask() = true;
+        for (;;) {
+            std::size_t task = nextTask++;
+            if (task >= numTasks) {
+                break;
+            }
+
+            try {
+                job(jobContext, task);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        insideTask() = false;
+    }
+
+    void workerLoop(std::size_t index, bool pinThread)
+    {
+        if (pinThread) {
+            pin(index);
+        }
+
+        std::size_t seen = 0;
+        for (;;) {
+            for (int spin = 0; generation.load() == seen; ++spin) {
+                if (spin < SPIN_LIMIT) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeup.wait(lock, [this, seen]{ return generation.load() != seen; });
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                seen = generation.load();
+                if (stopping) {
+                    return;
+                }
+            }
+
+            work();
+            --pending;
+        }
+    }
+
+    static void pin(std::size_t index)
+    {
+#ifdef __linux__
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return;
+        }
+
+        std::size_t target = index % CPU_COUNT(&allowed);
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &allowed)) {
+                continue;
+            }
+            if (target-- == 0) {
+                cpu_set_t mask;
+                CPU_ZERO(&mask);
+                CPU_SET(cpu, &mask);
+                pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+                return;
+            }
+        }
+#endif
+    }
+};
+
+}
+
+#endif
+
+#endif
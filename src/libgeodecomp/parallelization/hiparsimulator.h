@@ -29,12 +29,18 @@ namespace LibGeoDecomp {
  * inter-node or inter-NUMA-domain communication and OpenMP and/or
  * CUDA for local paralelism.
  *
+ * UPDATE_GROUP selects how ghost zones are exchanged between
+ * processes: the MPIUpdateGroup uses point-to-point messages per
+ * neighbor, the MPINeighborhoodUpdateGroup bundles them into one
+ * neighborhood collective.
+ *
  * fixme: check if code runs with a communicator which is merely a subset of MPI_COMM_WORLD
  */
 template<
     typename CELL_TYPE,
     typename PARTITION,
-    typename STEPPER = VanillaStepper<CELL_TYPE, UpdateFunctorHelpers::ConcurrencyEnableOpenMP> >
+    typename STEPPER = VanillaStepper<CELL_TYPE, UpdateFunctorHelpers::ConcurrencyEnableOpenMP>,
+    template<typename CELL> class UPDATE_GROUP = MPIUpdateGroup>
 class HiParSimulator : public HierarchicalSimulator<CELL_TYPE>
 {
 public:
@@ -50,7 +56,7 @@ public:
 
     typedef typename DistributedSimulator<CELL_TYPE>::Topology Topology;
     typedef HierarchicalSimulator<CELL_TYPE> ParentType;
-    typedef MPIUpdateGroup<CELL_TYPE> UpdateGroupType;
+    typedef UPDATE_GROUP<CELL_TYPE> UpdateGroupType;
     typedef typename ParentType::GridType GridType;
     typedef ParallelWriterAdapter<typename UpdateGroupType::GridType, CELL_TYPE> ParallelWriterAdapterType;
     typedef SteererAdapter<typename UpdateGroupType::GridType, CELL_TYPE> SteererAdapterType;
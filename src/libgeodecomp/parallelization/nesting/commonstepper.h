@@ -1,6 +1,7 @@
 #ifndef LIBGEODECOMP_PARALLELIZATION_NESTING_COMMONSTEPPER_H
 #define LIBGEODECOMP_PARALLELIZATION_NESTING_COMMONSTEPPER_H
 
+#include <libgeodecomp/geometry/regionhandle.h>
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/parallelization/nesting/stepper.h>
 #include <libgeodecomp/storage/patchbufferfixed.h>
@@ -98,8 +99,8 @@ public:
     virtual void update1() = 0;
 
 protected:
-    std::vector<Region<DIM> > remappedInnerSets;
-    std::vector<Region<DIM> > remappedRims;
+    std::vector<RegionHandle<DIM> > remappedInnerSets;
+    std::vector<RegionHandle<DIM> > remappedRims;
     std::size_t curStep;
     std::size_t curNanoStep;
     unsigned validGhostZoneWidth;
@@ -155,6 +156,32 @@ protected:
         }
     }
 
+    /**
+     * Lets the ghost zone PatchAccepters and PatchProviders advance
+     * their transfers. The rim is sent before the inner set gets
+     * updated, so calling this from within the inner set update
+     * overlaps communication and computation, even if the MPI
+     * implementation won't progress messages in the background.
+     */
+    inline void progressCommunication()
+    {
+        for (typename ParentType::PatchAccepterList::iterator i =
+                 patchAccepters[ParentType::GHOST_PHASE_0].begin();
+             i != patchAccepters[ParentType::GHOST_PHASE_0].end();
+             ++i) {
+            (*i)->progress();
+        }
+
+        for (int patchType = ParentType::GHOST_PHASE_0; patchType <= ParentType::GHOST_PHASE_1; ++patchType) {
+            for (typename ParentType::PatchProviderList::iterator i =
+                     patchProviders[patchType].begin();
+                 i != patchProviders[patchType].end();
+                 ++i) {
+                (*i)->progress();
+            }
+        }
+    }
+
     inline std::size_t globalNanoStep() const
     {
         return curStep * NANO_STEPS + curNanoStep;
@@ -166,6 +193,10 @@ protected:
         CoordBox<DIM> gridBox;
         guessOffset(&gridBox.origin, &gridBox.dimensions);
 
+        // The grids' memory is first touched in parallel upon
+        // allocation (see FirstTouchAllocator), each thread faulting
+        // in the planes it will update. Hence filling them serially
+        // below doesn't move their pages to the master's NUMA domain.
         oldGrid.reset(makeGrid(partitionManager->ownExpandedRegion(), gridBox, topoDim, Topology()));
         newGrid.reset(makeGrid(partitionManager->ownExpandedRegion(), gridBox, topoDim, Topology()));
 
@@ -204,7 +235,7 @@ protected:
 
     inline const Region<DIM>& remappedRim(unsigned offset) const
     {
-        return remappedRims[offset];
+        return *remappedRims[offset];
     }
 
     inline const Region<DIM>& innerSet(unsigned offset) const
@@ -214,7 +245,7 @@ protected:
 
     inline const Region<DIM>& remappedInnerSet(unsigned offset) const
     {
-        return remappedInnerSets[offset];
+        return *remappedInnerSets[offset];
     }
 
     inline const Region<DIM>& getVolatileKernel() const
@@ -301,8 +332,8 @@ protected:
         remappedRims.reserve(ghostZoneWidth() + 1);
 
         for (unsigned i = 0; i <= ghostZoneWidth(); ++i) {
-            remappedInnerSets.push_back(grid.remapRegion(partitionManager->innerSet(i)));
-            remappedRims.push_back(grid.remapRegion(partitionManager->rim(i)));
+            remappedInnerSets.push_back(RegionHandle<DIM>(grid.remapRegion(partitionManager->innerSet(i))));
+            remappedRims.push_back(RegionHandle<DIM>(grid.remapRegion(partitionManager->rim(i))));
         }
     }
 };
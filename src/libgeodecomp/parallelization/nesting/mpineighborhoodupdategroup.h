@@ -0,0 +1,107 @@
+#ifndef LIBGEODECOMP_PARALLELIZATION_NESTING_MPINEIGHBORHOODUPDATEGROUP_H
+#define LIBGEODECOMP_PARALLELIZATION_NESTING_MPINEIGHBORHOODUPDATEGROUP_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/neighborhoodpatchlink.h>
+#include <libgeodecomp/parallelization/nesting/updategroup.h>
+
+#if MPI_VERSION >= 3
+
+namespace LibGeoDecomp {
+
+/**
+ * Alternative to the MPIUpdateGroup which exchanges all ghost zone
+ * fragments of a process via one MPI neighborhood collective per
+ * synchronization point (see NeighborhoodPatchLink). Can be plugged
+ * into the HiParSimulator via its UPDATE_GROUP parameter.
+ */
+template<class CELL_TYPE>
+class MPINeighborhoodUpdateGroup : public UpdateGroup<CELL_TYPE, NeighborhoodPatchLink>
+{
+public:
+    typedef UpdateGroup<CELL_TYPE, NeighborhoodPatchLink> ParentType;
+    typedef typename ParentType::GridType GridType;
+    typedef typename ParentType::PatchAccepterVec PatchAccepterVec;
+    typedef typename ParentType::PatchProviderVec PatchProviderVec;
+    typedef typename ParentType::PatchLinkAccepter PatchLinkAccepter;
+    typedef typename ParentType::PatchLinkProvider PatchLinkProvider;
+    typedef typename ParentType::InitPtr InitPtr;
+    typedef typename ParentType::PartitionPtr PartitionPtr;
+    typedef typename ParentType::PatchLinkAccepterPtr PatchLinkAccepterPtr;
+    typedef typename ParentType::PatchLinkProviderPtr PatchLinkProviderPtr;
+    typedef typename NeighborhoodPatchLink<GridType>::Exchange Exchange;
+    typedef typename NeighborhoodPatchLink<GridType>::ExchangePtr ExchangePtr;
+
+    using ParentType::init;
+    using ParentType::rank;
+
+    const static int DIM = ParentType::DIM;
+
+    template<typename STEPPER>
+    MPINeighborhoodUpdateGroup(
+        PartitionPtr partition,
+        const CoordBox<DIM>& box,
+        unsigned ghostZoneWidth,
+        InitPtr initializer,
+        STEPPER *stepperType,
+        PatchAccepterVec patchAcceptersGhost = PatchAccepterVec(),
+        PatchAccepterVec patchAcceptersInner = PatchAccepterVec(),
+        PatchProviderVec patchProvidersGhost = PatchProviderVec(),
+        PatchProviderVec patchProvidersInner = PatchProviderVec(),
+        bool enableFineGrainedParallelism = false,
+        MPI_Comm communicator = MPI_COMM_WORLD) :
+        ParentType(ghostZoneWidth, initializer, MPILayer(communicator).rank()),
+        mpiLayer(communicator),
+        exchange(new Exchange(SerializationBuffer<CELL_TYPE>::cellMPIDataType(), communicator))
+    {
+        init(
+            partition,
+            box,
+            ghostZoneWidth,
+            initializer,
+            stepperType,
+            patchAcceptersGhost,
+            patchAcceptersInner,
+            patchProvidersGhost,
+            patchProvidersInner,
+            enableFineGrainedParallelism);
+    }
+
+private:
+    MPILayer mpiLayer;
+    ExchangePtr exchange;
+
+    std::vector<CoordBox<DIM> > gatherBoundingBoxes(
+        const CoordBox<DIM>& ownBoundingBox,
+        std::size_t /* unused: size */,
+        std::size_t /* unused: tag */) const
+    {
+        std::vector<CoordBox<DIM> > boundingBoxes(mpiLayer.size());
+        mpiLayer.allGather(ownBoundingBox, &boundingBoxes);
+        return boundingBoxes;
+    }
+
+    virtual PatchLinkAccepterPtr makePatchLinkAccepter(int target, const Region<DIM>& region)
+    {
+        return PatchLinkAccepterPtr(new PatchLinkAccepter(region, target, exchange));
+    }
+
+    virtual PatchLinkProviderPtr makePatchLinkProvider(int source, const Region<DIM>& region)
+    {
+        return PatchLinkProviderPtr(new PatchLinkProvider(region, source, exchange));
+    }
+
+    virtual void commitPatchLinks()
+    {
+        exchange->commit();
+    }
+};
+
+}
+
+#endif
+#endif
+#endif
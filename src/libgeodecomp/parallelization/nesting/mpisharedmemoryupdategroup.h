@@ -0,0 +1,147 @@
+#ifndef LIBGEODECOMP_PARALLELIZATION_NESTING_MPISHAREDMEMORYUPDATEGROUP_H
+#define LIBGEODECOMP_PARALLELIZATION_NESTING_MPISHAREDMEMORYUPDATEGROUP_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/communication/patchlink.h>
+#include <libgeodecomp/communication/sharedmemorypatchlink.h>
+#include <libgeodecomp/parallelization/nesting/updategroup.h>
+
+#if MPI_VERSION >= 3
+
+namespace LibGeoDecomp {
+
+/**
+ * Variant of the MPIUpdateGroup which connects processes located on
+ * the same node via SharedMemoryPatchLinks. Neighbors on other nodes
+ * are served by regular PatchLinks. Cells without a fixed size
+ * serialization always use PatchLinks. Can be plugged into the
+ * HiParSimulator via its UPDATE_GROUP parameter.
+ */
+template<class CELL_TYPE>
+class MPISharedMemoryUpdateGroup : public UpdateGroup<CELL_TYPE, PatchLink>
+{
+public:
+    typedef UpdateGroup<CELL_TYPE, PatchLink> ParentType;
+    typedef typename ParentType::GridType GridType;
+    typedef typename ParentType::PatchAccepterVec PatchAccepterVec;
+    typedef typename ParentType::PatchProviderVec PatchProviderVec;
+    typedef typename ParentType::PatchLinkAccepter PatchLinkAccepter;
+    typedef typename ParentType::PatchLinkProvider PatchLinkProvider;
+    typedef typename ParentType::InitPtr InitPtr;
+    typedef typename ParentType::PartitionPtr PartitionPtr;
+    typedef typename ParentType::PatchLinkAccepterPtr PatchLinkAccepterPtr;
+    typedef typename ParentType::PatchLinkProviderPtr PatchLinkProviderPtr;
+    typedef typename SharedMemoryPatchLink<GridType>::Accepter SharedMemoryAccepter;
+    typedef typename SharedMemoryPatchLink<GridType>::Provider SharedMemoryProvider;
+    typedef typename SharedMemoryPatchLink<GridType>::FixedSize FixedSize;
+    typedef typename SharedMemoryPatchLink<GridType>::Window Window;
+    typedef typename SharedMemoryPatchLink<GridType>::WindowPtr WindowPtr;
+
+    using ParentType::init;
+    using ParentType::rank;
+
+    const static int DIM = ParentType::DIM;
+
+    template<typename STEPPER>
+    MPISharedMemoryUpdateGroup(
+        PartitionPtr partition,
+        const CoordBox<DIM>& box,
+        unsigned ghostZoneWidth,
+        InitPtr initializer,
+        STEPPER *stepperType,
+        PatchAccepterVec patchAcceptersGhost = PatchAccepterVec(),
+        PatchAccepterVec patchAcceptersInner = PatchAccepterVec(),
+        PatchProviderVec patchProvidersGhost = PatchProviderVec(),
+        PatchProviderVec patchProvidersInner = PatchProviderVec(),
+        bool enableFineGrainedParallelism = false,
+        MPI_Comm communicator = MPI_COMM_WORLD) :
+        ParentType(ghostZoneWidth, initializer, MPILayer(communicator).rank()),
+        mpiLayer(communicator),
+        window(new Window(communicator))
+    {
+        init(
+            partition,
+            box,
+            ghostZoneWidth,
+            initializer,
+            stepperType,
+            patchAcceptersGhost,
+            patchAcceptersInner,
+            patchProvidersGhost,
+            patchProvidersInner,
+            enableFineGrainedParallelism);
+    }
+
+private:
+    MPILayer mpiLayer;
+    WindowPtr window;
+
+    std::vector<CoordBox<DIM> > gatherBoundingBoxes(
+        const CoordBox<DIM>& ownBoundingBox,
+        std::size_t /* unused: size */,
+        std::size_t /* unused: tag */) const
+    {
+        std::vector<CoordBox<DIM> > boundingBoxes(mpiLayer.size());
+        mpiLayer.allGather(ownBoundingBox, &boundingBoxes);
+        return boundingBoxes;
+    }
+
+    bool useSharedMemory(int peer) const
+    {
+        return FixedSize() && window->isNodeLocal(peer);
+    }
+
+    virtual PatchLinkAccepterPtr makePatchLinkAccepter(int target, const Region<DIM>& region)
+    {
+        if (useSharedMemory(target)) {
+            return PatchLinkAccepterPtr(
+                new SharedMemoryAccepter(
+                    region,
+                    target,
+                    SerializationBuffer<CELL_TYPE>::cellMPIDataType(),
+                    window));
+        }
+
+        return PatchLinkAccepterPtr(
+            new PatchLinkAccepter(
+                region,
+                target,
+                MPILayer::PATCH_LINK,
+                SerializationBuffer<CELL_TYPE>::cellMPIDataType(),
+                mpiLayer.communicator()));
+    }
+
+    virtual PatchLinkProviderPtr makePatchLinkProvider(int source, const Region<DIM>& region)
+    {
+        if (useSharedMemory(source)) {
+            return PatchLinkProviderPtr(
+                new SharedMemoryProvider(
+                    region,
+                    source,
+                    SerializationBuffer<CELL_TYPE>::cellMPIDataType(),
+                    window));
+        }
+
+        return PatchLinkProviderPtr(
+            new PatchLinkProvider(
+                region,
+                source,
+                MPILayer::PATCH_LINK,
+                SerializationBuffer<CELL_TYPE>::cellMPIDataType(),
+                mpiLayer.communicator()));
+    }
+
+    virtual void commitPatchLinks()
+    {
+        window->commit();
+    }
+};
+
+}
+
+#endif
+#endif
+#endif
@@ -6,48 +6,332 @@
 
 #include <libgeodecomp/parallelization/nesting/commonstepper.h>
 #include <libgeodecomp/storage/patchbufferfixed.h>
+#include <libgeodecomp/storage/updatefunctor.h>
+
+#include <omp.h>
 
 namespace LibGeoDecomp {
 
 /**
  * MultiCoreStepper is an OpenMP-enabled implementation of the Stepper
- * concept.
+ * concept. It follows the same algorithm as the VanillaStepper, but
+ * splits each nano step's update region into tiles which are run as
+ * OpenMP tasks. The task scheduler lets idle threads pick up
+ * pending tiles, so threads don't wait at the end of each streak
+ * chunk like they would with a bulk-synchronous parallel for.
+ *
+ * Tiles which intersect the rim (i.e. the cells whose values need to
+ * be sent to neighboring nodes) are spawned first and with a higher
+ * task priority (if supported by the OpenMP implementation) so that
+ * they're finished as early as possible. Interior tiles fill the
+ * remaining time.
  *
  * fixme: how to handle threading if user code has a multithreaded
  *        update() itself? (e.g. n-body codes)
- *
- * fixme: cache blocking?
- *
- * fixme: mpi pacing?
  */
 template<typename CELL_TYPE>
 class MultiCoreStepper : public CommonStepper<CELL_TYPE>
 {
 public:
+    friend class MultiCoreStepperTest;
+
     typedef typename Stepper<CELL_TYPE>::Topology Topology;
-    typedef typename Stepper<CELL_TYPE>::InitPtr InitPtr;
-    typedef typename Stepper<CELL_TYPE>::PartitionManagerPtr PartitionManagerPtr;
-    typedef class Stepper<CELL_TYPE> ParentType;
+    const static int DIM = Topology::DIM;
+    const static unsigned NANO_STEPS = APITraits::SelectNanoSteps<CELL_TYPE>::VALUE;
+
+    /**
+     * Minimum number of cells per tile. Smaller tiles don't amortize
+     * the task overhead.
+     */
+    const static std::size_t MIN_TILE_SIZE = 1024;
+
+    /**
+     * Tiles per thread. Over-decomposition lets the scheduler
+     * balance uneven tile costs.
+     */
+    const static std::size_t TILES_PER_THREAD = 4;
+
+    /**
+     * 1D Streaks (e.g. remapped unstructured grids) are only split
+     * at multiples of this, so SELL-C-SIGMA chunks remain intact.
+     */
+    const static int TILE_ALIGNMENT = 64;
+
+    typedef class CommonStepper<CELL_TYPE> ParentType;
     typedef typename ParentType::GridType GridType;
     typedef PartitionManager<Topology> PartitionManagerType;
     typedef PatchBufferFixed<GridType, GridType, 1> PatchBufferType1;
     typedef PatchBufferFixed<GridType, GridType, 2> PatchBufferType2;
     typedef typename ParentType::PatchAccepterVec PatchAccepterVec;
+    typedef typename ParentType::PatchProviderVec PatchProviderVec;
+    typedef typename ParentType::InitPtr InitPtr;
+    typedef typename ParentType::PartitionManagerPtr PartitionManagerPtr;
+    typedef std::vector<Region<DIM> > TileVec;
 
-    const static int DIM = Topology::DIM;
-    const static unsigned NANO_STEPS = APITraits::SelectNanoSteps<CELL_TYPE>::VALUE;
+    using ParentType::initializer;
+    using ParentType::patchAccepters;
+    using ParentType::patchProviders;
+    using ParentType::partitionManager;
+    using ParentType::chronometer;
+
+    using ParentType::innerSet;
+    using ParentType::remappedInnerSet;
+    using ParentType::saveKernel;
+    using ParentType::restoreRim;
+    using ParentType::globalNanoStep;
+    using ParentType::rim;
+    using ParentType::remappedRim;
+    using ParentType::resetValidGhostZoneWidth;
+    using ParentType::initGridsCommon;
+    using ParentType::saveRim;
+    using ParentType::restoreKernel;
+    using ParentType::progressCommunication;
+
+    using ParentType::curStep;
+    using ParentType::curNanoStep;
+    using ParentType::validGhostZoneWidth;
+    using ParentType::ghostZoneWidth;
+    using ParentType::oldGrid;
+    using ParentType::newGrid;
 
     inline MultiCoreStepper(
         PartitionManagerPtr partitionManager,
         InitPtr initializer,
         const PatchAccepterVec& ghostZonePatchAccepters = PatchAccepterVec(),
-        const PatchAccepterVec& innerSetPatchAccepters = PatchAccepterVec()) :
-        CommonStepper<CELL_TYPE>(
+        const PatchAccepterVec& innerSetPatchAccepters = PatchAccepterVec(),
+        const PatchProviderVec& ghostZonePatchProvidersPhase0 = PatchProviderVec(),
+        const PatchProviderVec& ghostZonePatchProvidersPhase1 = PatchProviderVec(),
+        const PatchProviderVec& innerSetPatchProviders = PatchProviderVec(),
+        bool enableFineGrainedParallelism = false) :
+        ParentType(
             partitionManager,
             initializer,
             ghostZonePatchAccepters,
-            innerSetPatchAccepters)
-    {}
+            innerSetPatchAccepters,
+            ghostZonePatchProvidersPhase0,
+            ghostZonePatchProvidersPhase1,
+            innerSetPatchProviders,
+            enableFineGrainedParallelism)
+    {
+        initGrids();
+    }
+
+private:
+    // tiles of the remapped inner sets, split into those which
+    // intersect the rim and those which don't:
+    std::vector<TileVec> innerRimTiles;
+    std::vector<TileVec> innerTiles;
+    // tiles of the remapped rims:
+    std::vector<TileVec> rimTiles;
+
+    inline void update1()
+    {
+        using std::swap;
+        TimeTotal t(&chronometer);
+        unsigned index = ghostZoneWidth() - --validGhostZoneWidth;
+        {
+            TimeComputeInner t(&chronometer);
+
+            runTiles(innerRimTiles[index], innerTiles[index]);
+            swap(oldGrid, newGrid);
+
+            ++curNanoStep;
+            if (curNanoStep == NANO_STEPS) {
+                curNanoStep = 0;
+                ++curStep;
+            }
+        }
+
+        progressCommunication();
+        this->notifyPatchAccepters(innerSet(ghostZoneWidth()), ParentType::INNER_SET, globalNanoStep());
+
+        if (validGhostZoneWidth == 0) {
+            updateGhost();
+            resetValidGhostZoneWidth();
+        }
+
+        index = ghostZoneWidth() - validGhostZoneWidth;
+        const Region<DIM>& nextRegion = innerSet(index);
+        this->notifyPatchProviders(nextRegion, ParentType::INNER_SET, globalNanoStep());
+    }
+
+    inline void initGrids()
+    {
+        initGridsCommon();
+        initTiles();
+
+        this->notifyPatchAccepters(
+            rim(),
+            ParentType::GHOST_PHASE_0,
+            globalNanoStep());
+        this->notifyPatchAccepters(
+            innerSet(ghostZoneWidth()),
+            ParentType::INNER_SET,
+            globalNanoStep());
+
+        saveRim(globalNanoStep());
+        updateGhost();
+    }
+
+    inline void initTiles()
+    {
+        std::size_t numTiles = std::size_t(omp_get_max_threads()) * TILES_PER_THREAD;
+        const Region<DIM>& rimMask = remappedRim(0);
+
+        innerRimTiles.resize(ghostZoneWidth() + 1);
+        innerTiles.resize(ghostZoneWidth() + 1);
+        rimTiles.resize(ghostZoneWidth() + 1);
+
+        for (unsigned i = 0; i <= ghostZoneWidth(); ++i) {
+            const Region<DIM>& inner = remappedInnerSet(i);
+            innerRimTiles[i] = splitIntoTiles(inner & rimMask, numTiles);
+            innerTiles[i]    = splitIntoTiles(inner - rimMask, numTiles);
+            rimTiles[i]      = splitIntoTiles(remappedRim(i), numTiles);
+        }
+    }
+
+    /**
+     * Chops a Region into roughly numTiles parts of consecutive
+     * Streaks, each at least MIN_TILE_SIZE cells large. Streaks are
+     * kept intact except for 1D Regions, where tiles would otherwise
+     * grow too large.
+     */
+    static TileVec splitIntoTiles(const Region<DIM>& region, std::size_t numTiles)
+    {
+        TileVec ret;
+        if (region.empty()) {
+            return ret;
+        }
+
+        std::size_t tileSize = (std::max)(std::size_t(MIN_TILE_SIZE), region.size() / numTiles + 1);
+        Region<DIM> tile;
+        std::size_t currentSize = 0;
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            Streak<DIM> streak = *i;
+
+            while ((DIM == 1) && (std::size_t(streak.length()) + currentSize > tileSize)) {
+                int cut = streak.origin.x() + int(tileSize - currentSize);
+                cut = (cut + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT * TILE_ALIGNMENT;
+                if (cut >= streak.endX) {
+                    break;
+                }
+
+                tile << Streak<DIM>(streak.origin, cut);
+                ret << tile;
+                tile.clear();
+                currentSize = 0;
+                streak.origin.x() = cut;
+            }
+
+            tile << streak;
+            currentSize += std::size_t(streak.length());
+
+            if (currentSize >= tileSize) {
+                ret << tile;
+                tile.clear();
+                currentSize = 0;
+            }
+        }
+
+        if (!tile.empty()) {
+            ret << tile;
+        }
+
+        return ret;
+    }
+
+    inline void runTiles(const TileVec& highPriorityTiles, const TileVec& lowPriorityTiles)
+    {
+        unsigned nanoStep = unsigned(curNanoStep);
+        const GridType& source = *oldGrid;
+        GridType *target = &*newGrid;
+
+#pragma omp parallel
+#pragma omp single
+        {
+            for (std::size_t i = 0; i < highPriorityTiles.size(); ++i) {
+#if _OPENMP >= 201511
+#pragma omp task firstprivate(i) priority(1)
+#else
+#pragma omp task firstprivate(i)
+#endif
+                updateTile(highPriorityTiles[i], source, target, nanoStep);
+            }
+
+            for (std::size_t i = 0; i < lowPriorityTiles.size(); ++i) {
+#pragma omp task firstprivate(i)
+                updateTile(lowPriorityTiles[i], source, target, nanoStep);
+            }
+        }
+    }
+
+    static inline void updateTile(const Region<DIM>& tile, const GridType& source, GridType *target, unsigned nanoStep)
+    {
+        UpdateFunctor<CELL_TYPE, UpdateFunctorHelpers::ConcurrencyNoP>()(
+            tile,
+            Coord<DIM>(),
+            Coord<DIM>(),
+            source,
+            target,
+            nanoStep,
+            UpdateFunctorHelpers::ConcurrencyNoP());
+    }
+
+    /**
+     * see VanillaStepper::updateGhost()
+     */
+    inline void updateGhost()
+    {
+        using std::swap;
+        {
+            TimeComputeGhost t(&chronometer);
+
+            saveKernel();
+            restoreRim(false);
+        }
+
+        std::size_t oldNanoStep = curNanoStep;
+        std::size_t oldStep = curStep;
+        std::size_t curGlobalNanoStep = globalNanoStep();
+
+        for (std::size_t t = 0; t < ghostZoneWidth(); ++t) {
+            this->notifyPatchProviders(rim(t), ParentType::GHOST_PHASE_0, globalNanoStep());
+            this->notifyPatchProviders(rim(t), ParentType::GHOST_PHASE_1, globalNanoStep());
+
+            {
+                TimeComputeGhost timer(&chronometer);
+
+                runTiles(rimTiles[t + 1], TileVec());
+
+                ++curNanoStep;
+                if (curNanoStep == NANO_STEPS) {
+                    curNanoStep = 0;
+                    curStep++;
+                }
+
+                swap(oldGrid, newGrid);
+
+                ++curGlobalNanoStep;
+            }
+
+            this->notifyPatchAccepters(rim(ghostZoneWidth()), ParentType::GHOST_PHASE_0, curGlobalNanoStep);
+        }
+
+        {
+            TimeComputeGhost t(&chronometer);
+
+            saveRim(curGlobalNanoStep);
+            if (ghostZoneWidth() % 2) {
+                swap(oldGrid, newGrid);
+            }
+
+            curNanoStep = oldNanoStep;
+            curStep = oldStep;
+            restoreRim(true);
+            restoreKernel();
+        }
+    }
 };
 
 }
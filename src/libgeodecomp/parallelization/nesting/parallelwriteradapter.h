@@ -7,7 +7,11 @@
 
 namespace LibGeoDecomp {
 
-template<typename CELL_TYPE, typename PARTITION, typename STEPPER>
+template<
+    typename CELL_TYPE,
+    typename PARTITION,
+    typename STEPPER,
+    template<typename CELL> class UPDATE_GROUP>
 class HiParSimulator;
 
 /**
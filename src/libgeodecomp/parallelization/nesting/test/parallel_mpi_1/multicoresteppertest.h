@@ -3,6 +3,7 @@
 #include <libgeodecomp.h>
 #include <libgeodecomp/io/testinitializer.h>
 #include <libgeodecomp/misc/testhelper.h>
+#include <libgeodecomp/misc/unstructuredtestcell.h>
 #include <libgeodecomp/parallelization/nesting/multicorestepper.h>
 #include <libgeodecomp/storage/mockpatchaccepter.h>
 
@@ -10,7 +11,7 @@ using namespace LibGeoDecomp;
 
 namespace LibGeoDecomp {
 
-class MulticoreStepperTest : public CxxTest::TestSuite
+class MultiCoreStepperTest : public CxxTest::TestSuite
 {
 public:
     typedef APITraits::SelectTopology<TestCell<2> >::Value Topology;
@@ -21,7 +22,8 @@ public:
 
     void setUp()
     {
-        init.reset(new TestInitializer<TestCell<2> >(Coord<2>(17, 12)));
+#ifdef LIBGEODECOMP_WITH_THREADS
+        init.reset(new TestInitializer<TestCell<2> >(Coord<2>(170, 120)));
         CoordBox<2> rect = init->gridBox();
 
         patchAccepter.reset(new MockPatchAccepter<GridType>());
@@ -30,26 +32,92 @@ public:
         patchAccepter->pushRequest(13);
 
         partitionManager.reset(new PartitionManager<Topology>(rect));
-        // stepper.reset(
-        //     new StepperType(partitionManager, init));
+        stepper.reset(new StepperType(partitionManager, init));
+
+        stepper->addPatchAccepter(patchAccepter, StepperType::GHOST_PHASE_0);
+#endif
+    }
+
+    void tearDown()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        stepper.reset();
+#endif
+    }
+
+    void testUpdate1()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 0);
+        stepper->update1();
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 1);
+#endif
+    }
+
+    void testUpdateMultiple()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        stepper->update(8);
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 8);
+        stepper->update(30);
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 38);
+#endif
+    }
 
-        // stepper->addPatchAccepter(patchAccepter, StepperType::GHOST);
+    void testPutPatch()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        stepper->update(9);
+        TS_ASSERT_EQUALS(std::size_t(2), patchAccepter->getOfferedNanoSteps().size());
+
+        stepper->update(4);
+        TS_ASSERT_EQUALS(std::size_t(3), patchAccepter->getOfferedNanoSteps().size());
+#endif
     }
 
-    void testFoo()
+    void testSplitIntoTiles()
     {
 #ifdef LIBGEODECOMP_WITH_THREADS
-        std::cout << "fixme\n";
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(10, 20), Coord<2>(100, 200));
+        std::vector<Region<2> > tiles = StepperType::splitIntoTiles(region, 8);
+
+        TS_ASSERT_EQUALS(std::size_t(8), tiles.size());
+        Region<2> all;
+        for (std::size_t i = 0; i < tiles.size(); ++i) {
+            TS_ASSERT((all & tiles[i]).empty());
+            TS_ASSERT_LESS_THAN_EQUALS(StepperType::MIN_TILE_SIZE, tiles[i].size());
+            all += tiles[i];
+        }
+        TS_ASSERT_EQUALS(region, all);
+
+        // no splitting into tiles smaller than MIN_TILE_SIZE:
+        tiles = StepperType::splitIntoTiles(region, 1000);
+        TS_ASSERT_EQUALS(std::size_t(19), tiles.size());
+
+        // 1D Streaks are split at aligned offsets:
+        Region<1> region1D;
+        region1D << Streak<1>(Coord<1>(10), 10000);
+        std::vector<Region<1> > tiles1D = MultiCoreStepper<UnstructuredTestCell<> >::splitIntoTiles(region1D, 4);
+        TS_ASSERT_EQUALS(std::size_t(4), tiles1D.size());
+        Region<1> all1D;
+        for (std::size_t i = 0; i < tiles1D.size(); ++i) {
+            if (i > 0) {
+                TS_ASSERT_EQUALS(0, tiles1D[i].beginStreak()->origin.x() % 64);
+            }
+            all1D += tiles1D[i];
+        }
+        TS_ASSERT_EQUALS(region1D, all1D);
 #endif
     }
 
 private:
+#ifdef LIBGEODECOMP_WITH_THREADS
     SharedPtr<TestInitializer<TestCell<2> > >::Type init;
     SharedPtr<PartitionManager<Topology> >::Type partitionManager;
-#ifdef LIBGEODECOMP_WITH_THREADS
     SharedPtr<StepperType>::Type stepper;
-#endif
     SharedPtr<MockPatchAccepter<GridType> >::Type patchAccepter;
+#endif
 };
 
 }
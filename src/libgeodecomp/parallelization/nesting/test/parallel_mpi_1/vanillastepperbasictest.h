@@ -57,6 +57,55 @@ public:
         TS_ASSERT_EQUALS(std::size_t(3), patchAccepter->getOfferedNanoSteps().size());
     }
 
+    void testWavefront()
+    {
+        typedef TestCell<3, Stencils::Moore<3, 1>, Topologies::Cube<3>::Topology> TestCell3D;
+        typedef DisplacedGrid<TestCell3D, Topologies::Cube<3>::Topology, true> GridType3D;
+        typedef VanillaStepper<TestCell3D, UpdateFunctorHelpers::ConcurrencyNoP> StepperType3D;
+        typedef PartitionManager<Topologies::Cube<3>::Topology> PartitionManagerType3D;
+
+        SharedPtr<TestInitializer<TestCell3D> >::Type init3D(
+            new TestInitializer<TestCell3D>(Coord<3>(13, 11, 29)));
+        std::vector<std::size_t> weights(1, init3D->gridBox().dimensions.prod());
+        SharedPtr<Partition<3> >::Type partition(
+            new StripingPartition<3>(Coord<3>(), init3D->gridBox().dimensions, 0, weights));
+
+        SharedPtr<PartitionManagerType3D>::Type partitionManager3D(new PartitionManagerType3D());
+        partitionManager3D->resetRegions(
+            makeShared(new DummyAdjacencyManufacturer<3>()),
+            init3D->gridBox(),
+            partition,
+            0,
+            3);
+
+        std::vector<CoordBox<3> > boundingBoxes(1, init3D->gridBox());
+        partitionManager3D->resetGhostZones(boundingBoxes, boundingBoxes);
+
+        SharedPtr<MockPatchAccepter<GridType3D> >::Type innerSetAccepter(new MockPatchAccepter<GridType3D>());
+        innerSetAccepter->pushRequest(6);
+        innerSetAccepter->pushRequest(10);
+
+        StepperType3D stepper3D(partitionManager3D, init3D);
+        stepper3D.addPatchAccepter(innerSetAccepter, StepperType3D::INNER_SET);
+        TS_ASSERT_EQUALS(std::size_t(29), stepper3D.wavefrontFrames.size());
+
+        // 0 -> 3 -> 6 can be blocked, 6 -> 9 can't as step 10 needs
+        // to be put in the middle of the following cycle:
+        TS_ASSERT(stepper3D.wavefrontApplicable(3));
+        TS_ASSERT(!stepper3D.wavefrontApplicable(2));
+        stepper3D.update(5);
+        TS_ASSERT_TEST_GRID(GridType3D, stepper3D.grid(), 5);
+        stepper3D.update(7);
+        TS_ASSERT_TEST_GRID(GridType3D, stepper3D.grid(), 12);
+
+        std::deque<std::size_t> expectedNanoSteps;
+        expectedNanoSteps << 6 << 10;
+        TS_ASSERT_EQUALS(expectedNanoSteps, innerSetAccepter->getOfferedNanoSteps());
+
+        stepper3D.update(19);
+        TS_ASSERT_TEST_GRID(GridType3D, stepper3D.grid(), 31);
+    }
+
 private:
     SharedPtr<TestInitializer<TestCell<2> > >::Type init;
     SharedPtr<PartitionManager<Topologies::Cube<2>::Topology> >::Type partitionManager;
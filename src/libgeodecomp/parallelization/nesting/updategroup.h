@@ -171,7 +171,8 @@ protected:
             box,
             partition,
             rank,
-            ghostZoneWidth);
+            ghostZoneWidth,
+            stencilRegion());
         std::size_t size = partition->getWeights().size();
         std::vector<CoordBox<DIM> > boundingBoxes =
             gatherBoundingBoxes(partitionManager->ownRegion().boundingBox(), size, 0);
@@ -240,6 +241,8 @@ protected:
             patchProvidersInner[i]->setRegion(partitionManager->ownRegion());
         }
 
+        commitPatchLinks();
+
         stepper.reset(
             new STEPPER(
                 partitionManager,
@@ -254,6 +257,23 @@ protected:
                 enableFineGrainedParallelism));
     }
 
+    /**
+     * Cells which don't specify a stencil default to a 2D Moore
+     * neighborhood (see APITraits::SelectStencil), which doesn't
+     * carry over to other dimensions. An empty Region makes the
+     * PartitionManager fall back to a Moore neighborhood of matching
+     * dimensionality.
+     */
+    Region<DIM> stencilRegion() const
+    {
+        typedef typename APITraits::SelectStencil<CELL_TYPE>::Value Stencil;
+        if (int(Stencil::DIM) != DIM) {
+            return Region<DIM>();
+        }
+
+        return Region<DIM>::fromStencil(Stencil());
+    }
+
     virtual std::vector<CoordBox<DIM> > gatherBoundingBoxes(
         const CoordBox<DIM>& ownBoundingBox,
         std::size_t size,
@@ -261,6 +281,13 @@ protected:
 
     virtual PatchLinkAccepterPtr makePatchLinkAccepter(int target, const Region<DIM>& region) = 0;
     virtual PatchLinkProviderPtr makePatchLinkProvider(int source, const Region<DIM>& region) = 0;
+
+    /**
+     * Called once all PatchLinks have been created, but before the
+     * Stepper (and hence the first ghost zone exchange) is set up.
+     */
+    virtual void commitPatchLinks()
+    {}
 };
 
 }
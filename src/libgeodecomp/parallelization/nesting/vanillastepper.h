@@ -13,6 +13,17 @@ namespace LibGeoDecomp {
  * calculation and support wide halos (halos = ghostzones). Ghost
  * zones of width k mean that synchronization only needs to be done
  * every k'th (nano) step.
+ *
+ * The rim for the next k steps is computed (and handed to the ghost
+ * zone PatchAccepters, which send it non-blockingly) before the inner
+ * set is updated. Pending transfers are pushed forward between the
+ * inner set updates and only waited for at the next ghost zone
+ * update.
+ *
+ * For k > 1 the k updates of the inner set between two ghost zone
+ * updates are performed as a temporally blocked wavefront (see
+ * update()), which keeps the working set in cache and thus raises
+ * the arithmetic intensity of memory-bound kernels.
  */
 template<typename CELL_TYPE, typename CONCURRENCY_SPEC>
 class VanillaStepper : public CommonStepper<CELL_TYPE>
@@ -23,6 +34,7 @@ public:
     friend class VanillaStepperTest;
 
     typedef typename Stepper<CELL_TYPE>::Topology Topology;
+    typedef typename APITraits::SelectStencil<CELL_TYPE>::Value Stencil;
     const static int DIM = Topology::DIM;
     const static unsigned NANO_STEPS = APITraits::SelectNanoSteps<CELL_TYPE>::VALUE;
 
@@ -66,6 +78,7 @@ public:
     using ParentType::kernelBuffer;
     using ParentType::kernelFraction;
     using ParentType::enableFineGrainedParallelism;
+    using ParentType::progressCommunication;
 
     inline VanillaStepper(
         PartitionManagerPtr partitionManager,
@@ -89,7 +102,34 @@ public:
         initGrids();
     }
 
+    /**
+     * Runs whole cycles of ghostZoneWidth() nano steps as a single
+     * wavefront sweep over the inner set where possible. We fall
+     * back to update1() for partial cycles and for cycles during
+     * which inner set PatchAccepters/Providers need to access an
+     * intermediate time step.
+     */
+    inline virtual void update(std::size_t nanoSteps)
+    {
+        for (std::size_t i = 0; i < nanoSteps;) {
+            if (wavefrontApplicable(nanoSteps - i)) {
+                updateWavefront();
+                i += ghostZoneWidth();
+            } else {
+                update1();
+                ++i;
+            }
+        }
+    }
+
 private:
+    /**
+     * frames for the wavefront update, indexed by slab and stage
+     * (i.e. time step within the cycle). Empty if the wavefront
+     * update is not applicable.
+     */
+    std::vector<std::vector<Region<DIM> > > wavefrontFrames;
+
     inline void update1()
     {
         using std::swap;
@@ -116,6 +156,7 @@ private:
             }
         }
 
+        progressCommunication();
         this->notifyPatchAccepters(innerSet(ghostZoneWidth()), ParentType::INNER_SET, globalNanoStep());
 
         if (validGhostZoneWidth == 0) {
@@ -143,6 +184,158 @@ private:
 
         saveRim(globalNanoStep());
         updateGhost();
+        initWavefrontFrames();
+    }
+
+    /**
+     * Slices the inner sets into slabs along the outermost axis,
+     * similarly to CacheBlockingSimulator::generateWavefrontFrames().
+     * A slab's thickness equals the stencil's radius, so a stage
+     * trailing its predecessor by one slab will only read cells
+     * which have already been updated by that predecessor, and none
+     * which have already been overwritten by its successor.
+     */
+    inline void initWavefrontFrames()
+    {
+        wavefrontFrames.clear();
+        unsigned stages = ghostZoneWidth();
+        if ((stages < 2) || !wavefrontSupported(Topology())) {
+            return;
+        }
+
+        CoordBox<DIM> box = remappedInnerSet(1).boundingBox();
+        if (box.dimensions.prod() == 0) {
+            return;
+        }
+
+        int slabWidth = (std::max)(1, int(Stencil::RADIUS));
+        int zBegin = box.origin[DIM - 1];
+        int zEnd = zBegin + box.dimensions[DIM - 1];
+
+        // stencil accesses which wrap around the outermost axis would
+        // reach cells which get updated at a different sweep:
+        if (Topology::template WrapsAxis<DIM - 1>::VALUE &&
+            ((zBegin - slabWidth < 0) || (zEnd + slabWidth > initializer->gridDimensions()[DIM - 1]))) {
+            return;
+        }
+
+        for (int z = zBegin; z < zEnd; z += slabWidth) {
+            CoordBox<DIM> slab = box;
+            slab.origin[DIM - 1] = z;
+            slab.dimensions[DIM - 1] = (std::min)(slabWidth, zEnd - z);
+            Region<DIM> mask;
+            mask << slab;
+
+            std::vector<Region<DIM> > frames(stages);
+            for (unsigned stage = 0; stage < stages; ++stage) {
+                frames[stage] = remappedInnerSet(stage + 1) & mask;
+            }
+
+            wavefrontFrames.push_back(frames);
+        }
+    }
+
+    inline bool wavefrontSupported(const Topologies::Unstructured::Topology& /* unused */) const
+    {
+        return false;
+    }
+
+    template<typename TOPOLOGY>
+    inline bool wavefrontSupported(const TOPOLOGY& /* unused */) const
+    {
+        return true;
+    }
+
+    inline bool wavefrontApplicable(std::size_t remainingNanoSteps)
+    {
+        if (wavefrontFrames.empty() ||
+            (validGhostZoneWidth != ghostZoneWidth()) ||
+            (remainingNanoSteps < ghostZoneWidth())) {
+            return false;
+        }
+
+        std::size_t begin = globalNanoStep();
+        std::size_t end = begin + ghostZoneWidth();
+
+        typedef typename ParentType::PatchAccepterList PatchAccepterList;
+        PatchAccepterList& accepters = patchAccepters[ParentType::INNER_SET];
+        for (typename PatchAccepterList::iterator i = accepters.begin(); i != accepters.end(); ++i) {
+            std::size_t nanoStep = (*i)->nextRequiredNanoStep();
+            if ((nanoStep > begin) && (nanoStep < end)) {
+                return false;
+            }
+        }
+
+        typedef typename ParentType::PatchProviderList PatchProviderList;
+        PatchProviderList& providers = patchProviders[ParentType::INNER_SET];
+        for (typename PatchProviderList::iterator i = providers.begin(); i != providers.end(); ++i) {
+            std::size_t nanoStep = (*i)->nextAvailableNanoStep();
+            if ((nanoStep > begin) && (nanoStep < end)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Equivalent to ghostZoneWidth() calls of update1(), but stage s
+     * (i.e. nano step s of the cycle) processes slab (sweep - s)
+     * during each sweep, so all stages run on neighboring slabs while
+     * these are still in cache. Stages alternate between oldGrid and
+     * newGrid, just like consecutive calls to update1() would.
+     */
+    inline void updateWavefront()
+    {
+        using std::swap;
+        TimeTotal t(&chronometer);
+        unsigned stages = ghostZoneWidth();
+        std::size_t numSlabs = wavefrontFrames.size();
+        GridType *grids[] = { &*oldGrid, &*newGrid };
+
+        {
+            TimeComputeInner t(&chronometer);
+
+            for (std::size_t sweep = 0; sweep < (numSlabs + stages - 1); ++sweep) {
+                for (unsigned stage = 0; (stage < stages) && (stage <= sweep); ++stage) {
+                    std::size_t slab = sweep - stage;
+                    if ((slab >= numSlabs) || wavefrontFrames[slab][stage].empty()) {
+                        continue;
+                    }
+
+                    UpdateFunctor<CELL_TYPE, CONCURRENCY_SPEC>()(
+                        wavefrontFrames[slab][stage],
+                        Coord<DIM>(),
+                        Coord<DIM>(),
+                        *grids[(stage + 0) % 2],
+                        grids[(stage + 1) % 2],
+                        unsigned((curNanoStep + stage) % NANO_STEPS),
+                        CONCURRENCY_SPEC(false, enableFineGrainedParallelism));
+                }
+
+                progressCommunication();
+            }
+
+            if (stages % 2) {
+                swap(oldGrid, newGrid);
+            }
+
+            for (unsigned stage = 0; stage < stages; ++stage) {
+                ++curNanoStep;
+                if (curNanoStep == NANO_STEPS) {
+                    curNanoStep = 0;
+                    ++curStep;
+                }
+            }
+        }
+
+        validGhostZoneWidth = 0;
+        this->notifyPatchAccepters(innerSet(ghostZoneWidth()), ParentType::INNER_SET, globalNanoStep());
+
+        updateGhost();
+        resetValidGhostZoneWidth();
+
+        this->notifyPatchProviders(innerSet(0), ParentType::INNER_SET, globalNanoStep());
     }
 
     /**
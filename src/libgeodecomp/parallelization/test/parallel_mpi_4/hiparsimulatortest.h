@@ -1,3 +1,4 @@
+#include <libgeodecomp/geometry/partitions/multilevelunstructuredpartition.h>
 #include <libgeodecomp/geometry/partitions/zcurvepartition.h>
 #include <libgeodecomp/io/mocksteerer.h>
 #include <libgeodecomp/io/mockwriter.h>
@@ -13,6 +14,9 @@
 #include <libgeodecomp/misc/testcell.h>
 #include <libgeodecomp/misc/testhelper.h>
 #include <libgeodecomp/parallelization/hiparsimulator.h>
+#include <libgeodecomp/parallelization/nesting/mpineighborhoodupdategroup.h>
+#include <libgeodecomp/parallelization/nesting/mpisharedmemoryupdategroup.h>
+#include <libgeodecomp/parallelization/nesting/multicorestepper.h>
 
 #include <cxxtest/TestSuite.h>
 #include <sstream>
@@ -626,6 +630,120 @@ public:
         sim.run();
     }
 
+    void testWriterFunctionality3DWithMultiCoreStepper()
+    {
+        typedef HiParSimulator<TestCell<3>, ZCurvePartition<3>, MultiCoreStepper<TestCell<3> > > SimulatorType;
+        int maxTimeSteps = 30;
+        Coord<3> dim(40, 35, 30);
+
+        TestInitializer<TestCell<3> > *init = new TestInitializer<TestCell<3> >(dim, maxTimeSteps);
+        int loadBalancingPeriod = 10;
+        int ghostZoneWidth = 3;
+        SimulatorType sim(
+            init,
+            new MockBalancer(),
+            loadBalancingPeriod,
+            ghostZoneWidth);
+
+        std::vector<unsigned> expectedWriterSteps;
+        std::vector<WriterEvent> expectedWriterEvents;
+
+        expectedWriterSteps <<  0
+                            <<  5
+                            << 10
+                            << 15
+                            << 20
+                            << 25
+                            << 30;
+
+        expectedWriterEvents << WRITER_INITIALIZED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_ALL_DONE;
+
+        sim.addWriter(new ParallelTestWriter<TestCell<3> >(5, expectedWriterSteps, expectedWriterEvents));
+        sim.run();
+    }
+
+    void testWriterFunctionality3DWithNeighborhoodCollectives()
+    {
+#if MPI_VERSION >= 3
+        typedef HiParSimulator<
+            TestCell<3>,
+            ZCurvePartition<3>,
+            VanillaStepper<TestCell<3>, UpdateFunctorHelpers::ConcurrencyEnableOpenMP>,
+            MPINeighborhoodUpdateGroup> SimulatorType;
+        int maxTimeSteps = 30;
+        Coord<3> dim(40, 35, 30);
+
+        TestInitializer<TestCell<3> > *init = new TestInitializer<TestCell<3> >(dim, maxTimeSteps);
+        int loadBalancingPeriod = 10;
+        int ghostZoneWidth = 2;
+        SimulatorType sim(
+            init,
+            new MockBalancer(),
+            loadBalancingPeriod,
+            ghostZoneWidth);
+
+        std::vector<unsigned> expectedWriterSteps;
+        std::vector<WriterEvent> expectedWriterEvents;
+
+        expectedWriterSteps <<  0
+                            << 10
+                            << 20
+                            << 30;
+
+        expectedWriterEvents << WRITER_INITIALIZED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_ALL_DONE;
+
+        sim.addWriter(new ParallelTestWriter<TestCell<3> >(10, expectedWriterSteps, expectedWriterEvents));
+        sim.run();
+#endif
+    }
+
+    void testWriterFunctionality3DWithSharedMemoryLinks()
+    {
+#if MPI_VERSION >= 3
+        typedef HiParSimulator<
+            TestCell<3>,
+            ZCurvePartition<3>,
+            VanillaStepper<TestCell<3>, UpdateFunctorHelpers::ConcurrencyEnableOpenMP>,
+            MPISharedMemoryUpdateGroup> SimulatorType;
+        int maxTimeSteps = 30;
+        Coord<3> dim(40, 35, 30);
+
+        TestInitializer<TestCell<3> > *init = new TestInitializer<TestCell<3> >(dim, maxTimeSteps);
+        int loadBalancingPeriod = 10;
+        int ghostZoneWidth = 2;
+        SimulatorType sim(
+            init,
+            new MockBalancer(),
+            loadBalancingPeriod,
+            ghostZoneWidth);
+
+        std::vector<unsigned> expectedWriterSteps;
+        std::vector<WriterEvent> expectedWriterEvents;
+
+        expectedWriterSteps <<  0
+                            << 10
+                            << 20
+                            << 30;
+
+        expectedWriterEvents << WRITER_INITIALIZED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_STEP_FINISHED
+                             << WRITER_ALL_DONE;
+
+        sim.addWriter(new ParallelTestWriter<TestCell<3> >(10, expectedWriterSteps, expectedWriterEvents));
+        sim.run();
+#endif
+    }
+
     void testWriterFunctionality2DWithGhostZoneWidth4()
     {
         typedef HiParSimulator<TestCell<2>, ZCurvePartition<2> > SimulatorType;
@@ -1353,6 +1471,38 @@ public:
 #endif
     }
 
+    void testUnstructuredWithMultilevelPartition()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef UnstructuredTestCell<> TestCellType;
+
+        int startStep = 7;
+        int endStep = 20;
+
+        HiParSimulator<TestCellType, MultilevelUnstructuredPartition> sim(
+            new UnstructuredTestInitializer<TestCellType>(614, endStep, startStep),
+            rank? 0 : new NoOpBalancer());
+
+        std::vector<unsigned> expectedSteps;
+        std::vector<WriterEvent> expectedEvents;
+        expectedSteps << 7
+                      << 9
+                      << 12
+                      << 15
+                      << 18
+                      << 20;
+        expectedEvents << WRITER_INITIALIZED
+                       << WRITER_STEP_FINISHED
+                       << WRITER_STEP_FINISHED
+                       << WRITER_STEP_FINISHED
+                       << WRITER_STEP_FINISHED
+                       << WRITER_ALL_DONE;
+        sim.addWriter(new ParallelTestWriter<TestCellType>(3, expectedSteps, expectedEvents));
+
+        sim.run();
+#endif
+    }
+
     void testUnstructuredSoA1()
     {
 #ifdef LIBGEODECOMP_WITH_CPP14
@@ -4,16 +4,19 @@
 #include <libgeodecomp/geometry/coord.h>
 #include <libgeodecomp/geometry/fixedcoord.h>
 #include <libgeodecomp/geometry/topologies.h>
+#include <libgeodecomp/storage/firsttouchallocator.h>
 
 namespace LibGeoDecomp {
 
-template<typename CELL_TYPE, typename TOPOLOGY>
+template<typename CELL_TYPE, typename TOPOLOGY, typename ALLOCATOR>
 class Grid;
 
 /**
  * provides access to neighboring cells in a grid via relative coordinates. Slow!
  */
-template<typename CELL_TYPE, typename GRID_TYPE=Grid<CELL_TYPE, Topologies::Cube<2>::Topology> >
+template<
+    typename CELL_TYPE,
+    typename GRID_TYPE=Grid<CELL_TYPE, Topologies::Cube<2>::Topology, FirstTouchAllocator<CELL_TYPE, 64> > >
 class CoordMap
 {
 public:
@@ -108,11 +108,12 @@ private:
  * normalized according to the given topology and some superordinate
  * dimension (see topologicalDimensions()) before using them for
  * access. Useful for writing topology agnostic code that should work
- * an a torus, too.
+ * an a torus, too. ALLOCATOR is passed on to the underlying Grid.
  */
 template<typename CELL_TYPE,
          typename TOPOLOGY=Topologies::Cube<2>::Topology,
-         bool TOPOLOGICALLY_CORRECT=false>
+         bool TOPOLOGICALLY_CORRECT=false,
+         typename ALLOCATOR=FirstTouchAllocator<CELL_TYPE, 64> >
 class DisplacedGrid : public GridBase<CELL_TYPE, TOPOLOGY::DIM>
 {
 public:
@@ -120,7 +121,8 @@ public:
 
     typedef CELL_TYPE Cell;
     typedef TOPOLOGY Topology;
-    typedef Grid<CELL_TYPE, TOPOLOGY> Delegate;
+    typedef ALLOCATOR Allocator;
+    typedef Grid<CELL_TYPE, TOPOLOGY, ALLOCATOR> Delegate;
     typedef CoordMap<CELL_TYPE, Delegate> CoordMapType;
 
     using GridBase<CELL_TYPE, TOPOLOGY::DIM>::loadRegion;
@@ -429,10 +431,10 @@ private:
 
 }
 
-template<typename _CharT, typename _Traits, typename _CellT, typename _Topology, bool _Correctness>
+template<typename _CharT, typename _Traits, typename _CellT, typename _Topology, bool _Correctness, typename _Allocator>
 std::basic_ostream<_CharT, _Traits>&
 operator<<(std::basic_ostream<_CharT, _Traits>& __os,
-           const LibGeoDecomp::DisplacedGrid<_CellT, _Topology, _Correctness>& grid)
+           const LibGeoDecomp::DisplacedGrid<_CellT, _Topology, _Correctness, _Allocator>& grid)
 {
     __os << grid.toString();
     return __os;
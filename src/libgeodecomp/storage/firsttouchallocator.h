@@ -0,0 +1,232 @@
+#ifndef LIBGEODECOMP_STORAGE_FIRSTTOUCHALLOCATOR_H
+#define LIBGEODECOMP_STORAGE_FIRSTTOUCHALLOCATOR_H
+
+#include <libflatarray/aligned_allocator.hpp>
+#include <libgeodecomp/config.h>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace LibGeoDecomp {
+
+/**
+ * Operating systems place a page of memory on the NUMA domain of the
+ * thread which writes to it first, not the one which allocates it.
+ * FirstTouch faults in freshly allocated grid memory from all OpenMP
+ * threads, each thread touching the part it will later update.
+ *
+ * The decomposition mirrors the static schedule of the
+ * UpdateFunctor: the k-th of n threads receives the k-th of n
+ * contiguous chunks. As cells are stored plane by plane, this
+ * corresponds to the planes the thread is assigned during updates.
+ * Memory layouts where this isn't a single contiguous block per
+ * thread (e.g. Struct of Arrays) are described by a list of
+ * segments, which are each split among all threads.
+ *
+ * For the placement to be effective, threads have to be pinned
+ * (e.g. OMP_PROC_BIND=true). Optionally, each thread's pages may be
+ * bound to its NUMA domain (see setNUMABinding()), so the kernel
+ * won't place them elsewhere when that domain runs low on memory.
+ */
+class FirstTouch
+{
+public:
+    /**
+     * Smaller buffers are left to the allocating thread, spawning a
+     * thread team would cost more than it gains.
+     */
+    static const std::size_t MIN_BYTES = 1 << 20;
+
+    /**
+     * Segment layout for buffers which hold a single array, e.g. a
+     * Grid's cells.
+     */
+    class ContiguousLayout
+    {
+    public:
+        static void segments(std::size_t byteSize, std::vector<std::size_t> *boundaries)
+        {
+            boundaries->push_back(0);
+            boundaries->push_back(byteSize);
+        }
+    };
+
+    /**
+     * If enabled, all subsequently allocated grids will have each
+     * thread's pages bound to the NUMA domain the thread runs on
+     * (Linux only, via mbind(2)). Binding is best effort: if the
+     * kernel refuses, pages are still placed by first touch.
+     */
+    static void setNUMABinding(bool enabled)
+    {
+        numaBindingFlag() = enabled;
+    }
+
+    static bool numaBinding()
+    {
+        return numaBindingFlag();
+    }
+
+    /**
+     * Faults in the pages of [data, data + byteSize) in parallel.
+     * boundaries lists the byte offsets of the segments, starting
+     * with 0 and ending with byteSize.
+     */
+    static void touch(char *data, std::size_t byteSize, const std::vector<std::size_t>& boundaries)
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        if ((byteSize < MIN_BYTES) || omp_in_parallel()) {
+            return;
+        }
+
+        std::size_t pageSize = defaultPageSize();
+        bool bind = numaBinding();
+
+#pragma omp parallel
+        {
+            std::size_t numThreads = omp_get_num_threads();
+            std::size_t thread = omp_get_thread_num();
+
+            for (std::size_t segment = 0; segment < (boundaries.size() - 1); ++segment) {
+                char *begin = partitionBoundary(data, boundaries, segment, thread + 0, numThreads, pageSize);
+                char *end   = partitionBoundary(data, boundaries, segment, thread + 1, numThreads, pageSize);
+                if (begin >= end) {
+                    continue;
+                }
+
+                if (bind) {
+                    bindToLocalNode(begin, end);
+                }
+
+                for (char *page = begin; page < end; page += pageSize) {
+                    char *address = (std::max)(page, data);
+                    if (address < (data + byteSize)) {
+                        *static_cast<volatile char*>(address) = 0;
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+    /**
+     * Returns the page-aligned start of the thread's chunk within
+     * the given segment. A page belongs to the thread whose chunk
+     * contains the page's first byte, so chunks of adjacent threads
+     * never share a page. The very first page of the buffer may
+     * start in front of data.
+     */
+    static char *partitionBoundary(
+        char *data,
+        const std::vector<std::size_t>& boundaries,
+        std::size_t segment,
+        std::size_t thread,
+        std::size_t numThreads,
+        std::size_t pageSize)
+    {
+        std::size_t segmentBegin = boundaries[segment];
+        std::size_t segmentLength = boundaries[segment + 1] - segmentBegin;
+        std::size_t address = reinterpret_cast<std::size_t>(data) + segmentBegin + segmentLength * thread / numThreads;
+
+        if ((segment == 0) && (thread == 0)) {
+            return reinterpret_cast<char*>(address / pageSize * pageSize);
+        }
+
+        return reinterpret_cast<char*>((address + pageSize - 1) / pageSize * pageSize);
+    }
+
+    static std::size_t defaultPageSize()
+    {
+#ifdef __linux__
+        long pageSize = sysconf(_SC_PAGESIZE);
+        if (pageSize > 0) {
+            return pageSize;
+        }
+#endif
+        return 4096;
+    }
+
+private:
+    static bool& numaBindingFlag()
+    {
+        static bool flag = false;
+        return flag;
+    }
+
+    static void bindToLocalNode(char *begin, char *end)
+    {
+#if defined(__linux__) && defined(SYS_getcpu) && defined(SYS_mbind)
+        unsigned cpu;
+        unsigned node;
+        if (syscall(SYS_getcpu, &cpu, &node, 0) != 0) {
+            return;
+        }
+
+        const unsigned long maskBits = sizeof(unsigned long) * 8;
+        if (node >= maskBits) {
+            return;
+        }
+
+        unsigned long mask = 1ul << node;
+        // the kernel expects the number of bits in the mask plus one:
+        syscall(SYS_mbind, begin, std::size_t(end - begin), MPOL_BIND, &mask, maskBits + 1, 0);
+#endif
+    }
+};
+
+/**
+ * An aligned allocator which lets all OpenMP threads first-touch the
+ * memory it hands out, see FirstTouch. LAYOUT describes how the
+ * buffer is to be split into segments.
+ */
+template<typename T, std::size_t ALIGNMENT, typename LAYOUT = FirstTouch::ContiguousLayout>
+class FirstTouchAllocator : public LibFlatArray::aligned_allocator<T, ALIGNMENT>
+{
+public:
+    typedef LibFlatArray::aligned_allocator<T, ALIGNMENT> ParentType;
+    typedef typename ParentType::pointer pointer;
+
+    template<typename OTHER>
+    struct rebind
+    {
+        typedef FirstTouchAllocator<OTHER, ALIGNMENT, LAYOUT> other;
+    };
+
+    inline FirstTouchAllocator()
+    {}
+
+    template<typename OTHER>
+    inline FirstTouchAllocator(const FirstTouchAllocator<OTHER, ALIGNMENT, LAYOUT>& /* other */)
+    {}
+
+    pointer allocate(std::size_t n, const void *hint = 0)
+    {
+        pointer ret = ParentType::allocate(n, hint);
+        if (ret == 0) {
+            return ret;
+        }
+
+        std::size_t byteSize = n * sizeof(T);
+        if (byteSize >= FirstTouch::MIN_BYTES) {
+            std::vector<std::size_t> boundaries;
+            LAYOUT::segments(byteSize, &boundaries);
+            FirstTouch::touch(reinterpret_cast<char*>(ret), byteSize, boundaries);
+        }
+
+        return ret;
+    }
+};
+
+}
+
+#endif
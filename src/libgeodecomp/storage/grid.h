@@ -1,7 +1,6 @@
 #ifndef LIBGEODECOMP_STORAGE_GRID_H
 #define LIBGEODECOMP_STORAGE_GRID_H
 
-#include <libflatarray/aligned_allocator.hpp>
 #include <libgeodecomp/geometry/coord.h>
 #include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/region.h>
@@ -9,6 +8,7 @@
 #include <libgeodecomp/io/logger.h>
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/storage/coordmap.h>
+#include <libgeodecomp/storage/firsttouchallocator.h>
 #include <libgeodecomp/storage/gridbase.h>
 #include <libgeodecomp/storage/selector.h>
 
@@ -41,9 +41,13 @@ class CoordMap;
 #endif
 
 /**
- * A multi-dimensional regular grid
+ * A multi-dimensional regular grid. ALLOCATOR manages the cells'
+ * memory, see e.g. HugePageAllocator.
  */
-template<typename CELL_TYPE, typename TOPOLOGY=Topologies::Cube<2>::Topology>
+template<
+    typename CELL_TYPE,
+    typename TOPOLOGY=Topologies::Cube<2>::Topology,
+    typename ALLOCATOR=FirstTouchAllocator<CELL_TYPE, 64> >
 class Grid : public GridBase<CELL_TYPE, TOPOLOGY::DIM>
 {
 public:
@@ -55,11 +59,13 @@ public:
     using GridBase<CELL_TYPE, TOPOLOGY::DIM>::loadRegion;
     using GridBase<CELL_TYPE, TOPOLOGY::DIM>::saveRegion;
 
-    // always align on cache line boundaries
-    typedef typename std::vector<CELL_TYPE, LibFlatArray::aligned_allocator<CELL_TYPE, 64> > CellVector;
+    // by default we align on cache line boundaries, pages are first
+    // touched by the threads which will later update them:
+    typedef typename std::vector<CELL_TYPE, ALLOCATOR> CellVector;
     typedef TOPOLOGY Topology;
     typedef CELL_TYPE Cell;
-    typedef CoordMap<CELL_TYPE, Grid<CELL_TYPE, TOPOLOGY> > CoordMapType;
+    typedef ALLOCATOR Allocator;
+    typedef CoordMap<CELL_TYPE, Grid> CoordMapType;
 
     explicit Grid(
         const Coord<DIM>& dim = Coord<DIM>(),
@@ -497,10 +503,10 @@ private:
 #pragma warning( pop )
 #endif
 
-template<typename _CharT, typename _Traits, typename _CellT, typename _TopologyT>
+template<typename _CharT, typename _Traits, typename _CellT, typename _TopologyT, typename _AllocatorT>
 std::basic_ostream<_CharT, _Traits>&
 operator<<(std::basic_ostream<_CharT, _Traits>& __os,
-           const Grid<_CellT, _TopologyT>& grid)
+           const Grid<_CellT, _TopologyT, _AllocatorT>& grid)
 {
     __os << grid.toString();
     return __os;
@@ -0,0 +1,282 @@
+#ifndef LIBGEODECOMP_STORAGE_HALOCOMPRESSOR_H
+#define LIBGEODECOMP_STORAGE_HALOCOMPRESSOR_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Compresses serialized ghost zones (see APITraits::HasHaloCompression)
+ * prior to their transmission. Floating point fields are often smooth,
+ * so neighboring values share sign, exponent and leading mantissa bits.
+ * The encoder exploits this in three passes:
+ *
+ * 1. XOR delta: each byte is XORed with the corresponding byte of the
+ *    preceding element (deltaDistance bytes earlier), which zeroes the
+ *    shared leading bits.
+ *
+ * 2. Byte shuffle: bytes are regrouped by their position within an
+ *    8 byte word, so the (now mostly zero) high order bytes form long
+ *    runs.
+ *
+ * 3. Zero run length encoding: the stream is stored as alternating
+ *    runs of zeros and literals, each prefixed with its varint
+ *    encoded length.
+ *
+ * The lossy mode additionally rounds the mantissa of each double to
+ * the given number of bits beforehand, which bounds the relative error
+ * by 2^-(mantissaBits + 1) and clears the low order bytes.
+ *
+ * Large buffers are split into chunks which are compressed
+ * independently, and in parallel if threading is enabled.
+ */
+class HaloCompressor
+{
+public:
+    friend class HaloCompressorTest;
+
+    static const std::size_t WORD_SIZE = 8;
+    static const int LOSSLESS = 52;
+
+    /**
+     * deltaDistance should match the size of one element within the
+     * buffer (e.g. sizeof(CELL) for Array of Structs buffers), so
+     * that each value is XORed with the same member of its
+     * predecessor. The chunk size is rounded to a multiple of
+     * deltaDistance and the word size.
+     */
+    explicit HaloCompressor(
+        std::size_t deltaDistance = WORD_SIZE,
+        int mantissaBits = LOSSLESS,
+        std::size_t chunkSize = 1 << 16) :
+        deltaDistance(deltaDistance),
+        mantissaBits(mantissaBits),
+        chunkSize(roundChunkSize(chunkSize, deltaDistance))
+    {
+        if ((mantissaBits < 0) || (mantissaBits > LOSSLESS)) {
+            throw std::invalid_argument("HaloCompressor: mantissaBits needs to be in [0, 52]");
+        }
+    }
+
+    void compress(const char *source, std::size_t size, std::vector<char> *target) const
+    {
+        std::size_t numChunks = (size + chunkSize - 1) / chunkSize;
+        std::vector<std::vector<char> > chunks(numChunks);
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(dynamic) if (numChunks > 1)
+#endif
+        for (long i = 0; i < long(numChunks); ++i) {
+            std::size_t offset = i * chunkSize;
+            compressChunk(source + offset, (std::min)(chunkSize, size - offset), &chunks[i]);
+        }
+
+        target->clear();
+        appendWord(target, size);
+        for (std::size_t i = 0; i < numChunks; ++i) {
+            appendWord(target, chunks[i].size());
+        }
+        for (std::size_t i = 0; i < numChunks; ++i) {
+            target->insert(target->end(), chunks[i].begin(), chunks[i].end());
+        }
+    }
+
+    /**
+     * Expects target to hold decompressedSize(source) bytes.
+     */
+    void decompress(const std::vector<char>& source, char *target) const
+    {
+        std::size_t size = decompressedSize(source);
+        std::size_t numChunks = (size + chunkSize - 1) / chunkSize;
+
+        std::vector<std::size_t> offsets(numChunks + 1);
+        offsets[0] = sizeof(uint64_t) * (numChunks + 1);
+        for (std::size_t i = 0; i < numChunks; ++i) {
+            offsets[i + 1] = offsets[i] + readWord(&source[0] + sizeof(uint64_t) * (i + 1));
+        }
+        if (offsets.back() != source.size()) {
+            throw std::logic_error("HaloCompressor: corrupted stream");
+        }
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(dynamic) if (numChunks > 1)
+#endif
+        for (long i = 0; i < long(numChunks); ++i) {
+            std::size_t offset = i * chunkSize;
+            decompressChunk(
+                &source[0] + offsets[i],
+                &source[0] + offsets[i + 1],
+                target + offset,
+                (std::min)(chunkSize, size - offset));
+        }
+    }
+
+    static std::size_t decompressedSize(const std::vector<char>& source)
+    {
+        if (source.size() < sizeof(uint64_t)) {
+            throw std::logic_error("HaloCompressor: truncated stream");
+        }
+        return readWord(&source[0]);
+    }
+
+private:
+    std::size_t deltaDistance;
+    int mantissaBits;
+    std::size_t chunkSize;
+
+    static std::size_t roundChunkSize(std::size_t chunkSize, std::size_t deltaDistance)
+    {
+        std::size_t granularity = deltaDistance * WORD_SIZE;
+        return (std::max)(std::size_t(1), chunkSize / granularity) * granularity;
+    }
+
+    static void appendWord(std::vector<char> *target, uint64_t word)
+    {
+        const char *data = reinterpret_cast<const char*>(&word);
+        target->insert(target->end(), data, data + sizeof(uint64_t));
+    }
+
+    static uint64_t readWord(const char *source)
+    {
+        uint64_t word;
+        std::memcpy(&word, source, sizeof(uint64_t));
+        return word;
+    }
+
+    static void appendVarint(std::vector<char> *target, std::size_t value)
+    {
+        while (value >= 0x80) {
+            *target << char((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        *target << char(value);
+    }
+
+    static std::size_t readVarint(const char **cursor, const char *end)
+    {
+        std::size_t value = 0;
+        for (int shift = 0; ; shift += 7) {
+            if (*cursor == end) {
+                throw std::logic_error("HaloCompressor: truncated stream");
+            }
+            unsigned char byte = **cursor;
+            ++*cursor;
+            value |= std::size_t(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    /**
+     * Rounds the mantissas to the requested precision. Values which
+     * would overflow to infinity are truncated instead, NaNs and
+     * infinities are left untouched.
+     */
+    void roundMantissas(std::vector<char> *buffer) const
+    {
+        int dropBits = LOSSLESS - mantissaBits;
+        uint64_t mask = ~((uint64_t(1) << dropBits) - 1);
+        uint64_t half = uint64_t(1) << (dropBits - 1);
+        uint64_t exponentMask = uint64_t(0x7ff) << 52;
+
+        for (std::size_t offset = 0; offset + WORD_SIZE <= buffer->size(); offset += WORD_SIZE) {
+            char *word = &(*buffer)[offset];
+            uint64_t bits = readWord(word);
+            if ((bits & exponentMask) == exponentMask) {
+                continue;
+            }
+
+            uint64_t rounded = (bits + half) & mask;
+            if ((rounded & exponentMask) == exponentMask) {
+                rounded = bits & mask;
+            }
+            std::memcpy(word, &rounded, sizeof(uint64_t));
+        }
+    }
+
+    void compressChunk(const char *source, std::size_t size, std::vector<char> *target) const
+    {
+        std::vector<char> work(source, source + size);
+        if (mantissaBits < LOSSLESS) {
+            roundMantissas(&work);
+        }
+
+        for (std::size_t i = size; i > deltaDistance; --i) {
+            work[i - 1] ^= work[i - 1 - deltaDistance];
+        }
+
+        std::vector<char> shuffled;
+        shuffled.reserve(size);
+        for (std::size_t plane = 0; plane < WORD_SIZE; ++plane) {
+            for (std::size_t i = plane; i < size; i += WORD_SIZE) {
+                shuffled << work[i];
+            }
+        }
+
+        // single zeros are cheaper to store as literals:
+        const std::size_t minZeroRun = 3;
+        std::size_t i = 0;
+        while (i < size) {
+            std::size_t zeros = 0;
+            while ((i + zeros < size) && (shuffled[i + zeros] == 0)) {
+                ++zeros;
+            }
+            i += zeros;
+
+            std::size_t literals = 0;
+            std::size_t zeroRun = 0;
+            while ((i + literals < size) && (zeroRun < minZeroRun)) {
+                zeroRun = (shuffled[i + literals] == 0) ? zeroRun + 1 : 0;
+                ++literals;
+            }
+            if (zeroRun == minZeroRun) {
+                literals -= zeroRun;
+            }
+
+            appendVarint(target, zeros);
+            appendVarint(target, literals);
+            target->insert(target->end(), shuffled.begin() + i, shuffled.begin() + i + literals);
+            i += literals;
+        }
+    }
+
+    void decompressChunk(const char *cursor, const char *end, char *target, std::size_t size) const
+    {
+        std::vector<char> shuffled;
+        shuffled.reserve(size);
+        while (shuffled.size() < size) {
+            std::size_t zeros = readVarint(&cursor, end);
+            std::size_t literals = readVarint(&cursor, end);
+            if ((shuffled.size() + zeros + literals > size) || (std::size_t(end - cursor) < literals)) {
+                throw std::logic_error("HaloCompressor: corrupted stream");
+            }
+
+            shuffled.resize(shuffled.size() + zeros, 0);
+            shuffled.insert(shuffled.end(), cursor, cursor + literals);
+            cursor += literals;
+        }
+
+        std::size_t index = 0;
+        for (std::size_t plane = 0; plane < WORD_SIZE; ++plane) {
+            for (std::size_t i = plane; i < size; i += WORD_SIZE) {
+                target[i] = shuffled[index++];
+            }
+        }
+
+        for (std::size_t i = deltaDistance; i < size; ++i) {
+            target[i] ^= target[i - deltaDistance];
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef LIBGEODECOMP_STORAGE_HUGEPAGEARENA_H
+#define LIBGEODECOMP_STORAGE_HUGEPAGEARENA_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libflatarray/aligned_allocator.hpp>
+#include <libgeodecomp/storage/firsttouchallocator.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace LibGeoDecomp {
+
+/**
+ * HugePageArena hands out large chunks of memory backed by huge
+ * pages (2 MB or 1 GB on x86), which cuts TLB misses when sweeping
+ * large grids. Released chunks are not returned to the OS but kept
+ * in a pool, so that the repeated resizes of grids and buffers
+ * during load balancing don't pay for mmap() and page faults over
+ * and over again.
+ *
+ * Chunks are obtained via mmap(MAP_HUGETLB). If the system's huge
+ * page pool is exhausted (see /proc/sys/vm/nr_hugepages), the arena
+ * falls back to ordinary pages and asks for transparent huge pages
+ * via madvise(MADV_HUGEPAGE). Requests smaller than MIN_BYTES are
+ * served from the heap, as rounding them up to a huge page would
+ * waste too much memory.
+ */
+class HugePageArena
+{
+public:
+    static const std::size_t PAGE_2MB = std::size_t(1) << 21;
+    static const std::size_t PAGE_1GB = std::size_t(1) << 30;
+    static const std::size_t MIN_BYTES = std::size_t(1) << 20;
+
+    /**
+     * Pooled chunks may be up to this factor larger than the
+     * request they're handed out for.
+     */
+    static const std::size_t MAX_OVERSIZE = 2;
+
+    class Statistics
+    {
+    public:
+        Statistics() :
+            numAllocations(0),
+            numDeallocations(0),
+            numReuses(0),
+            numMappings(0),
+            numFallbacks(0),
+            bytesMapped(0),
+            bytesInUse(0),
+            peakBytesInUse(0)
+        {}
+
+        std::string toString() const
+        {
+            std::stringstream buf;
+            buf << "HugePageArena::Statistics(allocations: " << numAllocations
+                << ", deallocations: " << numDeallocations
+                << ", reuses: " << numReuses
+                << ", mappings: " << numMappings
+                << ", fallbacks: " << numFallbacks
+                << ", bytesMapped: " << bytesMapped
+                << ", bytesInUse: " << bytesInUse
+                << ", peakBytesInUse: " << peakBytesInUse
+                << ")";
+            return buf.str();
+        }
+
+        /**
+         * Number of chunks handed out, including those which were
+         * reused from the pool.
+         */
+        std::size_t numAllocations;
+        std::size_t numDeallocations;
+        /**
+         * Allocations which were served from the pool.
+         */
+        std::size_t numReuses;
+        /**
+         * Allocations which required a new mapping.
+         */
+        std::size_t numMappings;
+        /**
+         * Mappings which couldn't be backed by explicit huge pages.
+         */
+        std::size_t numFallbacks;
+        /**
+         * Bytes currently mapped, including pooled chunks.
+         */
+        std::size_t bytesMapped;
+        std::size_t bytesInUse;
+        std::size_t peakBytesInUse;
+    };
+
+    explicit HugePageArena(std::size_t pageSize = PAGE_2MB) :
+        pageSize(pageSize)
+    {}
+
+    ~HugePageArena()
+    {
+        release();
+    }
+
+    /**
+     * The arena which is shared by all HugePageAllocators with the
+     * given page size. It's never destroyed, so that containers
+     * with static storage duration may safely outlive it.
+     */
+    template<std::size_t PAGE_SIZE>
+    static HugePageArena& instance()
+    {
+        static HugePageArena *arena = new HugePageArena(PAGE_SIZE);
+        return *arena;
+    }
+
+    void *allocate(std::size_t bytes)
+    {
+        std::size_t size = roundUp(bytes);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.numAllocations;
+
+        void *ret = 0;
+        ChunkMap::iterator i = pool.lower_bound(size);
+        if ((i != pool.end()) && (i->first <= (size * MAX_OVERSIZE))) {
+            ++stats.numReuses;
+            size = i->first;
+            ret = i->second;
+            pool.erase(i);
+        } else {
+            ret = map(size);
+            ++stats.numMappings;
+            stats.bytesMapped += size;
+        }
+
+        chunks[ret] = size;
+        stats.bytesInUse += size;
+        stats.peakBytesInUse = (std::max)(stats.peakBytesInUse, stats.bytesInUse);
+        return ret;
+    }
+
+    void deallocate(void *chunk)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        PointerMap::iterator i = chunks.find(chunk);
+        if (i == chunks.end()) {
+            throw std::invalid_argument("chunk was not allocated by this HugePageArena");
+        }
+
+        ++stats.numDeallocations;
+        stats.bytesInUse -= i->second;
+        pool.insert(std::make_pair(i->second, chunk));
+        chunks.erase(i);
+    }
+
+    /**
+     * Returns all pooled chunks to the operating system. Chunks
+     * which are still in use are not affected.
+     */
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (ChunkMap::iterator i = pool.begin(); i != pool.end(); ++i) {
+            unmap(i->second, i->first);
+            stats.bytesMapped -= i->first;
+        }
+        pool.clear();
+    }
+
+    Statistics statistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    std::size_t getPageSize() const
+    {
+        return pageSize;
+    }
+
+private:
+    typedef std::multimap<std::size_t, void*> ChunkMap;
+    typedef std::map<void*, std::size_t> PointerMap;
+
+    std::size_t pageSize;
+    mutable std::mutex mutex;
+    ChunkMap pool;
+    PointerMap chunks;
+    Statistics stats;
+
+    HugePageArena(const HugePageArena& other);
+    HugePageArena& operator=(const HugePageArena& other);
+
+    std::size_t roundUp(std::size_t bytes) const
+    {
+        return (std::max)(std::size_t(1), (bytes + pageSize - 1) / pageSize) * pageSize;
+    }
+
+    void *map(std::size_t size)
+    {
+#ifdef __linux__
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+        int hugeFlags = flags | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+        int log2PageSize = 0;
+        while ((std::size_t(1) << log2PageSize) < pageSize) {
+            ++log2PageSize;
+        }
+        hugeFlags |= (log2PageSize << MAP_HUGE_SHIFT);
+#endif
+        void *ret = mmap(0, size, PROT_READ | PROT_WRITE, hugeFlags, -1, 0);
+        if (ret != MAP_FAILED) {
+            return ret;
+        }
+#endif
+
+        ++stats.numFallbacks;
+        void *fallback = mmap(0, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (fallback == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(fallback, size, MADV_HUGEPAGE);
+#endif
+        return fallback;
+#else
+        ++stats.numFallbacks;
+        return LibFlatArray::aligned_allocator<char, 4096>().allocate(size);
+#endif
+    }
+
+    void unmap(void *chunk, std::size_t size)
+    {
+#ifdef __linux__
+        munmap(chunk, size);
+#else
+        LibFlatArray::aligned_allocator<char, 4096>().deallocate(static_cast<char*>(chunk), size);
+#endif
+    }
+};
+
+/**
+ * Allocator for Grid, DisplacedGrid and SoAGrid which draws large
+ * blocks from the HugePageArena with the given page size. Just like
+ * FirstTouchAllocator, freshly allocated memory is first touched by
+ * all OpenMP threads, as described by LAYOUT. Small requests are
+ * served from the heap, aligned on cache lines.
+ *
+ * Example: a SoAGrid backed by 1 GB pages
+ *
+ *   typedef HugePageAllocator<
+ *       char,
+ *       HugePageArena::PAGE_1GB,
+ *       SoAGridHelpers::FirstTouchLayout<MyCell> > Allocator;
+ *   SoAGrid<MyCell, Topologies::Cube<3>::Topology, false, Allocator> grid(box);
+ */
+template<
+    typename T,
+    std::size_t PAGE_SIZE = HugePageArena::PAGE_2MB,
+    typename LAYOUT = FirstTouch::ContiguousLayout>
+class HugePageAllocator : public LibFlatArray::aligned_allocator<T, 64>
+{
+public:
+    typedef LibFlatArray::aligned_allocator<T, 64> ParentType;
+    typedef typename ParentType::pointer pointer;
+
+    template<typename OTHER>
+    struct rebind
+    {
+        typedef HugePageAllocator<OTHER, PAGE_SIZE, LAYOUT> other;
+    };
+
+    inline HugePageAllocator()
+    {}
+
+    template<typename OTHER>
+    inline HugePageAllocator(const HugePageAllocator<OTHER, PAGE_SIZE, LAYOUT>& /* other */)
+    {}
+
+    static HugePageArena& arena()
+    {
+        return HugePageArena::instance<PAGE_SIZE>();
+    }
+
+    pointer allocate(std::size_t n, const void *hint = 0)
+    {
+        std::size_t byteSize = n * sizeof(T);
+        if (byteSize < HugePageArena::MIN_BYTES) {
+            return ParentType::allocate(n, hint);
+        }
+
+        pointer ret = static_cast<pointer>(arena().allocate(byteSize));
+        std::vector<std::size_t> boundaries;
+        LAYOUT::segments(byteSize, &boundaries);
+        FirstTouch::touch(reinterpret_cast<char*>(ret), byteSize, boundaries);
+
+        return ret;
+    }
+
+    void deallocate(pointer p, std::size_t n)
+    {
+        if ((n * sizeof(T)) < HugePageArena::MIN_BYTES) {
+            ParentType::deallocate(p, n);
+            return;
+        }
+
+        arena().deallocate(p);
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -57,6 +57,14 @@ public:
         // empty as most implementations won't need it anyway.
     }
 
+    /**
+     * Called by Steppers while they're busy computing, so
+     * implementations with pending (e.g. non-blocking) transfers may
+     * push these forward.
+     */
+    virtual void progress()
+    {}
+
     virtual std::size_t nextRequiredNanoStep() const
     {
         if (requestedNanoSteps.empty()) {
@@ -61,6 +61,12 @@ public:
     }
 #endif
 
+    /**
+     * See PatchAccepter::progress()
+     */
+    virtual void progress()
+    {}
+
     virtual std::size_t nextAvailableNanoStep() const
     {
         if (storedNanoSteps.empty()) {
@@ -5,6 +5,7 @@
 #ifdef LIBGEODECOMP_WITH_CPP14
 
 #include <algorithm>
+#include <libgeodecomp/geometry/csradjacency.h>
 #include <libgeodecomp/storage/serializationbuffer.h>
 #include <libgeodecomp/storage/sellcsigmasparsematrixcontainer.h>
 
@@ -283,6 +284,38 @@ public:
         delegate.setWeights(matrixID, std::move(newMatrix));
     }
 
+    /**
+     * Same as above, but reads the matrix' structure from a
+     * CSRAdjacency, which is faster for large graphs as only the rows
+     * of our node set need to be visited. values holds the weights in
+     * the same order as adjacency.getColumns().
+     */
+    inline
+    void setWeights(std::size_t matrixID, const CSRAdjacency& adjacency, const std::vector<WeightType>& values)
+    {
+        if (values.size() != adjacency.size()) {
+            throw std::invalid_argument("number of weights doesn't match number of edges");
+        }
+
+        SparseMatrix matrix;
+        const std::vector<std::size_t>& rowOffsets = adjacency.getRowOffsets();
+        const std::vector<int>& columns = adjacency.getColumns();
+
+        for (Region<1>::StreakIterator i = nodeSet.beginStreak(); i != nodeSet.endStreak(); ++i) {
+            for (int j = i->origin.x(); j != i->endX; ++j) {
+                if ((j < 0) || (std::size_t(j) >= adjacency.numNodes())) {
+                    continue;
+                }
+
+                for (std::size_t k = rowOffsets[std::size_t(j)]; k != rowOffsets[std::size_t(j) + 1]; ++k) {
+                    matrix << std::make_pair(Coord<2>(j, columns[k]), values[k]);
+                }
+            }
+        }
+
+        setWeights(matrixID, matrix);
+    }
+
     /**
      * The extent of this grid class is defined by its node set (given
      * in the c-tor) and the edge weights. Resize doesn't make sense
@@ -8,6 +8,7 @@
 #include <libgeodecomp/geometry/topologies.h>
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/misc/stringops.h>
+#include <libgeodecomp/storage/firsttouchallocator.h>
 #include <libgeodecomp/storage/gridbase.h>
 #include <libgeodecomp/storage/selector.h>
 #include <libgeodecomp/storage/serializationbuffer.h>
@@ -16,6 +17,38 @@ namespace LibGeoDecomp {
 
 namespace SoAGridHelpers {
 
+/**
+ * A soa_grid stores each member in a separate array, ordered just
+ * like the cells. Each of these arrays is a segment which is split
+ * among all threads for first touch, see FirstTouch. Array members
+ * are treated as a single segment.
+ */
+template<typename CELL, long INDEX = LibFlatArray::number_of_members<CELL>::VALUE>
+class FirstTouchLayout
+{
+public:
+    static void segments(std::size_t byteSize, std::vector<std::size_t> *boundaries)
+    {
+        FirstTouchLayout<CELL, INDEX - 1>::segments(byteSize, boundaries);
+        boundaries->push_back(
+            byteSize / LibFlatArray::aggregated_member_size<CELL>::VALUE *
+            LibFlatArray::detail::flat_array::offset<CELL, INDEX>::OFFSET);
+    }
+};
+
+/**
+ * End of recursion
+ */
+template<typename CELL>
+class FirstTouchLayout<CELL, 0>
+{
+public:
+    static void segments(std::size_t /* byteSize */, std::vector<std::size_t> *boundaries)
+    {
+        boundaries->push_back(0);
+    }
+};
+
 /**
  * See below:
  */
@@ -336,11 +369,13 @@ private:
 /**
  * Grid class which corresponds to DisplacedGrid, but utilizes an
  * "Struct of Arrays" (SoA) memory layout. This is beneficial for
- * vectorization.
+ * vectorization. ALLOCATOR manages the byte buffer which holds all
+ * member arrays.
  */
 template<typename CELL,
          typename TOPOLOGY = Topologies::Cube<2>::Topology,
-         bool TOPOLOGICALLY_CORRECT = false>
+         bool TOPOLOGICALLY_CORRECT = false,
+         typename ALLOCATOR = FirstTouchAllocator<char, 4096, SoAGridHelpers::FirstTouchLayout<CELL> > >
 class SoAGrid : public GridBase<CELL, TOPOLOGY::DIM>
 {
 public:
@@ -361,7 +396,8 @@ public:
 
     typedef CELL CellType;
     typedef TOPOLOGY Topology;
-    typedef LibFlatArray::soa_grid<CELL> Delegate;
+    typedef ALLOCATOR Allocator;
+    typedef LibFlatArray::soa_grid<CELL, ALLOCATOR> Delegate;
     typedef typename APITraits::SelectStencil<CELL>::Value Stencil;
 
     explicit SoAGrid(
@@ -515,7 +551,7 @@ public:
     }
 
     template<typename FUNCTOR>
-    void callback(SoAGrid<CELL, TOPOLOGY, TOPOLOGICALLY_CORRECT> *newGrid, FUNCTOR functor) const
+    void callback(SoAGrid *newGrid, FUNCTOR functor) const
     {
         delegate.callback(&newGrid->delegate, functor);
     }
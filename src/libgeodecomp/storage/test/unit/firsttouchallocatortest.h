@@ -0,0 +1,100 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/storage/firsttouchallocator.h>
+#include <libgeodecomp/storage/grid.h>
+#include <libgeodecomp/storage/soagrid.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class FirstTouchAllocatorTest : public CxxTest::TestSuite
+{
+public:
+    void tearDown()
+    {
+        FirstTouch::setNUMABinding(false);
+    }
+
+    void testPartitionsCoverBufferWithoutSharingPages()
+    {
+        char *data = reinterpret_cast<char*>(std::size_t(1) << 30) + 100;
+        std::size_t byteSize = (5 << 20) + 17;
+        std::size_t pageSize = 4096;
+        std::size_t numThreads = 7;
+
+        std::vector<std::size_t> boundaries;
+        boundaries << 0
+                   << (3 << 20) + 5
+                   << byteSize;
+
+        char *last = FirstTouch::partitionBoundary(data, boundaries, 0, 0, numThreads, pageSize);
+        TS_ASSERT(last <= data);
+
+        for (std::size_t segment = 0; segment < 2; ++segment) {
+            // compare addresses, not strings:
+            TS_ASSERT(last == FirstTouch::partitionBoundary(data, boundaries, segment, 0, numThreads, pageSize));
+
+            for (std::size_t thread = 1; thread <= numThreads; ++thread) {
+                char *next = FirstTouch::partitionBoundary(data, boundaries, segment, thread, numThreads, pageSize);
+                TS_ASSERT_EQUALS(std::size_t(0), reinterpret_cast<std::size_t>(next) % pageSize);
+                TS_ASSERT(last <= next);
+                last = next;
+            }
+        }
+
+        TS_ASSERT(last >= (data + byteSize));
+        TS_ASSERT(last <  (data + byteSize + pageSize));
+    }
+
+    void testSoALayout()
+    {
+        std::size_t cells = 1000;
+        std::vector<std::size_t> boundaries;
+        SoAGridHelpers::FirstTouchLayout<TestCellSoA>::segments(
+            cells * LibFlatArray::aggregated_member_size<TestCellSoA>::VALUE, &boundaries);
+
+        // one array per member: 2x Coord<3>, float, unsigned, 2x bool
+        std::vector<std::size_t> expected;
+        expected << 0
+                 << cells * 12
+                 << cells * 24
+                 << cells * 28
+                 << cells * 32
+                 << cells * 33
+                 << cells * 34;
+        TS_ASSERT_EQUALS(expected, boundaries);
+    }
+
+    void testAllocation()
+    {
+        std::vector<double, FirstTouchAllocator<double, 64> > vec(1 << 18, 4.5);
+        TS_ASSERT_EQUALS(std::size_t(0), reinterpret_cast<std::size_t>(&vec[0]) % 64);
+        TS_ASSERT_EQUALS(4.5, vec[0]);
+        TS_ASSERT_EQUALS(4.5, vec[(1 << 18) - 1]);
+
+        FirstTouch::setNUMABinding(true);
+        std::vector<double, FirstTouchAllocator<double, 64> > bound(1 << 18, 1.5);
+        TS_ASSERT_EQUALS(1.5, bound[0]);
+        TS_ASSERT_EQUALS(1.5, bound[(1 << 18) - 1]);
+    }
+
+    void testGrids()
+    {
+        FirstTouch::setNUMABinding(true);
+
+        Coord<3> dim(64, 64, 40);
+        CoordBox<3> box(Coord<3>(), dim);
+        TestCellSoA innerCell(Coord<3>(1, 2, 3), dim, 5, 6.5);
+
+        Grid<TestCellSoA, Topologies::Cube<3>::Topology> grid(dim, innerCell);
+        SoAGrid<TestCellSoA, Topologies::Cube<3>::Topology> soaGrid(box, innerCell);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(innerCell, grid.get(*i));
+            TS_ASSERT_EQUALS(innerCell, soaGrid.get(*i));
+        }
+    }
+};
+
+}
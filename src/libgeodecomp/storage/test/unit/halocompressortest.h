@@ -0,0 +1,121 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/storage/halocompressor.h>
+
+#include <cmath>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class HaloCompressorTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        smooth.clear();
+        for (int i = 0; i < 20000; ++i) {
+            smooth << 300.0 + std::sin(i * 0.001);
+        }
+
+        noise.clear();
+        unsigned seed = 4711;
+        for (int i = 0; i < 1000; ++i) {
+            seed = seed * 1103515245 + 12345;
+            noise << char(seed >> 16);
+        }
+    }
+
+    void testLosslessRoundTrip()
+    {
+        HaloCompressor compressor;
+        std::vector<char> compressed;
+        compressor.compress(bytes(smooth), smooth.size() * sizeof(double), &compressed);
+
+        // high order bytes of neighboring values coincide:
+        TS_ASSERT_LESS_THAN(compressed.size(), smooth.size() * sizeof(double) * 3 / 4);
+        TS_ASSERT_EQUALS(smooth.size() * sizeof(double), HaloCompressor::decompressedSize(compressed));
+
+        std::vector<double> decompressed(smooth.size());
+        compressor.decompress(compressed, reinterpret_cast<char*>(&decompressed[0]));
+        TS_ASSERT_EQUALS(smooth, decompressed);
+    }
+
+    void testRandomData()
+    {
+        // deltaDistance and size deliberately don't match the word size:
+        HaloCompressor compressor(12, HaloCompressor::LOSSLESS, 100);
+        std::vector<char> compressed;
+        compressor.compress(&noise[0], noise.size(), &compressed);
+
+        std::vector<char> decompressed(noise.size());
+        compressor.decompress(compressed, &decompressed[0]);
+        TS_ASSERT_EQUALS(noise, decompressed);
+    }
+
+    void testZeros()
+    {
+        HaloCompressor compressor;
+        std::vector<char> zeros(4096, 0);
+        std::vector<char> compressed;
+        compressor.compress(&zeros[0], zeros.size(), &compressed);
+        TS_ASSERT_LESS_THAN(compressed.size(), std::size_t(32));
+
+        std::vector<char> decompressed(zeros.size(), 1);
+        compressor.decompress(compressed, &decompressed[0]);
+        TS_ASSERT_EQUALS(zeros, decompressed);
+    }
+
+    void testLossy()
+    {
+        std::vector<double> values = smooth;
+        values << 0.0
+               << -1.5e-300
+               << 1.7976931348623157e308
+               << HUGE_VAL;
+
+        int mantissaBits = 20;
+        HaloCompressor lossless;
+        HaloCompressor lossy(HaloCompressor::WORD_SIZE, mantissaBits);
+        std::vector<char> compressedLossless;
+        std::vector<char> compressedLossy;
+        lossless.compress(bytes(values), values.size() * sizeof(double), &compressedLossless);
+        lossy.compress(bytes(values), values.size() * sizeof(double), &compressedLossy);
+        TS_ASSERT_LESS_THAN(compressedLossy.size(), compressedLossless.size() / 2);
+
+        std::vector<double> decompressed(values.size());
+        lossy.decompress(compressedLossy, reinterpret_cast<char*>(&decompressed[0]));
+
+        double bound = std::pow(2.0, -(mantissaBits + 1));
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (values[i] == HUGE_VAL) {
+                TS_ASSERT_EQUALS(values[i], decompressed[i]);
+                continue;
+            }
+            TS_ASSERT_LESS_THAN_EQUALS(std::abs(values[i] - decompressed[i]), std::abs(values[i]) * bound);
+        }
+    }
+
+    void testCorruptedStream()
+    {
+        HaloCompressor compressor;
+        std::vector<char> compressed;
+        compressor.compress(bytes(smooth), smooth.size() * sizeof(double), &compressed);
+        compressed.pop_back();
+
+        std::vector<double> decompressed(smooth.size());
+        TS_ASSERT_THROWS(
+            compressor.decompress(compressed, reinterpret_cast<char*>(&decompressed[0])),
+            std::logic_error&);
+    }
+
+private:
+    std::vector<double> smooth;
+    std::vector<char> noise;
+
+    const char *bytes(const std::vector<double>& values)
+    {
+        return reinterpret_cast<const char*>(&values[0]);
+    }
+};
+
+}
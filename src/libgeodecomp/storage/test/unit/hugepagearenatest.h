@@ -0,0 +1,120 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+#include <libgeodecomp/storage/hugepagearena.h>
+#include <libgeodecomp/storage/soagrid.h>
+
+#include <cstring>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class HugePageArenaTest : public CxxTest::TestSuite
+{
+public:
+    void testPooling()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const std::size_t MB = 1 << 20;
+        HugePageArena arena(HugePageArena::PAGE_2MB);
+
+        char *a = static_cast<char*>(arena.allocate(5 * MB));
+        std::memset(a, 1, 5 * MB);
+        TS_ASSERT_EQUALS(std::size_t(0), reinterpret_cast<std::size_t>(a) % 4096);
+        TS_ASSERT_EQUALS(std::size_t(1), arena.statistics().numMappings);
+        TS_ASSERT_EQUALS(6 * MB, arena.statistics().bytesInUse);
+
+        arena.deallocate(a);
+        TS_ASSERT_EQUALS(0 * MB, arena.statistics().bytesInUse);
+        TS_ASSERT_EQUALS(6 * MB, arena.statistics().bytesMapped);
+
+        // chunk is reused, even for a smaller request...
+        char *b = static_cast<char*>(arena.allocate(3 * MB));
+        TS_ASSERT(a == b);
+        TS_ASSERT_EQUALS(std::size_t(1), arena.statistics().numReuses);
+        TS_ASSERT_EQUALS(6 * MB, arena.statistics().bytesInUse);
+        arena.deallocate(b);
+
+        // ...but not if it's more than twice as large:
+        char *c = static_cast<char*>(arena.allocate(1 * MB));
+        TS_ASSERT_EQUALS(std::size_t(2), arena.statistics().numMappings);
+        TS_ASSERT_EQUALS(8 * MB, arena.statistics().bytesMapped);
+        TS_ASSERT_EQUALS(6 * MB, arena.statistics().peakBytesInUse);
+        arena.deallocate(c);
+
+        arena.release();
+        HugePageArena::Statistics stats = arena.statistics();
+        TS_ASSERT_EQUALS(std::size_t(3), stats.numAllocations);
+        TS_ASSERT_EQUALS(std::size_t(3), stats.numDeallocations);
+        TS_ASSERT_EQUALS(std::size_t(0), stats.bytesMapped);
+        TS_ASSERT_EQUALS(std::size_t(0), stats.bytesInUse);
+
+        TS_ASSERT_THROWS(arena.deallocate(c), std::invalid_argument&);
+#endif
+    }
+
+    void testSmallAllocationsBypassArena()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef HugePageAllocator<int> Allocator;
+        std::size_t allocations = Allocator::arena().statistics().numAllocations;
+
+        std::vector<int, Allocator> vec(1000, 47);
+        TS_ASSERT_EQUALS(47, vec[999]);
+        TS_ASSERT_EQUALS(allocations, Allocator::arena().statistics().numAllocations);
+#endif
+    }
+
+    void testDisplacedGridReusesBuffersAcrossResizes()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef HugePageAllocator<double> Allocator;
+        typedef DisplacedGrid<double, Topologies::Cube<3>::Topology, false, Allocator> GridType;
+        HugePageArena::Statistics before = Allocator::arena().statistics();
+
+        CoordBox<3> box(Coord<3>(10, 20, 30), Coord<3>(64, 64, 64));
+        GridType grid(box, 1.5);
+        TS_ASSERT_EQUALS(1.5, grid[Coord<3>(73, 83, 93)]);
+
+        // growing reallocates...
+        grid.resize(CoordBox<3>(Coord<3>(), Coord<3>(64, 64, 80)));
+        grid[Coord<3>(63, 63, 79)] = 2.5;
+        TS_ASSERT_EQUALS(2.5, grid[Coord<3>(63, 63, 79)]);
+
+        // ...and the released buffer is reused by the next grid:
+        GridType other(box, 4.5);
+        TS_ASSERT_EQUALS(4.5, other[Coord<3>(10, 20, 30)]);
+
+        HugePageArena::Statistics after = Allocator::arena().statistics();
+        TS_ASSERT_EQUALS(before.numAllocations + 3, after.numAllocations);
+        TS_ASSERT_EQUALS(before.numDeallocations + 1, after.numDeallocations);
+        TS_ASSERT_LESS_THAN_EQUALS(before.numReuses + 1, after.numReuses);
+#endif
+    }
+
+    void testSoAGrid()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef HugePageAllocator<
+            char,
+            HugePageArena::PAGE_2MB,
+            SoAGridHelpers::FirstTouchLayout<TestCellSoA> > Allocator;
+        typedef SoAGrid<TestCellSoA, Topologies::Cube<3>::Topology, false, Allocator> GridType;
+        std::size_t allocations = Allocator::arena().statistics().numAllocations;
+
+        Coord<3> dim(64, 64, 16);
+        CoordBox<3> box(Coord<3>(), dim);
+        TestCellSoA innerCell(Coord<3>(1, 2, 3), dim, 5, 6.5);
+        GridType grid(box, innerCell);
+        TS_ASSERT_EQUALS(allocations + 1, Allocator::arena().statistics().numAllocations);
+
+        TestCellSoA cell(Coord<3>(4, 5, 6), dim, 7, 8.5);
+        grid.set(Coord<3>(63, 63, 15), cell);
+        TS_ASSERT_EQUALS(cell, grid.get(Coord<3>(63, 63, 15)));
+        TS_ASSERT_EQUALS(innerCell, grid.get(Coord<3>(0, 0, 0)));
+#endif
+    }
+};
+
+}
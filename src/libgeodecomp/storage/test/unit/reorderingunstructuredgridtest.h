@@ -843,6 +843,52 @@ public:
 #endif
     }
 
+    void testSetWeightsFromCSRAdjacency()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef UnstructuredTestCell<> TestCell;
+        typedef APITraits::SelectSoA<TestCell>::Value SoAFlag;
+        typedef GridTypeSelector<TestCell, Topology, false, SoAFlag>::Value GridType;
+        typedef GridType::SparseMatrix SparseMatrix;
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>( 11),  44)
+               << Streak<1>(Coord<1>(100), 140)
+               << Streak<1>(Coord<1>(355), 450);
+
+        SparseMatrix matrix;
+        std::vector<CSRAdjacency::Edge> edges;
+        for (int id = 0; id < 500; ++id) {
+            int numNeighbors = id % 7 + 1;
+            for (int j = 0; j < numNeighbors; ++j) {
+                int neighborID = (id + 1 + 3 * j) % 500;
+                matrix << std::make_pair(Coord<2>(id, neighborID), neighborID + 0.1);
+                edges << std::make_pair(id, neighborID);
+            }
+        }
+
+        CSRAdjacency adjacency(500, edges);
+        std::vector<double> values;
+        for (std::size_t i = 0; i < adjacency.getColumns().size(); ++i) {
+            values << adjacency.getColumns()[i] + 0.1;
+        }
+
+        GridType expectedGrid(region);
+        GridType actualGrid(region);
+        expectedGrid.setWeights(0, matrix);
+        actualGrid.setWeights(0, adjacency, values);
+
+        TS_ASSERT_EQUALS(expectedGrid.logicalToPhysicalIDs, actualGrid.logicalToPhysicalIDs);
+        for (int i = 0; i < int(region.size()); ++i) {
+            TS_ASSERT_EQUALS(
+                expectedGrid.delegate.matrices[0].getRow(i),
+                actualGrid.delegate.matrices[0].getRow(i));
+        }
+
+        TS_ASSERT_THROWS(actualGrid.setWeights(0, adjacency, std::vector<double>(3)), std::invalid_argument&);
+#endif
+    }
+
     void testLoadSaveRegionWithBoostSerialization()
     {
 #ifdef LIBGEODECOMP_WITH_CPP14
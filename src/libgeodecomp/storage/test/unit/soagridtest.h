@@ -6,6 +6,8 @@
 #include <libgeodecomp/storage/soagrid.h>
 #include <libgeodecomp/parallelization/serialsimulator.h>
 
+#include <cstring>
+
 using namespace LibGeoDecomp;
 
 // fixme: split this into multiple test files (one per SOA model) to speed up compilation
@@ -515,6 +517,65 @@ public:
         }
     }
 
+    void testLoadSaveLargeRegion()
+    {
+        // large enough to trigger streaming stores for the double member:
+        CoordBox<2> box(Coord<2>(), Coord<2>(1024, 640));
+        SoAGrid<MyDummyCell, Topology3> grid(box);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            grid.set(*i, MyDummyCell(i->x(), i->y() + 0.5, i->x() % 100));
+        }
+
+        Region<2> evenRegion;
+        evenRegion << box;
+        // an odd region size leaves the double member's array misaligned:
+        Region<2> oddRegion = evenRegion;
+        oddRegion >> box.origin;
+
+        std::vector<Region<2> > regions;
+        regions << evenRegion
+                << oddRegion;
+
+        for (std::size_t r = 0; r < regions.size(); ++r) {
+            const Region<2>& region = regions[r];
+            std::size_t count = region.size();
+            std::vector<char> buffer(SoAGrid<MyDummyCell, Topology3>::AGGREGATED_MEMBER_SIZE * count);
+            grid.saveRegion(&buffer, region);
+
+            // members are stored one after another:
+            std::size_t index = 0;
+            for (Region<2>::Iterator i = region.begin(); i != region.end(); ++i) {
+                int x;
+                double y;
+                char z;
+                std::memcpy(&x, &buffer[ 0 * count + index * sizeof(int)],    sizeof(int));
+                std::memcpy(&y, &buffer[ 4 * count + index * sizeof(double)], sizeof(double));
+                std::memcpy(&z, &buffer[12 * count + index * sizeof(char)],   sizeof(char));
+
+                TS_ASSERT_EQUALS(i->x(),       x);
+                TS_ASSERT_EQUALS(i->y() + 0.5, y);
+                TS_ASSERT_EQUALS(i->x() % 100, z);
+                ++index;
+            }
+
+            SoAGrid<MyDummyCell, Topology3> other(box, MyDummyCell(-1, -1, -1));
+            other.loadRegion(buffer, region);
+
+            for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+                MyDummyCell expected(-1, -1, -1);
+                if (region.count(*i)) {
+                    expected = MyDummyCell(i->x(), i->y() + 0.5, i->x() % 100);
+                }
+
+                MyDummyCell actual = other.get(*i);
+                TS_ASSERT_EQUALS(expected.x, actual.x);
+                TS_ASSERT_EQUALS(expected.y, actual.y);
+                TS_ASSERT_EQUALS(expected.z, actual.z);
+            }
+        }
+    }
+
     void testSoAWithOffset()
     {
         Coord<3> origin(5, 7, 3);
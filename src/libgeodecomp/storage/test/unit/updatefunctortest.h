@@ -256,7 +256,76 @@ public:
         }
     }
 
+    void testTiledSchedulingVanilla()
+    {
+        typedef TestCell<3> TestCellType;
+        typedef Grid<TestCellType, APITraits::SelectTopology<TestCellType>::Value> GridType;
+        GridType grid(Coord<3>(150, 20, 12));
+        checkParallelUpdate<UpdateFunctorHelpers::ConcurrencyEnableOpenMPTiling, TestCellType>(&grid);
+    }
+
+    void testTiledSchedulingStructOfArrays()
+    {
+        typedef TestCellSoA TestCellType;
+        typedef SoAGrid<TestCellType, Topologies::Cube<3>::Topology> GridType;
+        GridType grid(CoordBox<3>(Coord<3>(), Coord<3>(150, 20, 12)));
+        checkParallelUpdate<UpdateFunctorHelpers::ConcurrencyEnableOpenMPTiling, TestCellType>(&grid);
+    }
+
+    void testThreadPoolVanilla()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef TestCell<3> TestCellType;
+        typedef Grid<TestCellType, APITraits::SelectTopology<TestCellType>::Value> GridType;
+        GridType grid(Coord<3>(150, 20, 12));
+        checkParallelUpdate<UpdateFunctorHelpers::ConcurrencyEnableThreadPool, TestCellType>(&grid);
+        checkParallelUpdate<UpdateFunctorHelpers::ConcurrencyEnableThreadPool, TestCellType>(&grid, true);
+#endif
+    }
+
+    void testThreadPoolStructOfArrays()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef TestCellSoA TestCellType;
+        typedef SoAGrid<TestCellType, Topologies::Cube<3>::Topology> GridType;
+        GridType grid(CoordBox<3>(Coord<3>(), Coord<3>(150, 20, 12)));
+        checkParallelUpdate<UpdateFunctorHelpers::ConcurrencyEnableThreadPool, TestCellType>(&grid);
+        checkParallelUpdate<UpdateFunctorHelpers::ConcurrencyEnableThreadPool, TestCellType>(&grid, true);
+#endif
+    }
+
 private:
+    template<typename CONCURRENCY_SPEC, typename CELL, typename GRID>
+    void checkParallelUpdate(GRID *gridA, bool fineGrained = false)
+    {
+        CoordBox<3> box = gridA->boundingBox();
+        Coord<3> dim = box.dimensions;
+
+        TestInitializer<CELL> init(dim);
+        init.grid(gridA);
+        GRID gridB = *gridA;
+
+        // a sphere-ish Region, so tiles are only partially filled:
+        Region<3> region;
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            Coord<3> delta = *i - dim / 2;
+            if ((delta.x() * delta.x() / 16 + delta.y() * delta.y() + delta.z() * delta.z()) < 100) {
+                region << *i;
+            }
+        }
+
+        UpdateFunctor<CELL, CONCURRENCY_SPEC>()(
+            region, Coord<3>(), Coord<3>(), *gridA, &gridB, 0, CONCURRENCY_SPEC(false, fineGrained));
+        unsigned cycle = init.startStep() * CELL::NANO_STEPS + 1;
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            CELL cell = gridB.get(*i);
+            TS_ASSERT(cell.valid());
+            // cells outside of the Region must not have been touched:
+            TS_ASSERT_EQUALS(region.count(*i) ? cycle : cycle - 1, cell.cycleCounter);
+        }
+    }
+
     template<typename CELL>
     void checkSelector(const std::string& line, int repeats)
     {
@@ -303,6 +303,11 @@ public:
         return false;
     }
 
+    bool enableThreadPool() const
+    {
+        return false;
+    }
+
     bool preferStaticScheduling() const
     {
         return false;
@@ -312,6 +317,11 @@ public:
     {
         return false;
     }
+
+    bool preferTiledScheduling() const
+    {
+        return false;
+    }
 };
 
 /**
@@ -338,6 +348,11 @@ public:
         return false;
     }
 
+    bool enableThreadPool() const
+    {
+        return false;
+    }
+
     bool preferStaticScheduling() const
     {
         return !updatingGhost;
@@ -348,11 +363,38 @@ public:
         return enableFineGrainedParallelism;
     }
 
+    bool preferTiledScheduling() const
+    {
+        return false;
+    }
+
 private:
     bool updatingGhost;
     bool enableFineGrainedParallelism;
 };
 
+/**
+ * Variant of ConcurrencyEnableOpenMP which replaces the plane-wise
+ * distribution of work by cache-sized tiles, ordered along a
+ * space-filling curve and handed out dynamically (see RegionTiling).
+ * This improves the reuse of neighboring lines for 3D stencils and
+ * balances better if the number of planes is close to the number of
+ * threads.
+ */
+class ConcurrencyEnableOpenMPTiling : public ConcurrencyEnableOpenMP
+{
+public:
+    inline
+    ConcurrencyEnableOpenMPTiling(bool updatingGhost, bool enableFineGrainedParallelism) :
+        ConcurrencyEnableOpenMP(updatingGhost, enableFineGrainedParallelism)
+    {}
+
+    bool preferTiledScheduling() const
+    {
+        return true;
+    }
+};
+
 /**
  * Like its counterpart for OpenMP, this class requests an HPX-based parallel update.
  */
@@ -374,6 +416,61 @@ public:
         return true;
     }
 
+    bool enableThreadPool() const
+    {
+        return false;
+    }
+
+    bool preferStaticScheduling() const
+    {
+        return false;
+    }
+
+    bool preferFineGrainedParallelism() const
+    {
+        return enableFineGrainedParallelism;
+    }
+
+    bool preferTiledScheduling() const
+    {
+        return false;
+    }
+
+private:
+    bool enableFineGrainedParallelism;
+};
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+/**
+ * Runs the update on the persistent ThreadPool::instance() instead
+ * of opening an OpenMP parallel region per call. Decompositions of
+ * the Region into tasks are cached per Region (see
+ * StreakScheduleCache), so repeated updates of the same Region
+ * neither allocate nor rebuild any tranche lists.
+ */
+class ConcurrencyEnableThreadPool
+{
+public:
+    inline
+    ConcurrencyEnableThreadPool(bool /* unused: updatingGhost */, bool enableFineGrainedParallelism) :
+        enableFineGrainedParallelism(enableFineGrainedParallelism)
+    {}
+
+    bool enableOpenMP() const
+    {
+        return false;
+    }
+
+    bool enableHPX() const
+    {
+        return false;
+    }
+
+    bool enableThreadPool() const
+    {
+        return true;
+    }
+
     bool preferStaticScheduling() const
     {
         return false;
@@ -384,9 +481,15 @@ public:
         return enableFineGrainedParallelism;
     }
 
+    bool preferTiledScheduling() const
+    {
+        return false;
+    }
+
 private:
     bool enableFineGrainedParallelism;
 };
+#endif
 
 }
 
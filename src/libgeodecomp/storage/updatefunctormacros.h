@@ -1,6 +1,9 @@
 #ifndef LIBGEODECOMP_STORAGE_UPDATEFUNCTORMACROS_H
 #define LIBGEODECOMP_STORAGE_UPDATEFUNCTORMACROS_H
 
+#include <libgeodecomp/geometry/regiontiling.h>
+#include <libgeodecomp/geometry/streakschedule.h>
+#include <libgeodecomp/misc/threadpool.h>
 #include <libgeodecomp/storage/updatefunctormacrosmsvc.h>
 
 #ifndef _MSC_BUILD
@@ -9,7 +12,20 @@
 #define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_1                         \
     if (concurrencySpec.enableOpenMP() &&                               \
         !modelThreadingSpec.hasOpenMP()) {                              \
-        if (concurrencySpec.preferStaticScheduling()) {                 \
+        if (concurrencySpec.preferTiledScheduling()) {                  \
+            RegionTiling<DIM> tiling(                                   \
+                region,                                                 \
+                RegionTiling<DIM>::defaultTileDimensions(               \
+                    sizeof(CELL)));                                     \
+            typedef typename RegionTiling<DIM>::StreakIterator Iter;    \
+            _Pragma("omp parallel for schedule(dynamic)")               \
+            for (std::size_t t = 0; t < tiling.numTiles(); ++t) {       \
+                Iter e = tiling.endTile(t);                             \
+                for (Iter i = tiling.beginTile(t); i != e; ++i) {       \
+                    LGD_UPDATE_FUNCTOR_BODY;                            \
+                }                                                       \
+            }                                                           \
+        } else if (concurrencySpec.preferStaticScheduling()) {          \
             _Pragma("omp parallel for schedule(static)")                \
             for (std::size_t c = 0; c < region.numPlanes(); ++c) {      \
                 typename Region<DIM>::StreakIterator e =                \
@@ -82,8 +98,35 @@
 
 #endif
 
+#ifdef LIBGEODECOMP_WITH_CPP14
+#define LGD_UPDATE_FUNCTOR_THREAD_POOL_SELECTOR                         \
+    if (concurrencySpec.enableThreadPool() &&                           \
+        !modelThreadingSpec.hasOpenMP()) {                              \
+        const StreakSchedule<DIM>& schedule =                           \
+            StreakScheduleCache<DIM>::instance()(                       \
+                region,                                                 \
+                concurrencySpec.preferFineGrainedParallelism() ?        \
+                modelThreadingSpec.granularity() : 0);                  \
+        ThreadPool::instance().run(                                     \
+            schedule.numTasks(),                                        \
+            [&](std::size_t task) {                                     \
+                typedef typename StreakSchedule<DIM>::StreakIterator    \
+                    Iter;                                               \
+                Iter e = schedule.endTask(task);                        \
+                for (Iter i = schedule.beginTask(task); i != e; ++i) {  \
+                    LGD_UPDATE_FUNCTOR_BODY;                            \
+                }                                                       \
+            });                                                         \
+        return;                                                         \
+    }                                                                   \
+    /**/
+#else
+#define LGD_UPDATE_FUNCTOR_THREAD_POOL_SELECTOR
+#endif
+
 #ifdef LIBGEODECOMP_WITH_HPX
 #define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_7                         \
+    LGD_UPDATE_FUNCTOR_THREAD_POOL_SELECTOR                             \
     if (concurrencySpec.enableHPX() && !modelThreadingSpec.hasHPX()) {  \
         if (!concurrencySpec.preferFineGrainedParallelism()) {          \
             std::vector<hpx::future<void> > updateFutures;              \
@@ -141,7 +184,8 @@
     }                                                                   \
     /**/
 #else
-#define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_7
+#define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_7                         \
+    LGD_UPDATE_FUNCTOR_THREAD_POOL_SELECTOR                             \
     /**/
 #endif
 
@@ -11,7 +11,20 @@
 #define LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_1                         \
     if (concurrencySpec.enableOpenMP() &&                               \
         !modelThreadingSpec.hasOpenMP()) {                              \
-        if (concurrencySpec.preferStaticScheduling()) {                 \
+        if (concurrencySpec.preferTiledScheduling()) {                  \
+            RegionTiling<DIM> tiling(                                   \
+                region,                                                 \
+                RegionTiling<DIM>::defaultTileDimensions(               \
+                    sizeof(CELL)));                                     \
+            typedef typename RegionTiling<DIM>::StreakIterator Iter;    \
+            __pragma(omp parallel for schedule(dynamic))                \
+            for (int t = 0; t < int(tiling.numTiles()); ++t) {          \
+                Iter e = tiling.endTile(t);                             \
+                for (Iter i = tiling.beginTile(t); i != e; ++i) {       \
+                    LGD_UPDATE_FUNCTOR_BODY;                            \
+                }                                                       \
+            }                                                           \
+        } else if (concurrencySpec.preferStaticScheduling()) {          \
             __pragma(omp parallel for schedule(static))                 \
             for (int c = 0; c < int(region.numPlanes()); ++c) {         \
                 typename Region<DIM>::StreakIterator e =                \
@@ -2,8 +2,10 @@
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/io/simpleinitializer.h>
 #include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/geometry/compressedregion.h>
 #include <libgeodecomp/geometry/convexpolytope.h>
 #include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/geometry/csradjacency.h>
 #include <libgeodecomp/geometry/floatcoord.h>
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/stencils.h>
@@ -273,6 +275,104 @@ public:
     }
 };
 
+/**
+ * Multi-threaded counterparts of RegionIntersect, RegionSubtract, and
+ * RegionUnion. Only the set operation itself is being timed as
+ * constructing the operands is inherently sequential.
+ */
+class ParallelRegionBenchmark : public CPUBenchmark
+{
+public:
+    std::string species()
+    {
+        return "gold";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        Region<3> r1;
+        Region<3> r2;
+
+        for (int z = 0; z < dim.z(); ++z) {
+            for (int y = 0; y < dim.y(); ++y) {
+                r1 << Streak<3>(Coord<3>(0, y, z), dim.x());
+            }
+        }
+
+        for (int z = 1; z < (dim.z() - 1); ++z) {
+            for (int y = 1; y < (dim.y() - 1); ++y) {
+                r2 << Streak<3>(Coord<3>(1, y, z), dim.x() - 1);
+            }
+        }
+
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+            Region<3> r3 = apply(r1, r2);
+
+            if (r3.size() == 31) {
+                std::cout << "pure debug statement to prevent the compiler from optimizing away the previous line";
+            }
+        }
+
+        return seconds;
+    }
+
+    std::string unit()
+    {
+        return "s";
+    }
+
+protected:
+    virtual Region<3> apply(const Region<3>& r1, const Region<3>& r2) = 0;
+};
+
+class ParallelRegionIntersect : public ParallelRegionBenchmark
+{
+public:
+    std::string family()
+    {
+        return "RegionIntersectMT";
+    }
+
+protected:
+    Region<3> apply(const Region<3>& r1, const Region<3>& r2)
+    {
+        return r1.parallelIntersection(r2);
+    }
+};
+
+class ParallelRegionSubtract : public ParallelRegionBenchmark
+{
+public:
+    std::string family()
+    {
+        return "RegionSubtractMT";
+    }
+
+protected:
+    Region<3> apply(const Region<3>& r1, const Region<3>& r2)
+    {
+        return r1.parallelDifference(r2);
+    }
+};
+
+class ParallelRegionUnion : public ParallelRegionBenchmark
+{
+public:
+    std::string family()
+    {
+        return "RegionUnionMT";
+    }
+
+protected:
+    Region<3> apply(const Region<3>& r1, const Region<3>& r2)
+    {
+        return r1.parallelUnion(r2);
+    }
+};
+
 class RegionAppend : public CPUBenchmark
 {
 public:
@@ -379,6 +479,177 @@ private:
     int expansionWidth;
 };
 
+/**
+ * Compressed counterparts of the Region benchmarks above. Regions
+ * are constructed streak by streak (not from a CoordBox) to measure
+ * the generic append path.
+ */
+class CompressedRegionBenchmark : public CPUBenchmark
+{
+public:
+    std::string species()
+    {
+        return "platinum";
+    }
+
+    std::string unit()
+    {
+        return "s";
+    }
+
+protected:
+    CompressedRegion<3> genRegion(const Coord<3>& origin, const Coord<3>& dim)
+    {
+        CompressedRegion<3> ret;
+        for (int z = origin.z(); z < dim.z(); ++z) {
+            for (int y = origin.y(); y < dim.y(); ++y) {
+                ret << Streak<3>(Coord<3>(origin.x(), y, z), dim.x());
+            }
+        }
+
+        return ret;
+    }
+};
+
+class CompressedRegionCount : public CompressedRegionBenchmark
+{
+public:
+    std::string family()
+    {
+        return "RegionCount";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        int sum = 0;
+        CompressedRegion<3> r = genRegion(Coord<3>(), dim);
+
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            for (int z = 0; z < dim.z(); z += 4) {
+                for (int y = 0; y < dim.y(); y += 4) {
+                    for (int x = 0; x < dim.x(); x += 4) {
+                        sum += r.count(Coord<3>(x, y, z));
+                    }
+                }
+            }
+        }
+
+        if (sum == 31) {
+            std::cout << "pure debug statement to prevent the compiler from optimizing away the previous loop";
+        }
+
+        return seconds;
+    }
+};
+
+class CompressedRegionIntersect : public CompressedRegionBenchmark
+{
+public:
+    std::string family()
+    {
+        return "RegionIntersect";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            CompressedRegion<3> r1 = genRegion(Coord<3>(), dim);
+            CompressedRegion<3> r2 = genRegion(Coord<3>(1, 1, 1), dim - Coord<3>(1, 1, 1));
+            CompressedRegion<3> r3 = r1 & r2;
+        }
+
+        return seconds;
+    }
+};
+
+class CompressedRegionSubtract : public CompressedRegionBenchmark
+{
+public:
+    std::string family()
+    {
+        return "RegionSubtract";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            CompressedRegion<3> r1 = genRegion(Coord<3>(), dim);
+            CompressedRegion<3> r2 = genRegion(Coord<3>(1, 1, 1), dim - Coord<3>(1, 1, 1));
+            CompressedRegion<3> r3 = r1 - r2;
+        }
+
+        return seconds;
+    }
+};
+
+class CompressedRegionUnion : public CompressedRegionBenchmark
+{
+public:
+    std::string family()
+    {
+        return "RegionUnion";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            CompressedRegion<3> r1 = genRegion(Coord<3>(), dim);
+            CompressedRegion<3> r2 = genRegion(Coord<3>(1, 1, 1), dim - Coord<3>(1, 1, 1));
+            CompressedRegion<3> r3 = r1 + r2;
+        }
+
+        return seconds;
+    }
+};
+
+class CompressedRegionExpand : public CompressedRegionBenchmark
+{
+public:
+    explicit CompressedRegionExpand(int expansionWidth) :
+        expansionWidth(expansionWidth)
+    {}
+
+    std::string family()
+    {
+        std::stringstream buf;
+        buf << "RegionExpand" << expansionWidth;
+        return buf.str();
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+
+            CompressedRegion<3> r1 = genRegion(Coord<3>(), dim);
+            CompressedRegion<3> r2 = r1.expand(expansionWidth);
+        }
+
+        return seconds;
+    }
+
+private:
+    int expansionWidth;
+};
+
 class RegionExpandWithAdjacency : public CPUBenchmark
 {
 public:
@@ -618,6 +889,107 @@ private:
 };
 
 
+/**
+ * Builds the adjacency of a mesh with dim[0] nodes and 8 neighbors
+ * per node from a scrambled edge list via repeated inserts.
+ */
+class AdjacencyConstructionVanilla : public CPUBenchmark
+{
+public:
+    std::string family()
+    {
+        return "AdjacencyConstruction";
+    }
+
+    std::string species()
+    {
+        return "vanilla";
+    }
+
+    double performance(std::vector<int> dim)
+    {
+        double seconds = 0;
+        std::vector<CSRAdjacency::Edge> edges = genEdges(dim[0]);
+
+        {
+            ScopedTimer t(&seconds);
+
+            RegionBasedAdjacency adjacency;
+            for (std::vector<CSRAdjacency::Edge>::iterator i = edges.begin(); i != edges.end(); ++i) {
+                adjacency.insert(i->first, i->second);
+            }
+
+            if (adjacency.size() == 4711) {
+                std::cout << "pure debug statement to prevent the compiler from optimizing away the previous function";
+            }
+        }
+
+        return seconds;
+    }
+
+    std::string unit()
+    {
+        return "s";
+    }
+
+    static std::vector<CSRAdjacency::Edge> genEdges(int numNodes)
+    {
+        std::vector<CSRAdjacency::Edge> edges;
+        edges.reserve(std::size_t(numNodes) * 8);
+
+        for (int i = 0; i < numNodes; ++i) {
+            int from = int((long(i) * 7919) % numNodes);
+            for (int j = 1; j <= 8; ++j) {
+                edges << std::make_pair(from, int((long(from) + j * 97) % numNodes));
+            }
+        }
+
+        return edges;
+    }
+};
+
+/**
+ * Same as AdjacencyConstructionVanilla, but uses the multi-threaded
+ * bulk constructor of the CSRAdjacency.
+ */
+class AdjacencyConstructionGold : public CPUBenchmark
+{
+public:
+    std::string family()
+    {
+        return "AdjacencyConstruction";
+    }
+
+    std::string species()
+    {
+        return "gold";
+    }
+
+    double performance(std::vector<int> dim)
+    {
+        double seconds = 0;
+        std::vector<CSRAdjacency::Edge> edges = AdjacencyConstructionVanilla::genEdges(dim[0]);
+
+        {
+            ScopedTimer t(&seconds);
+
+            CSRAdjacency adjacency(std::size_t(dim[0]), edges);
+
+            if (adjacency.size() == 4711) {
+                std::cout << "pure debug statement to prevent the compiler from optimizing away the previous function";
+            }
+        }
+
+        return seconds;
+    }
+
+    std::string unit()
+    {
+        return "s";
+    }
+};
+
+
 class CoordEnumerationVanilla : public CPUBenchmark
 {
 public:
@@ -2982,6 +3354,10 @@ int main(int argc, char **argv)
     eval(RegionCount(), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionCount(), toVector(Coord<3>(2048, 2048, 2048)));
 
+    eval(CompressedRegionCount(), toVector(Coord<3>( 128,  128,  128)));
+    eval(CompressedRegionCount(), toVector(Coord<3>( 512,  512,  512)));
+    eval(CompressedRegionCount(), toVector(Coord<3>(2048, 2048, 2048)));
+
     eval(RegionInsert(), toVector(Coord<3>( 128,  128,  128)));
     eval(RegionInsert(), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionInsert(), toVector(Coord<3>(2048, 2048, 2048)));
@@ -2990,14 +3366,38 @@ int main(int argc, char **argv)
     eval(RegionIntersect(), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionIntersect(), toVector(Coord<3>(2048, 2048, 2048)));
 
+    eval(CompressedRegionIntersect(), toVector(Coord<3>( 128,  128,  128)));
+    eval(CompressedRegionIntersect(), toVector(Coord<3>( 512,  512,  512)));
+    eval(CompressedRegionIntersect(), toVector(Coord<3>(2048, 2048, 2048)));
+
+    eval(ParallelRegionIntersect(), toVector(Coord<3>( 128,  128,  128)));
+    eval(ParallelRegionIntersect(), toVector(Coord<3>( 512,  512,  512)));
+    eval(ParallelRegionIntersect(), toVector(Coord<3>(2048, 2048, 2048)));
+
     eval(RegionSubtract(), toVector(Coord<3>( 128,  128,  128)));
     eval(RegionSubtract(), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionSubtract(), toVector(Coord<3>(2048, 2048, 2048)));
 
+    eval(CompressedRegionSubtract(), toVector(Coord<3>( 128,  128,  128)));
+    eval(CompressedRegionSubtract(), toVector(Coord<3>( 512,  512,  512)));
+    eval(CompressedRegionSubtract(), toVector(Coord<3>(2048, 2048, 2048)));
+
+    eval(ParallelRegionSubtract(), toVector(Coord<3>( 128,  128,  128)));
+    eval(ParallelRegionSubtract(), toVector(Coord<3>( 512,  512,  512)));
+    eval(ParallelRegionSubtract(), toVector(Coord<3>(2048, 2048, 2048)));
+
     eval(RegionUnion(), toVector(Coord<3>( 128,  128,  128)));
     eval(RegionUnion(), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionUnion(), toVector(Coord<3>(2048, 2048, 2048)));
 
+    eval(CompressedRegionUnion(), toVector(Coord<3>( 128,  128,  128)));
+    eval(CompressedRegionUnion(), toVector(Coord<3>( 512,  512,  512)));
+    eval(CompressedRegionUnion(), toVector(Coord<3>(2048, 2048, 2048)));
+
+    eval(ParallelRegionUnion(), toVector(Coord<3>( 128,  128,  128)));
+    eval(ParallelRegionUnion(), toVector(Coord<3>( 512,  512,  512)));
+    eval(ParallelRegionUnion(), toVector(Coord<3>(2048, 2048, 2048)));
+
     eval(RegionAppend(), toVector(Coord<3>( 128,  128,  128)));
     eval(RegionAppend(), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionAppend(), toVector(Coord<3>(2048, 2048, 2048)));
@@ -3006,10 +3406,18 @@ int main(int argc, char **argv)
     eval(RegionExpand(1), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionExpand(1), toVector(Coord<3>(2048, 2048, 2048)));
 
+    eval(CompressedRegionExpand(1), toVector(Coord<3>( 128,  128,  128)));
+    eval(CompressedRegionExpand(1), toVector(Coord<3>( 512,  512,  512)));
+    eval(CompressedRegionExpand(1), toVector(Coord<3>(2048, 2048, 2048)));
+
     eval(RegionExpand(5), toVector(Coord<3>( 128,  128,  128)));
     eval(RegionExpand(5), toVector(Coord<3>( 512,  512,  512)));
     eval(RegionExpand(5), toVector(Coord<3>(2048, 2048, 2048)));
 
+    eval(CompressedRegionExpand(5), toVector(Coord<3>( 128,  128,  128)));
+    eval(CompressedRegionExpand(5), toVector(Coord<3>( 512,  512,  512)));
+    eval(CompressedRegionExpand(5), toVector(Coord<3>(2048, 2048, 2048)));
+
     {
         std::vector<int> params(4);
         int numCells = 2000000;
@@ -3037,6 +3445,9 @@ int main(int argc, char **argv)
         eval(RegionExpandWithAdjacency(cells), params);
     }
 
+    eval(AdjacencyConstructionVanilla(), toVector(Coord<1>(1000000)));
+    eval(AdjacencyConstructionGold(),    toVector(Coord<1>(1000000)));
+
     eval(CoordEnumerationVanilla(), toVector(Coord<3>( 128,  128,  128)));
     eval(CoordEnumerationVanilla(), toVector(Coord<3>( 512,  512,  512)));
     eval(CoordEnumerationVanilla(), toVector(Coord<3>(2048, 2048, 2048)));